@@ -0,0 +1,438 @@
+/*--------------------------------------------------------------------*/
+/* benchsymhash.c                                                     */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include "symhash.h"
+#include <stdio.h>
+#include <time.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A hash function under comparison, with a name to report it by. */
+struct HashCandidate
+{
+   const char *pcName;
+   SymTable_HashFunction pfHash;
+};
+
+/* A way of generating the iIndex-th key of a key set into acKey. */
+struct KeySet
+{
+   const char *pcName;
+   void (*pfMakeKey)(char *acKey, int iIndex);
+};
+
+enum {MAX_KEY_LENGTH = 64};
+
+/*--------------------------------------------------------------------*/
+
+/* The hash from the assignment specification exactly as it was used
+   before SymHash existed: no finalizing mix, so its low-order bits
+   depend mostly on the last characters of the key. */
+
+static size_t rawHash(const char *pcKey, size_t uLength)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   for (u = 0; u < uLength; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+   return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+static const struct HashCandidate asCandidates[] =
+{
+   {"raw 65599", rawHash},
+   {"classic", SymHash_classic},
+   {"wide", SymHash_wide},
+   {"crc", SymHash_crc}
+};
+
+enum {CANDIDATE_COUNT =
+   sizeof(asCandidates) / sizeof(asCandidates[0])};
+
+/*--------------------------------------------------------------------*/
+
+/* Write the decimal representation of iIndex into acKey, as
+   testsymtable.c does. */
+
+static void makeDecimalKey(char *acKey, int iIndex)
+{
+   sprintf(acKey, "%d", iIndex);
+}
+
+/* Write a dotted, hierarchical name that shares a long prefix with
+   its neighbours into acKey. */
+
+static void makeDottedKey(char *acKey, int iIndex)
+{
+   sprintf(acKey, "org.example.compiler.scope%d.symbol%d",
+      iIndex / 64, iIndex % 64);
+}
+
+/* Write a fixed-width key that differs from its neighbours only in its
+   first characters into acKey. */
+
+static void makeSuffixedKey(char *acKey, int iIndex)
+{
+   sprintf(acKey, "%08d_common_suffix_of_the_key", iIndex);
+}
+
+static const struct KeySet asKeySets[] =
+{
+   {"decimal", makeDecimalKey},
+   {"dotted", makeDottedKey},
+   {"suffixed", makeSuffixedKey}
+};
+
+enum {KEY_SET_COUNT = sizeof(asKeySets) / sizeof(asKeySets[0])};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of CPU seconds between iStart and iEnd. */
+
+static double seconds(clock_t iStart, clock_t iEnd)
+{
+   return ((double)(iEnd - iStart)) / CLOCKS_PER_SEC;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the throughput, in megabytes per second, of every candidate
+   hashing keys of uLength bytes. */
+
+static void benchThroughput(size_t uLength)
+{
+   enum {TOTAL_BYTES = 256 * 1024 * 1024};
+
+   char *pcKey;
+   size_t u, uRounds;
+   size_t uSink = 0;
+   int i;
+   clock_t iStart;
+   double dSeconds;
+
+   pcKey = (char*)malloc(uLength + 1);
+   assert(pcKey != NULL);
+   for (u = 0; u < uLength; u++)
+      pcKey[u] = (char)('a' + u % 26);
+   pcKey[uLength] = '\0';
+
+   uRounds = TOTAL_BYTES / uLength;
+
+   printf("%6lu-byte keys:", (unsigned long)uLength);
+   for (i = 0; i < CANDIDATE_COUNT; i++)
+   {
+      iStart = clock();
+      for (u = 0; u < uRounds; u++)
+      {
+         /* Feed each result back into the key so that calls cannot be
+            overlapped or hoisted out of the loop. */
+         uSink += (*asCandidates[i].pfHash)(pcKey, uLength);
+         pcKey[0] = (char)('a' + (uSink & 15));
+      }
+      dSeconds = seconds(iStart, clock());
+      printf("  %s %8.1f MB/s", asCandidates[i].pcName,
+         dSeconds > 0 ? (double)TOTAL_BYTES / dSeconds / 1.0e6 : 0.0);
+   }
+   printf("\n");
+   fflush(stdout);
+
+   free(pcKey);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the chain-length distribution that every candidate produces
+   for iKeyCount keys of key set psKeySet spread over the smallest
+   power-of-two number of buckets that is at least iKeyCount, as
+   symtablehash.c would at its default maximum load. */
+
+static void benchChains(const struct KeySet *psKeySet, int iKeyCount)
+{
+   char acKey[MAX_KEY_LENGTH];
+   size_t *puChainLengths;
+   size_t uBuckets = 1;
+   size_t uEmpty, uLongest, uProbes;
+   size_t u;
+   int i, iKey;
+
+   while (uBuckets < (size_t)iKeyCount)
+      uBuckets *= 2;
+
+   puChainLengths = (size_t*)malloc(uBuckets * sizeof(size_t));
+   assert(puChainLengths != NULL);
+
+   printf("%s keys, %d keys in %lu buckets:\n", psKeySet->pcName,
+      iKeyCount, (unsigned long)uBuckets);
+   for (i = 0; i < CANDIDATE_COUNT; i++)
+   {
+      for (u = 0; u < uBuckets; u++)
+         puChainLengths[u] = 0;
+      for (iKey = 0; iKey < iKeyCount; iKey++)
+      {
+         (*psKeySet->pfMakeKey)(acKey, iKey);
+         puChainLengths[(*asCandidates[i].pfHash)(acKey,
+            strlen(acKey)) & (uBuckets - 1)]++;
+      }
+
+      /* A successful lookup of the k-th binding of a chain compares
+         k keys. */
+      uEmpty = 0;
+      uLongest = 0;
+      uProbes = 0;
+      for (u = 0; u < uBuckets; u++)
+      {
+         if (puChainLengths[u] == 0)
+            uEmpty++;
+         if (puChainLengths[u] > uLongest)
+            uLongest = puChainLengths[u];
+         uProbes += puChainLengths[u] * (puChainLengths[u] + 1) / 2;
+      }
+
+      printf("  %-10s empty %5.1f%%  longest %6lu  "
+         "compares/lookup %8.2f\n", asCandidates[i].pcName,
+         100.0 * (double)uEmpty / (double)uBuckets,
+         (unsigned long)uLongest,
+         iKeyCount > 0 ? (double)uProbes / iKeyCount : 0.0);
+   }
+   fflush(stdout);
+
+   free(puChainLengths);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the CPU time that a SymTable using each candidate takes to
+   put, then get, iKeyCount keys of key set psKeySet. */
+
+static void benchTable(const struct KeySet *psKeySet, int iKeyCount)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iStart;
+   int i, iKey;
+   int iSuccessful;
+   size_t uFound;
+
+   printf("%s keys, put + get of %d bindings:\n", psKeySet->pcName,
+      iKeyCount);
+   for (i = 0; i < CANDIDATE_COUNT; i++)
+   {
+      iStart = clock();
+      oSymTable = SymTable_newWithHash(asCandidates[i].pfHash);
+      assert(oSymTable != NULL);
+      for (iKey = 0; iKey < iKeyCount; iKey++)
+      {
+         (*psKeySet->pfMakeKey)(acKey, iKey);
+         iSuccessful = SymTable_put(oSymTable, acKey, acKey);
+         assert(iSuccessful);
+      }
+      uFound = 0;
+      for (iKey = 0; iKey < iKeyCount; iKey++)
+      {
+         (*psKeySet->pfMakeKey)(acKey, iKey);
+         uFound += (size_t)SymTable_contains(oSymTable, acKey);
+      }
+      assert(uFound == (size_t)iKeyCount);
+      SymTable_free(oSymTable);
+      printf("  %-10s %f seconds\n", asCandidates[i].pcName,
+         seconds(iStart, clock()));
+   }
+   fflush(stdout);
+
+   (void)iSuccessful;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the CPU time that a SymTable takes to look up iKeyCount keys
+   of key set psKeySet in random order, one SymTable_get at a time and
+   then with SymTable_getBatch. The gap widens once the table no
+   longer fits in the cache. */
+
+static void benchBatch(const struct KeySet *psKeySet, int iKeyCount)
+{
+   SymTable_T oSymTable;
+   char *pcKeys;
+   const char **apcKeys;
+   const char *pcTemp;
+   void **ppvValues;
+   unsigned long uState = 88172645463325252UL;
+   clock_t iStart;
+   double dSingle, dBatch;
+   size_t uFound;
+   int iKey, iOther;
+   int iSuccessful;
+
+   pcKeys = (char*)malloc((size_t)iKeyCount * MAX_KEY_LENGTH);
+   apcKeys = (const char**)malloc((size_t)iKeyCount * sizeof(char*));
+   ppvValues = (void**)malloc((size_t)iKeyCount * sizeof(void*));
+   oSymTable = SymTable_new();
+   assert((pcKeys != NULL) && (apcKeys != NULL) &&
+      (ppvValues != NULL) && (oSymTable != NULL));
+
+   for (iKey = 0; iKey < iKeyCount; iKey++)
+   {
+      apcKeys[iKey] = pcKeys + (size_t)iKey * MAX_KEY_LENGTH;
+      (*psKeySet->pfMakeKey)(pcKeys + (size_t)iKey * MAX_KEY_LENGTH,
+         iKey);
+      iSuccessful = SymTable_put(oSymTable, apcKeys[iKey],
+         apcKeys[iKey]);
+      assert(iSuccessful);
+   }
+
+   /* Shuffle the keys, with an xorshift generator, so that
+      consecutive lookups touch unrelated buckets. */
+   for (iKey = iKeyCount - 1; iKey > 0; iKey--)
+   {
+      uState ^= uState << 13;
+      uState ^= uState >> 7;
+      uState ^= uState << 17;
+      iOther = (int)(uState % (unsigned long)(iKey + 1));
+      pcTemp = apcKeys[iKey];
+      apcKeys[iKey] = apcKeys[iOther];
+      apcKeys[iOther] = pcTemp;
+   }
+
+   iStart = clock();
+   uFound = 0;
+   for (iKey = 0; iKey < iKeyCount; iKey++)
+      uFound += (size_t)(SymTable_get(oSymTable, apcKeys[iKey]) ==
+         apcKeys[iKey]);
+   dSingle = seconds(iStart, clock());
+   assert(uFound == (size_t)iKeyCount);
+
+   iStart = clock();
+   uFound = SymTable_getBatch(oSymTable, apcKeys, (size_t)iKeyCount,
+      ppvValues);
+   dBatch = seconds(iStart, clock());
+   assert(uFound == (size_t)iKeyCount);
+
+   printf("%s keys, %d random lookups:\n", psKeySet->pcName,
+      iKeyCount);
+   printf("  %-10s %f seconds\n", "get", dSingle);
+   printf("  %-10s %f seconds\n", "getBatch", dBatch);
+   fflush(stdout);
+
+   SymTable_free(oSymTable);
+   free(ppvValues);
+   free(apcKeys);
+   free(pcKeys);
+   (void)iSuccessful;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the CPU time taken to fill, search and free enough SymTable
+   objects of uTableLength bindings each to hold iKeyCount bindings in
+   all, with every table alive at once, as the scopes of a compiler
+   would be. */
+
+static void benchSmallTables(size_t uTableLength, int iKeyCount)
+{
+   SymTable_T *aoSymTables;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uTableCount;
+   size_t uTable, uKey;
+   size_t uFound = 0;
+   clock_t iStart;
+   int iSuccessful;
+
+   uTableCount = (size_t)iKeyCount / uTableLength;
+   if (uTableCount == 0)
+      uTableCount = 1;
+   aoSymTables = (SymTable_T*)malloc(uTableCount * sizeof(SymTable_T));
+   assert(aoSymTables != NULL);
+
+   iStart = clock();
+   for (uTable = 0; uTable < uTableCount; uTable++)
+   {
+      aoSymTables[uTable] = SymTable_new();
+      assert(aoSymTables[uTable] != NULL);
+      for (uKey = 0; uKey < uTableLength; uKey++)
+      {
+         makeDottedKey(acKey, (int)uKey);
+         iSuccessful = SymTable_put(aoSymTables[uTable], acKey, acKey);
+         assert(iSuccessful);
+      }
+   }
+   for (uTable = 0; uTable < uTableCount; uTable++)
+      for (uKey = 0; uKey < uTableLength; uKey++)
+      {
+         makeDottedKey(acKey, (int)uKey);
+         uFound += (size_t)SymTable_contains(aoSymTables[uTable],
+            acKey);
+      }
+   for (uTable = 0; uTable < uTableCount; uTable++)
+      SymTable_free(aoSymTables[uTable]);
+   assert(uFound == uTableCount * uTableLength);
+
+   printf("  %lu tables of %2lu bindings: %f seconds\n",
+      (unsigned long)uTableCount, (unsigned long)uTableLength,
+      seconds(iStart, clock()));
+   fflush(stdout);
+
+   free(aoSymTables);
+   (void)iSuccessful;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compare the hash functions of symhash.h with each other and with
+   the original hash function, batched lookups with single ones, and
+   small tables with large ones. argv[1], if present, is the number of
+   keys to use for the chain-length, table and lookup benchmarks
+   (default 1000000). Exit
+   with EXIT_FAILURE if argv[1] is not a positive number. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iKeyCount = 1000000;
+   int i;
+
+   if (argc > 2 || (argc == 2 &&
+      (sscanf(argv[1], "%d", &iKeyCount) != 1 || iKeyCount <= 0)))
+   {
+      fprintf(stderr, "Usage: %s [keycount]\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   printf("------------------------------------------------------\n");
+   printf("Hash throughput:\n");
+   benchThroughput(8);
+   benchThroughput(32);
+   benchThroughput(1000);
+
+   printf("------------------------------------------------------\n");
+   printf("Chain-length distribution:\n");
+   for (i = 0; i < KEY_SET_COUNT; i++)
+      benchChains(&asKeySets[i], iKeyCount);
+
+   printf("------------------------------------------------------\n");
+   printf("SymTable throughput:\n");
+   for (i = 0; i < KEY_SET_COUNT; i++)
+      benchTable(&asKeySets[i], iKeyCount);
+
+   printf("------------------------------------------------------\n");
+   printf("Batched lookups:\n");
+   for (i = 0; i < KEY_SET_COUNT; i++)
+      benchBatch(&asKeySets[i], iKeyCount);
+
+   printf("------------------------------------------------------\n");
+   printf("Small tables, %d bindings in all:\n", iKeyCount);
+   benchSmallTables(2, iKeyCount);
+   benchSmallTables(4, iKeyCount);
+   benchSmallTables(8, iKeyCount);
+   benchSmallTables(16, iKeyCount);
+   benchSmallTables(64, iKeyCount);
+
+   return 0;
+}
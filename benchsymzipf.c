@@ -0,0 +1,222 @@
+/*--------------------------------------------------------------------*/
+/* benchsymzipf.c                                                     */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+enum {MAX_KEY_LENGTH = 16, LOOKUP_COUNT = 200000};
+
+/* Exponents of the Zipf distributions that keys are looked up with.
+   0 looks every key up equally often; the larger the exponent, the
+   more the lookups go to the few most popular keys. */
+static const double adExponents[] = {0.0, 0.8, 1.0, 1.2};
+
+enum {EXPONENT_COUNT = sizeof(adExponents) / sizeof(adExponents[0])};
+
+/* State of the pseudo-random number generator, which is seeded the
+   same way for every distribution so that runs can be compared. */
+static unsigned long ulRandomState;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of CPU seconds between iStart and iEnd. */
+
+static double seconds(clock_t iStart, clock_t iEnd)
+{
+   return ((double)(iEnd - iStart)) / CLOCKS_PER_SEC;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a pseudo-random number in [0, 1). */
+
+static double nextRandom(void)
+{
+   ulRandomState = (ulRandomState * 1103515245UL + 12345UL) &
+      0xffffffffUL;
+   return (double)(ulRandomState >> 8) / 16777216.0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return an array of LOOKUP_COUNT indices of keys, each drawn from
+   the Zipf distribution with exponent dExponent over iKeyCount keys,
+   in which key i is looked up in proportion to 1 / (i + 1)^dExponent.
+   The caller owns the array. */
+
+static int *makeLookups(int iKeyCount, double dExponent)
+{
+   double *pdCumulative;
+   double dTotal = 0.0;
+   double dDraw;
+   int *piLookups;
+   int iLow, iHigh, iMiddle;
+   int i;
+
+   pdCumulative = (double*)malloc((size_t)iKeyCount * sizeof(double));
+   piLookups = (int*)malloc(LOOKUP_COUNT * sizeof(int));
+   assert(pdCumulative != NULL && piLookups != NULL);
+
+   for (i = 0; i < iKeyCount; i++)
+   {
+      dTotal += 1.0 / pow((double)(i + 1), dExponent);
+      pdCumulative[i] = dTotal;
+   }
+
+   ulRandomState = 217;
+   for (i = 0; i < LOOKUP_COUNT; i++)
+   {
+      /* Find the first key whose cumulative weight exceeds the
+         draw. */
+      dDraw = nextRandom() * dTotal;
+      iLow = 0;
+      iHigh = iKeyCount - 1;
+      while (iLow < iHigh)
+      {
+         iMiddle = iLow + (iHigh - iLow) / 2;
+         if (pdCumulative[iMiddle] > dDraw)
+            iHigh = iMiddle;
+         else
+            iLow = iMiddle + 1;
+      }
+      piLookups[i] = iLow;
+   }
+
+   free(pdCumulative);
+   return piLookups;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable holding keys "0" to iKeyCount - 1, added in
+   that order, so that a list puts the most popular keys last. */
+
+static SymTable_T makeTable(int iKeyCount)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int iSuccessful;
+   int i;
+
+   oSymTable = SymTable_new();
+   assert(oSymTable != NULL);
+   for (i = 0; i < iKeyCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      assert(iSuccessful);
+   }
+
+   (void)iSuccessful;
+   return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the position, counting from 1, at which an iterator over
+   oSymTable visits key pcKey. For symtablelist.c, whose iterators
+   follow the list from its first node, this is the number of keys
+   that a lookup of pcKey compares. */
+
+static size_t rankOf(SymTable_T oSymTable, const char *pcKey)
+{
+   SymTableIter_T oIter;
+   size_t uRank = 0;
+
+   oIter = SymTable_iterBegin(oSymTable);
+   assert(oIter != NULL);
+   while (SymTable_iterNext(oIter))
+   {
+      uRank++;
+      if (strcmp(SymTable_iterKey(oIter), pcKey) == 0)
+         break;
+   }
+   SymTable_iterFree(oIter);
+
+   return uRank;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the average number of keys compared per lookup, and the CPU
+   time taken, by LOOKUP_COUNT lookups in a SymTable of iKeyCount
+   keys, drawn from the Zipf distribution with exponent dExponent. The
+   comparisons are counted over one table, and the lookups are timed
+   over a second one, so that the counting is not timed. */
+
+static void benchZipf(int iKeyCount, double dExponent)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int *piLookups;
+   size_t uCompares = 0;
+   size_t uFound = 0;
+   clock_t iStart;
+   double dSeconds;
+   int i;
+
+   piLookups = makeLookups(iKeyCount, dExponent);
+
+   oSymTable = makeTable(iKeyCount);
+   for (i = 0; i < LOOKUP_COUNT; i++)
+   {
+      sprintf(acKey, "%d", piLookups[i]);
+      uCompares += rankOf(oSymTable, acKey);
+      uFound += (size_t)SymTable_contains(oSymTable, acKey);
+   }
+   SymTable_free(oSymTable);
+
+   oSymTable = makeTable(iKeyCount);
+   iStart = clock();
+   for (i = 0; i < LOOKUP_COUNT; i++)
+   {
+      sprintf(acKey, "%d", piLookups[i]);
+      uFound += (size_t)SymTable_contains(oSymTable, acKey);
+   }
+   dSeconds = seconds(iStart, clock());
+   SymTable_free(oSymTable);
+   assert(uFound == 2 * LOOKUP_COUNT);
+
+   printf("  exponent %3.1f  compares/lookup %8.2f  %f seconds\n",
+      dExponent, (double)uCompares / LOOKUP_COUNT, dSeconds);
+   fflush(stdout);
+
+   free(piLookups);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compare how many keys, and how much time, lookups of keys drawn from
+   Zipf distributions take, to show the effect of the SYMTABLE_REORDER
+   setting that the SymTable implementation was built with. argv[1], if
+   present, is the number of keys in the table (default 1000). Exit
+   with EXIT_FAILURE if argv[1] is not a positive number. Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iKeyCount = 1000;
+   int i;
+
+   if (argc > 2 || (argc == 2 &&
+      (sscanf(argv[1], "%d", &iKeyCount) != 1 || iKeyCount <= 0)))
+   {
+      fprintf(stderr, "Usage: %s [keycount]\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   printf("------------------------------------------------------\n");
+   printf("Zipf-distributed lookups, %d lookups of %d keys:\n",
+      LOOKUP_COUNT, iKeyCount);
+   for (i = 0; i < EXPONENT_COUNT; i++)
+      benchZipf(iKeyCount, adExponents[i]);
+
+   return 0;
+}
@@ -0,0 +1,237 @@
+/*--------------------------------------------------------------------*/
+/* stresssymtable.c                                                   */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "symtable.h"
+#include <stdio.h>
+#include <time.h>
+#include <assert.h>
+#include <pthread.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Number of bindings that every thread looks up, and number of keys
+   that each thread adds and removes on its own. */
+enum {SHARED_KEYS = 10000, OWN_KEYS = 1000};
+
+/* Default percentage of operations that add or remove a thread's own
+   key rather than look up a shared one. */
+enum {WRITE_PERCENT = 10};
+
+enum {MAX_KEY_LENGTH = 32};
+
+/* Values of the shared bindings; only their addresses are used. */
+static int aiShared[SHARED_KEYS];
+
+/* The work and results of one thread. */
+struct Worker
+{
+   SymTable_T oSymTable;
+   int iThread;
+   long lOps;
+   int iWritePercent;
+
+   /* 1 for each own key that the thread has left in the table */
+   char acPresent[OWN_KEYS];
+
+   /* Number of wrong answers that the table gave the thread */
+   long lErrors;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the next number of the xorshift sequence in *puState. */
+
+static unsigned long nextRandom(unsigned long *puState)
+{
+   unsigned long u = *puState;
+
+   u ^= u << 13;
+   u ^= u >> 7;
+   u ^= u << 17;
+   *puState = u;
+   return u;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of seconds since some fixed point in the past,
+   as measured by a wall clock. */
+
+static double now(void)
+{
+   struct timespec sTime;
+
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (double)sTime.tv_sec + (double)sTime.tv_nsec / 1e9;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run psWorker's share of the mixed workload: mostly lookups of the
+   shared bindings, each checked against its known value, with adds and
+   removes of the thread's own keys in between. */
+
+static void *runWorker(void *pvWorker)
+{
+   struct Worker *psWorker = (struct Worker *)pvWorker;
+   char acKey[MAX_KEY_LENGTH];
+   unsigned long uState;
+   long l;
+   int iKey;
+
+   uState = 2463534242UL + (unsigned long)psWorker->iThread * 7919UL;
+   for (l = 0; l < psWorker->lOps; l++)
+   {
+      if ((int)(nextRandom(&uState) % 100) >= psWorker->iWritePercent)
+      {
+         iKey = (int)(nextRandom(&uState) % SHARED_KEYS);
+         sprintf(acKey, "shared%d", iKey);
+         if (SymTable_get(psWorker->oSymTable, acKey) !=
+             (void *)&aiShared[iKey])
+            psWorker->lErrors++;
+         continue;
+      }
+
+      iKey = (int)(nextRandom(&uState) % OWN_KEYS);
+      sprintf(acKey, "t%d.%d", psWorker->iThread, iKey);
+      if (psWorker->acPresent[iKey])
+      {
+         if (SymTable_remove(psWorker->oSymTable, acKey) !=
+             (void *)psWorker)
+            psWorker->lErrors++;
+         psWorker->acPresent[iKey] = 0;
+      }
+      else
+      {
+         if (!SymTable_put(psWorker->oSymTable, acKey, psWorker))
+            psWorker->lErrors++;
+         psWorker->acPresent[iKey] = 1;
+      }
+   }
+
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the mixed workload on iThreads threads that share one table,
+   each doing lOps operations of which iWritePercent percent are
+   writes. Print the throughput, and check the table's contents
+   afterwards. Return the number of errors found. */
+
+static long stress(int iThreads, long lOps, int iWritePercent)
+{
+   SymTable_T oSymTable;
+   struct Worker *psWorkers;
+   pthread_t *psThreads;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uExpected = SHARED_KEYS;
+   long lErrors = 0;
+   double dStart, dSeconds;
+   int i, j;
+
+   oSymTable = SymTable_new();
+   psWorkers = (struct Worker *)calloc((size_t)iThreads,
+      sizeof(struct Worker));
+   psThreads = (pthread_t *)malloc((size_t)iThreads *
+      sizeof(pthread_t));
+   if (oSymTable == NULL || psWorkers == NULL || psThreads == NULL)
+   {
+      fprintf(stderr, "Insufficient memory\n");
+      exit(EXIT_FAILURE);
+   }
+
+   for (i = 0; i < SHARED_KEYS; i++)
+   {
+      sprintf(acKey, "shared%d", i);
+      if (!SymTable_put(oSymTable, acKey, &aiShared[i]))
+         lErrors++;
+   }
+
+   dStart = now();
+   for (i = 0; i < iThreads; i++)
+   {
+      psWorkers[i].oSymTable = oSymTable;
+      psWorkers[i].iThread = i;
+      psWorkers[i].lOps = lOps;
+      psWorkers[i].iWritePercent = iWritePercent;
+      if (pthread_create(&psThreads[i], NULL, runWorker,
+            &psWorkers[i]) != 0)
+      {
+         fprintf(stderr, "Cannot create thread\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   for (i = 0; i < iThreads; i++)
+      pthread_join(psThreads[i], NULL);
+   dSeconds = now() - dStart;
+
+   for (i = 0; i < iThreads; i++)
+   {
+      lErrors += psWorkers[i].lErrors;
+      for (j = 0; j < OWN_KEYS; j++)
+      {
+         sprintf(acKey, "t%d.%d", i, j);
+         if (SymTable_contains(oSymTable, acKey) !=
+             psWorkers[i].acPresent[j])
+            lErrors++;
+         uExpected += (size_t)psWorkers[i].acPresent[j];
+      }
+   }
+   if (SymTable_getLength(oSymTable) != uExpected)
+      lErrors++;
+
+   printf("%3d threads  %8.3f s  %8.2f Mops/s  %ld errors\n",
+      iThreads, dSeconds,
+      (double)lOps * iThreads / dSeconds / 1e6, lErrors);
+
+   SymTable_free(oSymTable);
+   free(psThreads);
+   free(psWorkers);
+   return lErrors;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the mixed workload on 1, 2, 4, ... threads up to the number
+   given as argv[1] (default 8), each doing argv[2] operations
+   (default 200000) of which argv[3] percent are writes (default
+   WRITE_PERCENT). Return 0 if the table always answered correctly, or
+   EXIT_FAILURE otherwise. */
+
+int main(int argc, char *argv[])
+{
+   int iMaxThreads = 8;
+   long lOps = 200000;
+   int iWritePercent = WRITE_PERCENT;
+   long lErrors = 0;
+   int iThreads;
+
+   if (argc > 1)
+      iMaxThreads = atoi(argv[1]);
+   if (argc > 2)
+      lOps = atol(argv[2]);
+   if (argc > 3)
+      iWritePercent = atoi(argv[3]);
+   if (iMaxThreads < 1 || lOps < 1 || iWritePercent < 0 ||
+       iWritePercent > 100)
+   {
+      fprintf(stderr, "Usage: %s [maxthreads] [ops] [writepercent]\n",
+         argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   printf("%d%% writes, %ld operations per thread\n",
+      iWritePercent, lOps);
+   for (iThreads = 1; iThreads < iMaxThreads; iThreads *= 2)
+      lErrors += stress(iThreads, lOps, iWritePercent);
+   lErrors += stress(iMaxThreads, lOps, iWritePercent);
+
+   return lErrors == 0 ? 0 : EXIT_FAILURE;
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,217 @@
+/*--------------------------------------------------------------------*/
+/* symarena.c                                                         */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symarena.h"
+
+/* Number of bytes in the first slab of an arena, including its
+   header. Each later slab is twice the size of the one before, up to
+   SLAB_SIZE, so that an arena holding a few keys stays small. */
+static const size_t FIRST_SLAB_SIZE = 256;
+
+/* Number of bytes in each slab, including its header, once the
+   arena has grown. */
+static const size_t SLAB_SIZE = 16384;
+
+/*--------------------------------------------------------------------*/
+
+/* Each slab starts with a SymArenaSlab header, padded to
+   SYMARENA_GRAIN bytes, followed by the blocks carved out of it. */
+struct SymArenaSlab
+{
+    /* Pointer to the previously allocated slab */
+    struct SymArenaSlab *psNextSlab;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Each large block starts with a SymArenaLarge header, padded to
+   SYMARENA_GRAIN bytes. Large blocks are doubly linked so that one can
+   be freed on its own. */
+struct SymArenaLarge
+{
+    /* Pointer to the previous large block, or NULL if first */
+    struct SymArenaLarge *psPrevLarge;
+
+    /* Pointer to the next large block */
+    struct SymArenaLarge *psNextLarge;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return uSize rounded up to a multiple of SYMARENA_GRAIN. */
+
+static size_t SymArena_round(size_t uSize)
+{
+    return (uSize + SYMARENA_GRAIN - 1) & ~(size_t)(SYMARENA_GRAIN - 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Adds a new slab with room for at least uBytes bytes of blocks to
+   *psArena and makes it the one blocks are carved from. Returns 1 on
+   success or 0 if insufficient memory is available. */
+
+static int SymArena_addSlab(struct SymArena *psArena, size_t uBytes)
+{
+    struct SymArenaSlab *psSlab;
+    size_t uHeader = SymArena_round(sizeof(struct SymArenaSlab));
+    size_t uSlabSize;
+
+    assert(psArena != NULL);
+
+    uSlabSize = psArena->uSlabSize;
+    if (uBytes > uSlabSize - uHeader)
+        uSlabSize = uHeader + uBytes;
+
+    /* The tail of the old slab is abandoned. */
+    psSlab = (struct SymArenaSlab *)malloc(uSlabSize);
+    if (psSlab == NULL)
+        return 0;
+    psSlab->psNextSlab = psArena->psSlabs;
+    psArena->psSlabs = psSlab;
+    psArena->pcNext = (char *)psSlab + uHeader;
+    psArena->uLeft = uSlabSize - uHeader;
+    if (psArena->uSlabSize < SLAB_SIZE)
+        psArena->uSlabSize *= 2;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymArena_init(struct SymArena *psArena)
+{
+    size_t i;
+
+    assert(psArena != NULL);
+
+    psArena->psSlabs = NULL;
+    psArena->pcNext = NULL;
+    psArena->uLeft = 0;
+    psArena->uSlabSize = FIRST_SLAB_SIZE;
+    psArena->psLarge = NULL;
+    for (i = (size_t)0; i < SYMARENA_CLASSES; i++)
+        psArena->apvFree[i] = NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymArena_alloc(struct SymArena *psArena, size_t uSize)
+{
+    struct SymArenaLarge *psLarge;
+    size_t uHeader;
+    size_t uClass;
+    void *pvBlock;
+
+    assert(psArena != NULL);
+
+    uSize = SymArena_round(uSize == 0 ? 1 : uSize);
+
+    if (uSize > SYMARENA_MAX_SMALL) {
+        uHeader = SymArena_round(sizeof(struct SymArenaLarge));
+        psLarge = (struct SymArenaLarge *)malloc(uHeader + uSize);
+        if (psLarge == NULL)
+            return NULL;
+        psLarge->psPrevLarge = NULL;
+        psLarge->psNextLarge = psArena->psLarge;
+        if (psArena->psLarge != NULL)
+            psArena->psLarge->psPrevLarge = psLarge;
+        psArena->psLarge = psLarge;
+        return (char *)psLarge + uHeader;
+    }
+
+    /* Reuse a released block of the same size class if possible. */
+    uClass = uSize / SYMARENA_GRAIN - 1;
+    pvBlock = psArena->apvFree[uClass];
+    if (pvBlock != NULL) {
+        psArena->apvFree[uClass] = *(void **)pvBlock;
+        return pvBlock;
+    }
+
+    if (psArena->uLeft < uSize && !SymArena_addSlab(psArena, uSize))
+        return NULL;
+
+    pvBlock = psArena->pcNext;
+    psArena->pcNext += uSize;
+    psArena->uLeft -= uSize;
+    return pvBlock;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymArena_slabBytes(size_t uSize)
+{
+    uSize = SymArena_round(uSize == 0 ? 1 : uSize);
+    return uSize > SYMARENA_MAX_SMALL ? 0 : uSize;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymArena_reserve(struct SymArena *psArena, size_t uBytes)
+{
+    assert(psArena != NULL);
+
+    if (psArena->uLeft >= uBytes)
+        return 1;
+    return SymArena_addSlab(psArena, uBytes);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymArena_release(struct SymArena *psArena, void *pv, size_t uSize)
+{
+    struct SymArenaLarge *psLarge;
+    size_t uClass;
+
+    assert(psArena != NULL);
+    assert(pv != NULL);
+
+    uSize = SymArena_round(uSize == 0 ? 1 : uSize);
+
+    if (uSize > SYMARENA_MAX_SMALL) {
+        psLarge = (struct SymArenaLarge *)((char *)pv -
+            SymArena_round(sizeof(struct SymArenaLarge)));
+        if (psLarge->psPrevLarge == NULL)
+            psArena->psLarge = psLarge->psNextLarge;
+        else
+            psLarge->psPrevLarge->psNextLarge = psLarge->psNextLarge;
+        if (psLarge->psNextLarge != NULL)
+            psLarge->psNextLarge->psPrevLarge = psLarge->psPrevLarge;
+        free(psLarge);
+        return;
+    }
+
+    uClass = uSize / SYMARENA_GRAIN - 1;
+    *(void **)pv = psArena->apvFree[uClass];
+    psArena->apvFree[uClass] = pv;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymArena_freeAll(struct SymArena *psArena)
+{
+    struct SymArenaSlab *psSlab, *psNextSlab;
+    struct SymArenaLarge *psLarge, *psNextLarge;
+
+    assert(psArena != NULL);
+
+    for (psSlab = psArena->psSlabs; psSlab != NULL; psSlab = psNextSlab)
+    {
+        psNextSlab = psSlab->psNextSlab;
+        free(psSlab);
+    }
+
+    for (psLarge = psArena->psLarge; psLarge != NULL;
+         psLarge = psNextLarge)
+    {
+        psNextLarge = psLarge->psNextLarge;
+        free(psLarge);
+    }
+
+    SymArena_init(psArena);
+}
+
+/*--------------------------------------------------------------------*/
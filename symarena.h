@@ -0,0 +1,79 @@
+/*--------------------------------------------------------------------*/
+/* symarena.h                                                         */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMARENA_INCLUDED
+#define SYMARENA_INCLUDED
+
+#include <stddef.h>
+
+/* Blocks of up to SYMARENA_MAX_SMALL bytes are carved out of slabs and
+   recycled through free lists with one list per SYMARENA_GRAIN bytes
+   of size. Larger blocks are allocated individually. */
+enum {SYMARENA_GRAIN = 16, SYMARENA_MAX_SMALL = 512,
+      SYMARENA_CLASSES = SYMARENA_MAX_SMALL / SYMARENA_GRAIN};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymArena is a pool of memory owned by a single SymTable. It hands
+   out variable-sized blocks from large slabs, so that most allocations
+   are a pointer bump or a free-list pop, and releases every block at
+   once in time proportional to the number of slabs. A SymArena is
+   embedded in its owner, so its fields are visible, but they should
+   only be used through the functions below. */
+struct SymArena
+{
+    /* Pointer to the most recently allocated slab, which links to the
+       older ones */
+    struct SymArenaSlab *psSlabs;
+
+    /* Pointer to the first unused byte of the newest slab */
+    char *pcNext;
+
+    /* Number of unused bytes at the end of the newest slab */
+    size_t uLeft;
+
+    /* Number of bytes in the next slab, unless a larger one is
+       needed */
+    size_t uSlabSize;
+
+    /* Heads of the free lists of released small blocks, by size */
+    void *apvFree[SYMARENA_CLASSES];
+
+    /* Pointer to the first individually allocated large block */
+    struct SymArenaLarge *psLarge;
+};
+
+/* Initializes *psArena to an empty arena. Does not allocate memory.
+   Precondition: psArena is non-null. */
+void SymArena_init(struct SymArena *psArena);
+
+/* Returns a block of at least uSize bytes from *psArena, aligned for
+   any object, or NULL if insufficient memory is available.
+   Precondition: psArena is non-null. */
+void *SymArena_alloc(struct SymArena *psArena, size_t uSize);
+
+/* Returns the number of bytes of a slab that a block of uSize bytes
+   occupies, or 0 if such a block is allocated outside the slabs. */
+size_t SymArena_slabBytes(size_t uSize);
+
+/* Makes sure that the next uBytes bytes of blocks carved out of slabs
+   (as measured by SymArena_slabBytes) come from one contiguous slab
+   and need no further allocation. Returns 1 on success, or 0, leaving
+   *psArena unchanged, if insufficient memory is available.
+   Precondition: psArena is non-null. */
+int SymArena_reserve(struct SymArena *psArena, size_t uBytes);
+
+/* Returns the block pv, which was allocated from *psArena with size
+   uSize, to *psArena for reuse.
+   Precondition: psArena and pv are non-null. */
+void SymArena_release(struct SymArena *psArena, void *pv, size_t uSize);
+
+/* Frees every block and slab of *psArena and leaves it empty.
+   Precondition: psArena is non-null. */
+void SymArena_freeAll(struct SymArena *psArena);
+
+#endif
+
+/*--------------------------------------------------------------------*/
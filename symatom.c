@@ -0,0 +1,200 @@
+/*--------------------------------------------------------------------*/
+/* symatom.c                                                          */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "symatom.h"
+#include "symhash.h"
+#include "symarena.h"
+
+/* Number of slots of the pool's index when the first string is
+   interned. A power of two. */
+static const size_t INITIAL_SLOT_COUNT = 64;
+
+/*--------------------------------------------------------------------*/
+
+/* The global pool indexes every SymAtom by its string in a private
+   open-addressing table of atom pointers, probed linearly from the
+   atom's hash code, and kept at most half full. It does not use a
+   SymTable, so interning costs the same whichever SymTable
+   implementation a program is linked with. Each string is stored
+   once, in its atom, and every atom is allocated from one SymArena.
+   The lock is held while the pool is used. */
+static pthread_mutex_t sPoolLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Slots of the index, each NULL or an atom, or NULL until the first
+   string is interned */
+static SymAtom_T *poSlots = NULL;
+
+/* Number of slots of the index, a power of two */
+static size_t uSlotCount = 0;
+
+/* Number of atoms in the pool */
+static size_t uAtomCount = 0;
+
+/* Pool from which every SymAtom is allocated */
+static struct SymArena sAtomArena;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes in a SymAtom whose string has length
+   uLength. */
+
+static size_t SymAtom_size(size_t uLength)
+{
+    return offsetof(struct SymAtom, acName) + uLength + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the slot of the pool that holds the atom of the
+   uLength characters at pcName, whose hash code is uHash, or of the
+   empty slot at which that atom belongs if the pool has none. */
+
+static size_t SymAtom_probe(const char *pcName, size_t uLength,
+size_t uHash)
+{
+    SymAtom_T oAtom;
+    size_t i;
+
+    assert(pcName != NULL);
+    assert(poSlots != NULL);
+
+    for (i = uHash & (uSlotCount - 1); (oAtom = poSlots[i]) != NULL;
+         i = (i + 1) & (uSlotCount - 1))
+        if (oAtom->uHash == uHash && oAtom->uLength == uLength &&
+            memcmp(oAtom->acName, pcName, uLength) == 0)
+            break;
+    return i;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves the atoms of the pool into an index of uNewCount slots, a
+   power of two larger than the number of atoms. Returns 1 on success,
+   or 0, leaving the index unchanged, if insufficient memory is
+   available. */
+
+static int SymAtom_resize(size_t uNewCount)
+{
+    SymAtom_T *poOldSlots = poSlots;
+    size_t uOldCount = uSlotCount;
+    SymAtom_T oAtom;
+    size_t i;
+
+    poSlots = (SymAtom_T *)calloc(uNewCount, sizeof(SymAtom_T));
+    if (poSlots == NULL)
+    {
+        poSlots = poOldSlots;
+        return 0;
+    }
+    uSlotCount = uNewCount;
+
+    for (i = 0; i < uOldCount; i++)
+        if ((oAtom = poOldSlots[i]) != NULL)
+            poSlots[SymAtom_probe(oAtom->acName, oAtom->uLength,
+                                  oAtom->uHash)] = oAtom;
+
+    free(poOldSlots);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymAtom_T SymAtom_intern(const char *pcName)
+{
+    SymAtom_T oAtom;
+    size_t uLength;
+    size_t uHash;
+    size_t uSlot;
+
+    assert(pcName != NULL);
+
+    uLength = strlen(pcName);
+    uHash = SymHash_default(pcName, uLength);
+
+    pthread_mutex_lock(&sPoolLock);
+    if (poSlots == NULL)
+    {
+        if (!SymAtom_resize(INITIAL_SLOT_COUNT))
+        {
+            pthread_mutex_unlock(&sPoolLock);
+            return NULL;
+        }
+        SymArena_init(&sAtomArena);
+    }
+
+    uSlot = SymAtom_probe(pcName, uLength, uHash);
+    oAtom = poSlots[uSlot];
+    if (oAtom == NULL)
+    {
+        /* Grow before adding, so that the index stays at most half
+           full and every probe reaches an empty slot quickly. */
+        if (2 * (uAtomCount + 1) > uSlotCount)
+        {
+            if (!SymAtom_resize(2 * uSlotCount))
+            {
+                pthread_mutex_unlock(&sPoolLock);
+                return NULL;
+            }
+            uSlot = SymAtom_probe(pcName, uLength, uHash);
+        }
+
+        oAtom = (SymAtom_T)SymArena_alloc(&sAtomArena,
+                                          SymAtom_size(uLength));
+        if (oAtom != NULL)
+        {
+            oAtom->uHash = uHash;
+            oAtom->uLength = uLength;
+            memcpy(oAtom->acName, pcName, uLength + 1);
+            poSlots[uSlot] = oAtom;
+            uAtomCount++;
+        }
+    }
+    pthread_mutex_unlock(&sPoolLock);
+
+    return oAtom;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymAtom_name(SymAtom_T oAtom)
+{
+    assert(oAtom != NULL);
+
+    return oAtom->acName;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymAtom_length(SymAtom_T oAtom)
+{
+    assert(oAtom != NULL);
+
+    return oAtom->uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymAtom_freeAll(void)
+{
+    pthread_mutex_lock(&sPoolLock);
+    if (poSlots != NULL)
+    {
+        free(poSlots);
+        SymArena_freeAll(&sAtomArena);
+        poSlots = NULL;
+        uSlotCount = 0;
+        uAtomCount = 0;
+    }
+    pthread_mutex_unlock(&sPoolLock);
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,57 @@
+/*--------------------------------------------------------------------*/
+/* symatom.h                                                          */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMATOM_INCLUDED
+#define SYMATOM_INCLUDED
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A SymAtom is the unique interned copy of a string, together with its
+   length and its hash code under SymHash_default, computed once when
+   the string is first interned. Interning the same string again
+   returns the same SymAtom, so atoms are equal if and only if they are
+   the same pointer. A SymAtom lives until SymAtom_freeAll is called.
+   Its fields are visible so that a SymTable can use them without a
+   function call, but they must not be changed. */
+struct SymAtom
+{
+    /* Hash code of acName under SymHash_default */
+    size_t uHash;
+
+    /* Length of acName */
+    size_t uLength;
+
+    /* Interned String, followed by a null character */
+    char acName[];
+};
+
+typedef struct SymAtom *SymAtom_T;
+
+/* Returns the SymAtom of the string pcName, interning a copy of it in
+   the global pool if it is not there yet, or returns NULL if
+   insufficient memory is available. May be called from several
+   threads at once.
+   Precondition: pcName is non-null. */
+SymAtom_T SymAtom_intern(const char *pcName);
+
+/* Returns the interned string of oAtom.
+   Precondition: oAtom is non-null. */
+const char *SymAtom_name(SymAtom_T oAtom);
+
+/* Returns the length of the interned string of oAtom.
+   Precondition: oAtom is non-null. */
+size_t SymAtom_length(SymAtom_T oAtom);
+
+/* Frees every SymAtom of the global pool, and the pool itself. Every
+   SymAtom, and every SymTable that borrowed an atom's string as a
+   key, must no longer be used. No other thread may be interning at
+   the same time. */
+void SymAtom_freeAll(void);
+
+#endif
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,36 @@
+/*--------------------------------------------------------------------*/
+/* symcursor.c                                                        */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <limits.h>
+#include "symcursor.h"
+
+/*--------------------------------------------------------------------*/
+
+size_t SymCursor_reverseBits(size_t uBits)
+{
+    size_t uShift = CHAR_BIT * sizeof(size_t);
+    size_t uMask = ~(size_t)0;
+
+    while ((uShift >>= 1) > 0) {
+        uMask ^= uMask << uShift;
+        uBits = ((uBits >> uShift) & uMask) |
+            ((uBits << uShift) & ~uMask);
+    }
+    return uBits;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Setting the bits above the mask makes the carry of the reversed
+   increment run through them and out of the word, so it wraps around
+   to 0 after the last bucket. */
+
+size_t SymCursor_next(size_t uCursor, size_t uMask)
+{
+    return SymCursor_reverseBits(
+        SymCursor_reverseBits(uCursor | ~uMask) + 1);
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,32 @@
+/*--------------------------------------------------------------------*/
+/* symcursor.h                                                        */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMCURSOR_INCLUDED
+#define SYMCURSOR_INCLUDED
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* SymCursor walks the buckets of a hash table, whose number of buckets
+   is a power of two, in the reversed binary order of their indices.
+   In that order each bucket of a larger bucket array covers a
+   contiguous run of the buckets of a smaller one, so a walk that goes
+   on from its cursor after the array has been resized never skips a
+   bucket. */
+
+/* Returns uBits with the order of its bits reversed. */
+size_t SymCursor_reverseBits(size_t uBits);
+
+/* Returns the cursor of the bucket after bucket uCursor, in reversed
+   binary order, of a bucket array whose indices are masked by uMask,
+   one less than the number of buckets. The bits of uCursor above
+   uMask are ignored, and those of the result are 0. Returns 0 after
+   the last bucket. */
+size_t SymCursor_next(size_t uCursor, size_t uMask);
+
+#endif
+
+/*--------------------------------------------------------------------*/
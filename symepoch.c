@@ -0,0 +1,206 @@
+/*--------------------------------------------------------------------*/
+/* symepoch.c                                                         */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "symepoch.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Each thread that has read through SymEpoch owns a SymEpochReader.
+   The records are linked into one list that only grows; the record of
+   a thread that has exited is reused by the next thread that needs
+   one. */
+struct SymEpochReader
+{
+    /* Twice the epoch the thread is reading in, plus 1, or 0 if the
+       thread is not reading */
+    atomic_size_t uState;
+
+    /* 1 if the record belongs to a thread, or 0 if it is free */
+    atomic_int iInUse;
+
+    /* Number of nested reads in progress, used only by the owner */
+    size_t uDepth;
+
+    /* Pointer to the next record, which never changes once the record
+       is in the list */
+    struct SymEpochReader *psNextReader;
+};
+
+/* The current epoch. */
+static atomic_size_t uGlobalEpoch;
+
+/* Pointer to the most recently created record. */
+static struct SymEpochReader *_Atomic psFirstReader;
+
+/* Key under which each thread keeps its record. */
+static pthread_key_t sReaderKey;
+
+/* 1 if sReaderKey was created, or 0 if that failed. */
+static int iKeyCreated;
+
+static pthread_once_t sKeyOnce = PTHREAD_ONCE_INIT;
+
+/*--------------------------------------------------------------------*/
+
+/* Frees pvReader, the record of a thread that is exiting, for reuse. */
+
+static void SymEpoch_release(void *pvReader)
+{
+    struct SymEpochReader *psReader = (struct SymEpochReader *)pvReader;
+
+    assert(psReader != NULL);
+
+    atomic_store_explicit(&psReader->uState, 0, memory_order_release);
+    atomic_store_explicit(&psReader->iInUse, 0, memory_order_release);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Creates sReaderKey. Called once. */
+
+static void SymEpoch_createKey(void)
+{
+    iKeyCreated = pthread_key_create(&sReaderKey, SymEpoch_release) == 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the record of the calling thread, taking a free one or
+   creating one if the thread has none, or NULL if insufficient memory
+   is available. */
+
+static struct SymEpochReader *SymEpoch_reader(void)
+{
+    struct SymEpochReader *psReader;
+    struct SymEpochReader *psFirst;
+    int iFree;
+
+    pthread_once(&sKeyOnce, SymEpoch_createKey);
+    if (!iKeyCreated)
+        return NULL;
+
+    psReader = (struct SymEpochReader *)pthread_getspecific(sReaderKey);
+    if (psReader != NULL)
+        return psReader;
+
+    for (psReader = atomic_load(&psFirstReader); psReader != NULL;
+         psReader = psReader->psNextReader)
+    {
+        iFree = 0;
+        if (atomic_compare_exchange_strong(&psReader->iInUse, &iFree,
+                                           1))
+            break;
+    }
+
+    if (psReader == NULL)
+    {
+        psReader = (struct SymEpochReader *)malloc(
+            sizeof(struct SymEpochReader));
+        if (psReader == NULL)
+            return NULL;
+        atomic_init(&psReader->uState, 0);
+        atomic_init(&psReader->iInUse, 1);
+        psFirst = atomic_load(&psFirstReader);
+        do
+            psReader->psNextReader = psFirst;
+        while (!atomic_compare_exchange_weak(&psFirstReader, &psFirst,
+                                             psReader));
+    }
+
+    if (pthread_setspecific(sReaderKey, psReader) != 0)
+    {
+        SymEpoch_release(psReader);
+        return NULL;
+    }
+    psReader->uDepth = 0;
+    return psReader;
+}
+
+/*--------------------------------------------------------------------*/
+
+struct SymEpochReader *SymEpoch_enter(void)
+{
+    struct SymEpochReader *psReader;
+
+    psReader = SymEpoch_reader();
+    if (psReader == NULL)
+        return NULL;
+
+    if (psReader->uDepth++ == 0)
+    {
+        atomic_store_explicit(&psReader->uState,
+            atomic_load(&uGlobalEpoch) * 2 + 1, memory_order_relaxed);
+        /* The announcement must be visible before anything is read. */
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    return psReader;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymEpoch_exit(struct SymEpochReader *psReader)
+{
+    assert(psReader != NULL);
+    assert(psReader->uDepth > 0);
+
+    if (--psReader->uDepth == 0)
+        atomic_store_explicit(&psReader->uState, 0,
+                              memory_order_release);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymEpoch_current(void)
+{
+    /* Whatever was unlinked before must be visible before the epoch
+       is read. */
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load(&uGlobalEpoch);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymEpoch_advance(void)
+{
+    struct SymEpochReader *psReader;
+    size_t uEpoch;
+    size_t uState;
+
+    uEpoch = atomic_load(&uGlobalEpoch);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    for (psReader = atomic_load(&psFirstReader); psReader != NULL;
+         psReader = psReader->psNextReader)
+    {
+        uState = atomic_load(&psReader->uState);
+        if (uState != 0 && uState / 2 != uEpoch)
+            return uEpoch;
+    }
+
+    /* If another thread advanced first, its epoch is as good. */
+    (void)atomic_compare_exchange_strong(&uGlobalEpoch, &uEpoch,
+                                         uEpoch + 1);
+    return atomic_load(&uGlobalEpoch);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymEpoch_synchronize(void)
+{
+    size_t uTarget;
+
+    uTarget = SymEpoch_current() + 2;
+    while (SymEpoch_advance() < uTarget)
+        sched_yield();
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,52 @@
+/*--------------------------------------------------------------------*/
+/* symepoch.h                                                         */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMEPOCH_INCLUDED
+#define SYMEPOCH_INCLUDED
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* SymEpoch is an epoch-based reclamation scheme that lets threads read
+   a linked structure without taking any lock while other threads
+   unlink parts of it. A reader brackets each read with SymEpoch_enter
+   and SymEpoch_exit. A writer that unlinks a block tags it with
+   SymEpoch_current, and frees it only once SymEpoch_advance has moved
+   two epochs past the tag, when no reader can still reach it. The
+   epochs are shared by every structure in the process. */
+
+/* A SymEpochReader is the record through which one thread announces
+   the epoch in which it is reading. */
+struct SymEpochReader;
+
+/* Marks the calling thread as reading until the matching call of
+   SymEpoch_exit. Calls may be nested. Returns the thread's record, or
+   NULL if insufficient memory is available to create one, in which
+   case the caller must read under a lock instead. */
+struct SymEpochReader *SymEpoch_enter(void);
+
+/* Ends the read started by the matching SymEpoch_enter, which returned
+   psReader.
+   Precondition: psReader is non-null. */
+void SymEpoch_exit(struct SymEpochReader *psReader);
+
+/* Returns the epoch with which to tag a block that has just been
+   unlinked. */
+size_t SymEpoch_current(void);
+
+/* Moves to the next epoch if every thread that is reading has seen the
+   current one, and returns the current epoch. A block tagged with
+   epoch uTag may be freed once this returns uTag + 2 or more. */
+size_t SymEpoch_advance(void);
+
+/* Waits until every read that was in progress when it was called has
+   ended, so that any block unlinked before the call may be freed.
+   Precondition: the calling thread is not reading. */
+void SymEpoch_synchronize(void);
+
+#endif
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,187 @@
+/*--------------------------------------------------------------------*/
+/* symhash.c                                                          */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "symhash.h"
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+#ifndef SYMHASH_DEFAULT
+#define SYMHASH_DEFAULT SymHash_wide
+#endif
+
+/* Odd 64-bit constants with well-spread bits, used as multipliers and
+   seeds by the mixing functions below. */
+static const uint64_t SYMHASH_P0 = 0xa0761d6478bd642fULL;
+static const uint64_t SYMHASH_P1 = 0xe7037ed1a0b428dbULL;
+static const uint64_t SYMHASH_P2 = 0x8ebc6af09c88c6e3ULL;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the 64-bit word stored (in native byte order) in the eight
+   bytes starting at pc, which need not be aligned. */
+
+static uint64_t SymHash_read64(const char *pc)
+{
+    uint64_t uWord;
+    memcpy(&uWord, pc, sizeof(uWord));
+    return uWord;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the 32-bit word stored (in native byte order) in the four
+   bytes starting at pc, which need not be aligned. */
+
+static uint64_t SymHash_read32(const char *pc)
+{
+    uint32_t uWord;
+    memcpy(&uWord, pc, sizeof(uWord));
+    return uWord;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the high and low halves of the 128-bit product of uA and uB,
+   xored together. */
+
+static uint64_t SymHash_mum(uint64_t uA, uint64_t uB)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 uProduct = (uint128)uA * uB;
+    return (uint64_t)uProduct ^ (uint64_t)(uProduct >> 64);
+#else
+    uint64_t uAHi = uA >> 32, uALo = (uint32_t)uA;
+    uint64_t uBHi = uB >> 32, uBLo = (uint32_t)uB;
+    uint64_t uHiHi = uAHi * uBHi, uHiLo = uAHi * uBLo;
+    uint64_t uLoHi = uALo * uBHi, uLoLo = uALo * uBLo;
+    uint64_t uMid = (uLoLo >> 32) + (uint32_t)uHiLo + (uint32_t)uLoHi;
+    uint64_t uLo = (uMid << 32) | (uint32_t)uLoLo;
+    uint64_t uHi = uHiHi + (uHiLo >> 32) + (uLoHi >> 32) + (uMid >> 32);
+    return uLo ^ uHi;
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return uHash with its bits mixed so that every output bit depends on
+   every input bit (the MurmurHash3 64-bit finalizer). */
+
+static uint64_t SymHash_finalize(uint64_t uHash)
+{
+    uHash ^= uHash >> 33;
+    uHash *= 0xff51afd7ed558ccdULL;
+    uHash ^= uHash >> 33;
+    uHash *= 0xc4ceb9fe1a85ec53ULL;
+    uHash ^= uHash >> 33;
+    return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymHash_classic(const char *pcKey, size_t uLength)
+{
+   const uint64_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   uint64_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; u < uLength; u++)
+       uHash = uHash * HASH_MULTIPLIER + (uint64_t)pcKey[u];
+   return (size_t)SymHash_finalize(uHash);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymHash_wide(const char *pcKey, size_t uLength)
+{
+    const char *pc = pcKey;
+    size_t uLeft = uLength;
+    uint64_t uSeed = SYMHASH_P0;
+    uint64_t uA, uB;
+
+    assert(pcKey != NULL);
+
+    if (uLeft <= 16) {
+        if (uLeft >= 8) {
+            /* The two words overlap when uLength < 16. */
+            uA = SymHash_read64(pc);
+            uB = SymHash_read64(pc + uLeft - 8);
+        } else if (uLeft >= 4) {
+            uA = SymHash_read32(pc);
+            uB = SymHash_read32(pc + uLeft - 4);
+        } else if (uLeft > 0) {
+            uA = ((uint64_t)(unsigned char)pc[0] << 16)
+                | ((uint64_t)(unsigned char)pc[uLeft >> 1] << 8)
+                | (uint64_t)(unsigned char)pc[uLeft - 1];
+            uB = 0;
+        } else {
+            uA = 0;
+            uB = 0;
+        }
+    } else {
+        while (uLeft > 16) {
+            uSeed = SymHash_mum(SymHash_read64(pc) ^ SYMHASH_P1,
+                                SymHash_read64(pc + 8) ^ uSeed);
+            pc += 16;
+            uLeft -= 16;
+        }
+        /* The last 16 bytes of the key, which may overlap bytes that
+           were already consumed. */
+        uA = SymHash_read64(pc + uLeft - 16);
+        uB = SymHash_read64(pc + uLeft - 8);
+    }
+
+    return (size_t)SymHash_mum(SYMHASH_P1 ^ (uint64_t)uLength,
+        SymHash_mum(uA ^ SYMHASH_P1, uB ^ uSeed ^ SYMHASH_P2));
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymHash_crc(const char *pcKey, size_t uLength)
+{
+#ifdef __SSE4_2__
+    const char *pc = pcKey;
+    size_t uLeft = uLength;
+    uint64_t uLow = 0, uHigh = SYMHASH_P0;
+    uint64_t uTail = 0;
+
+    assert(pcKey != NULL);
+
+    /* Two independent CRC streams hide the instruction's latency. */
+    while (uLeft >= 16) {
+        uLow = _mm_crc32_u64(uLow, SymHash_read64(pc));
+        uHigh = _mm_crc32_u64(uHigh, SymHash_read64(pc + 8));
+        pc += 16;
+        uLeft -= 16;
+    }
+    if (uLeft >= 8) {
+        uLow = _mm_crc32_u64(uLow, SymHash_read64(pc));
+        pc += 8;
+        uLeft -= 8;
+    }
+    memcpy(&uTail, pc, uLeft);
+    uHigh = _mm_crc32_u64(uHigh, uTail ^ (uint64_t)uLength);
+
+    return (size_t)SymHash_finalize((uHigh << 32) ^ uLow);
+#else
+    return SymHash_wide(pcKey, uLength);
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymHash_default(const char *pcKey, size_t uLength)
+{
+    return SYMHASH_DEFAULT(pcKey, uLength);
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,38 @@
+/*--------------------------------------------------------------------*/
+/* symhash.h                                                          */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMHASH_INCLUDED
+#define SYMHASH_INCLUDED
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Each SymHash function returns a hash code for the uLength bytes
+   starting at pcKey, whose bits (including the low-order bits) all
+   depend on every byte, so it can be passed to SymTable_newWithHash.
+   Precondition: pcKey is non-null. */
+
+/* The multiplicative hash from the assignment specification, one byte
+   at a time, followed by a finalizing mix. */
+size_t SymHash_classic(const char *pcKey, size_t uLength);
+
+/* A multiply-mix hash in the style of wyhash that consumes eight bytes
+   at a time. */
+size_t SymHash_wide(const char *pcKey, size_t uLength);
+
+/* A hash built on the SSE4.2 CRC32C instruction, eight bytes at a
+   time, followed by a finalizing mix. If the compiler does not target
+   SSE4.2 (e.g. -msse4.2 or -march=native), this is SymHash_wide. */
+size_t SymHash_crc(const char *pcKey, size_t uLength);
+
+/* The hash used by SymTable_new: SymHash_wide, unless symhash.c is
+   compiled with -D SYMHASH_DEFAULT=SymHash_classic or
+   -D SYMHASH_DEFAULT=SymHash_crc. */
+size_t SymHash_default(const char *pcKey, size_t uLength);
+
+#endif
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,213 @@
+/*--------------------------------------------------------------------*/
+/* symorder.c                                                         */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include "symtable.h"
+
+/*--------------------------------------------------------------------*/
+
+/* The ordered queries of symtable.h for the implementations that do
+   not keep their keys in order: the list, hash, open-addressing,
+   concurrent and sharded SymTables. They are built on SymTable_map
+   alone, and visit every binding to find the ones that they need. The
+   tree implementations answer these queries from their own order
+   instead, and are not linked with this module. */
+
+/* A SymTableRange is the work of a SymTable_mapRange. */
+struct SymTableRange
+{
+    /* Least and greatest key of the range, or NULL if that end is
+       open */
+    const char *pcLow;
+    const char *pcHigh;
+
+    /* Function applied to each binding in the range, and its extra
+       parameter */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+    void *pvExtra;
+};
+
+/* A SymTableBound is the work of a SymTable_floor or
+   SymTable_ceiling. */
+struct SymTableBound
+{
+    /* Key to which the closest binding is sought */
+    const char *pcKey;
+
+    /* 1 to seek the least key at least pcKey, or 0 to seek the
+       greatest key at most pcKey */
+    int iCeiling;
+
+    /* Closest binding found so far, or NULL */
+    const char *pcBest;
+    void *pvBest;
+};
+
+/* A SymTablePrefix is the work of a SymTable_mapPrefix. */
+struct SymTablePrefix
+{
+    /* Prefix, and its length */
+    const char *pcPrefix;
+    size_t uLength;
+
+    /* Function applied to each binding with the prefix, and its extra
+       parameter */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+    void *pvExtra;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvRange, a SymTableRange, to the binding
+   with key pcKey and value pvValue if pcKey is in the range. */
+
+static void SymTable_applyInRange(const char *pcKey, void *pvValue,
+void *pvRange)
+{
+    struct SymTableRange *psRange = (struct SymTableRange *)pvRange;
+
+    assert(psRange != NULL);
+
+    if (psRange->pcLow != NULL && strcmp(pcKey, psRange->pcLow) < 0)
+        return;
+    if (psRange->pcHigh != NULL && strcmp(pcKey, psRange->pcHigh) > 0)
+        return;
+
+    (*psRange->pfApply)(pcKey, pvValue, psRange->pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapRange(SymTable_T oSymTable, const char *pcLow,
+const char *pcHigh,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableRange sRange;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sRange.pcLow = pcLow;
+    sRange.pcHigh = pcHigh;
+    sRange.pfApply = pfApply;
+    sRange.pvExtra = (void *)pvExtra;
+    SymTable_map(oSymTable, SymTable_applyInRange, &sRange);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvPrefix, a SymTablePrefix, to the binding
+   with key pcKey and value pvValue if pcKey starts with the prefix. */
+
+static void SymTable_applyWithPrefix(const char *pcKey, void *pvValue,
+void *pvPrefix)
+{
+    struct SymTablePrefix *psPrefix = (struct SymTablePrefix *)pvPrefix;
+
+    assert(psPrefix != NULL);
+
+    if (strncmp(pcKey, psPrefix->pcPrefix, psPrefix->uLength) != 0)
+        return;
+
+    (*psPrefix->pfApply)(pcKey, pvValue, psPrefix->pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTablePrefix sPrefix;
+
+    assert(oSymTable != NULL);
+    assert(pcPrefix != NULL);
+    assert(pfApply != NULL);
+
+    sPrefix.pcPrefix = pcPrefix;
+    sPrefix.uLength = strlen(pcPrefix);
+    sPrefix.pfApply = pfApply;
+    sPrefix.pvExtra = (void *)pvExtra;
+    SymTable_map(oSymTable, SymTable_applyWithPrefix, &sPrefix);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Makes the binding with key pcKey and value pvValue the closest one
+   found by pvBound, a SymTableBound, if it is on the sought side of
+   the key and closer to it than the closest one so far. */
+
+static void SymTable_closerBound(const char *pcKey, void *pvValue,
+void *pvBound)
+{
+    struct SymTableBound *psBound = (struct SymTableBound *)pvBound;
+    int iOrder;
+
+    assert(psBound != NULL);
+
+    iOrder = strcmp(pcKey, psBound->pcKey);
+    if (psBound->iCeiling ? iOrder < 0 : iOrder > 0)
+        return;
+
+    if (psBound->pcBest != NULL)
+    {
+        iOrder = strcmp(pcKey, psBound->pcBest);
+        if (psBound->iCeiling ? iOrder >= 0 : iOrder <= 0)
+            return;
+    }
+
+    psBound->pcBest = pcKey;
+    psBound->pvBest = pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the closest key of oSymTable to pcKey that is at least pcKey
+   if iCeiling is 1, or at most pcKey if it is 0, or NULL if there is
+   none, setting *ppvValue, if ppvValue is non-null, to its value. */
+
+static const char *SymTable_bound(SymTable_T oSymTable,
+const char *pcKey, int iCeiling, void **ppvValue)
+{
+    struct SymTableBound sBound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    sBound.pcKey = pcKey;
+    sBound.iCeiling = iCeiling;
+    sBound.pcBest = NULL;
+    sBound.pvBest = NULL;
+    SymTable_map(oSymTable, SymTable_closerBound, &sBound);
+
+    if (ppvValue != NULL && sBound.pcBest != NULL)
+        *ppvValue = sBound.pvBest;
+    return sBound.pcBest;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_floor(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_bound(oSymTable, pcKey, 0, ppvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_ceiling(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_bound(oSymTable, pcKey, 1, ppvValue);
+}
+
+/*--------------------------------------------------------------------*/
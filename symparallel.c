@@ -0,0 +1,176 @@
+/*--------------------------------------------------------------------*/
+/* symparallel.c                                                      */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "symparallel.h"
+
+/* Number of ranges into which the items are divided for each thread,
+   so that threads whose ranges are quick to visit help the others. */
+static const size_t RANGES_PER_THREAD = 8;
+
+/* Alignment of the threads' blocks: a multiple of the alignment of any
+   object, and the size of a cache line, so that no two threads write
+   to the same line. */
+static const size_t PART_ALIGNMENT = 64;
+
+/*--------------------------------------------------------------------*/
+
+/* A SymParallelRun is the state of one SymParallel_run that its
+   threads share. */
+struct SymParallelRun
+{
+    /* Storage whose items are visited */
+    void *pvJob;
+
+    /* Function that visits a range of items */
+    SymParallel_RangeFunction pfRange;
+
+    /* Number of Items */
+    size_t uItems;
+
+    /* Number of items in each range but the last */
+    size_t uRangeSize;
+
+    /* Index of the first item of the next range to be taken */
+    atomic_size_t uNextItem;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymParallelWorker is one thread of a SymParallel_run. */
+struct SymParallelWorker
+{
+    /* Run to which the thread belongs */
+    struct SymParallelRun *psRun;
+
+    /* Extra parameter passed to the run's range function */
+    void *pvPart;
+
+    /* The thread */
+    pthread_t sThread;
+
+    /* 1 if the thread was created, or 0 otherwise */
+    int iStarted;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Takes ranges of psRun and visits them with pvPart until none are
+   left. */
+
+static void SymParallel_work(struct SymParallelRun *psRun, void *pvPart)
+{
+    size_t uBegin;
+    size_t uEnd;
+
+    assert(psRun != NULL);
+
+    for (;;)
+    {
+        uBegin = atomic_fetch_add(&psRun->uNextItem, psRun->uRangeSize);
+        if (uBegin >= psRun->uItems)
+            return;
+        uEnd = psRun->uItems - uBegin < psRun->uRangeSize ?
+            psRun->uItems : uBegin + psRun->uRangeSize;
+        (*psRun->pfRange)(psRun->pvJob, uBegin, uEnd, pvPart);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Runs the SymParallelWorker pvWorker on a thread of its own. */
+
+static void *SymParallel_start(void *pvWorker)
+{
+    struct SymParallelWorker *psWorker =
+        (struct SymParallelWorker *)pvWorker;
+
+    assert(psWorker != NULL);
+
+    SymParallel_work(psWorker->psRun, psWorker->pvPart);
+    return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymParallel_run(void *pvJob, size_t uItems,
+SymParallel_RangeFunction pfRange, size_t uThreads, void *pvExtra,
+size_t uPartSize, void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymParallelRun sRun;
+    struct SymParallelWorker *psWorkers;
+    char *pcParts = NULL;
+    void *pvParts;
+    size_t uPartBytes;
+    size_t i;
+
+    assert(pfRange != NULL);
+    assert(uThreads > 0);
+    assert(uPartSize == 0 || pfReduce != NULL);
+
+    if (uItems == 0)
+        return 1;
+    if (uThreads > uItems)
+        uThreads = uItems;
+
+    psWorkers = (struct SymParallelWorker *)calloc(uThreads,
+        sizeof(struct SymParallelWorker));
+    if (psWorkers == NULL)
+        return 0;
+
+    uPartBytes = (uPartSize + PART_ALIGNMENT - 1) / PART_ALIGNMENT *
+        PART_ALIGNMENT;
+    if (uPartSize > 0)
+    {
+        if (posix_memalign(&pvParts, PART_ALIGNMENT,
+                           uThreads * uPartBytes) != 0)
+        {
+            free(psWorkers);
+            return 0;
+        }
+        pcParts = (char *)pvParts;
+        memset(pcParts, 0, uThreads * uPartBytes);
+    }
+
+    sRun.pvJob = pvJob;
+    sRun.pfRange = pfRange;
+    sRun.uItems = uItems;
+    sRun.uRangeSize = uItems / (uThreads * RANGES_PER_THREAD);
+    if (sRun.uRangeSize == 0)
+        sRun.uRangeSize = 1;
+    atomic_init(&sRun.uNextItem, 0);
+
+    for (i = (size_t)0; i < uThreads; i++)
+    {
+        psWorkers[i].psRun = &sRun;
+        psWorkers[i].pvPart = uPartSize > 0 ?
+            (void *)(pcParts + i * uPartBytes) : pvExtra;
+    }
+
+    /* The calling thread is worker 0. */
+    for (i = (size_t)1; i < uThreads; i++)
+        psWorkers[i].iStarted = pthread_create(&psWorkers[i].sThread,
+            NULL, SymParallel_start, psWorkers + i) == 0;
+    SymParallel_work(&sRun, psWorkers[0].pvPart);
+    for (i = (size_t)1; i < uThreads; i++)
+        if (psWorkers[i].iStarted)
+            pthread_join(psWorkers[i].sThread, NULL);
+
+    if (uPartSize > 0)
+        for (i = (size_t)0; i < uThreads; i++)
+            (*pfReduce)(pvExtra, psWorkers[i].pvPart);
+
+    free(pcParts);
+    free(psWorkers);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/*--------------------------------------------------------------------*/
+/* symparallel.h                                                      */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMPARALLEL_INCLUDED
+#define SYMPARALLEL_INCLUDED
+
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* SymParallel runs the visit of a SymTable's storage, divided into
+   ranges of items such as buckets or entries, on several threads, for
+   SymTable_mapParallel. */
+
+/* A SymParallel_RangeFunction visits items uBegin up to, but not
+   including, uEnd of the storage that pvJob describes, passing pvPart
+   as the extra parameter of each callback. */
+typedef void (*SymParallel_RangeFunction)(void *pvJob, size_t uBegin,
+size_t uEnd, void *pvPart);
+
+/* Calls *pfRange on pvJob for consecutive ranges that together cover
+   items 0 to uItems - 1, on up to uThreads threads at once, one of
+   which is the calling thread. Each thread takes the next range as
+   soon as it has visited the previous one, and a thread that cannot be
+   created leaves its share to the others. If uPartSize is 0, every
+   call receives pvExtra as pvPart. Otherwise each thread receives its
+   own block of uPartSize zeroed bytes, aligned for any object, and
+   once every range has been visited, *pfReduce is called on the
+   calling thread with pvExtra and each block in turn. Returns 1 on
+   success, or 0, without calling pfRange, if insufficient memory is
+   available.
+   Precondition: pfRange is non-null, uThreads is positive, and
+   pfReduce is non-null if uPartSize is positive. */
+int SymParallel_run(void *pvJob, size_t uItems,
+SymParallel_RangeFunction pfRange, size_t uThreads, void *pvExtra,
+size_t uPartSize, void (*pfReduce)(void *pvExtra, void *pvPart));
+
+#endif
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,36 @@
+/*--------------------------------------------------------------------*/
+/* symprefetch.h                                                      */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMPREFETCH_INCLUDED
+#define SYMPREFETCH_INCLUDED
+
+/*--------------------------------------------------------------------*/
+
+/* SymPrefetch lets SymTable_getBatch overlap the cache misses of
+   several lookups. The keys are taken in groups: every key of a group
+   is hashed and its bucket prefetched, then every bucket is read and
+   the binding it leads to prefetched, and only then is each lookup
+   resolved, by which time its memory has (ideally) arrived. */
+
+/* Number of keys in a group. It should cover the latency of a miss
+   to main memory, but the prefetches of a group must fit in the
+   processor's outstanding-miss buffers. Override with
+   -D SYMPREFETCH_GROUP. */
+#ifndef SYMPREFETCH_GROUP
+#define SYMPREFETCH_GROUP 16
+#endif
+
+/* Starts loading the cache line that holds the byte at pv into the
+   cache, for reading, without waiting for it. A prefetch never
+   faults. Compilers without __builtin_prefetch do nothing. */
+#ifdef __GNUC__
+#define SYMPREFETCH(pv) __builtin_prefetch((pv), 0, 3)
+#else
+#define SYMPREFETCH(pv) ((void)(pv))
+#endif
+
+#endif
+
+/*--------------------------------------------------------------------*/
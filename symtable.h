@@ -8,6 +8,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include "symatom.h"
 
 /*--------------------------------------------------------------------*/
 
@@ -18,6 +19,52 @@ typedef struct SymTable *SymTable_T;
    return NULL if insufficient memory is available. */
 SymTable_T SymTable_new(void);
 
+/* A SymTable_HashFunction returns a hash code for the uLength bytes
+   starting at pcKey. The low-order bits of the hash code select a
+   bucket, so they should depend on every byte of the key; see
+   symhash.h for ready-made functions. */
+typedef size_t (*SymTable_HashFunction)(const char *pcKey,
+size_t uLength);
+
+/* Create, initialize, and return a new and empty SymTable_T object that
+   hashes keys with pfHash, or return NULL if insufficient memory is
+   available. Implementations that do not hash keys ignore pfHash.
+   Precondition: pfHash is non-null. */
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash);
+
+/* Create, initialize, and return a new and empty SymTable_T object that
+   can hold uCapacity bindings without growing, or return NULL if
+   insufficient memory is available. */
+SymTable_T SymTable_newWithCapacity(size_t uCapacity);
+
+/* Create, initialize, and return a new and empty SymTable_T object that
+   borrows its keys, or return NULL if insufficient memory is
+   available. Such a table stores the pcKey pointer through which a
+   binding is added instead of a copy of the key, so the caller must
+   keep that key valid, unchanged and followed by a null character
+   until the binding is removed or the table is freed. The keys passed
+   to SymTable_map and returned by SymTable_iterKey are then those
+   pointers. */
+SymTable_T SymTable_newWithBorrowedKeys(void);
+
+/* Prepares oSymTable to hold uCapacity bindings in total, so that
+   adding bindings up to that number does not grow it. Returns 1 on
+   success. If insufficient memory is available, the bindings of
+   oSymTable are unchanged and returns 0.
+   Precondition: oSymTable is non-null. */
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity);
+
+/* Releases the memory that oSymTable holds beyond what its current
+   bindings need, including any capacity reserved with
+   SymTable_newWithCapacity or SymTable_reserve. Returns 1 on success.
+   If insufficient memory is available, oSymTable is unchanged and
+   returns 0. An implementation that rehashes bindings in place keeps
+   its slots as they are while an iterator over oSymTable is in use,
+   so that the iteration visits every binding exactly once; it still
+   returns 1.
+   Precondition: oSymTable is non-null. */
+int SymTable_compact(SymTable_T oSymTable);
+
 /* Frees all memory occupied by oSymTable.
    Precondition: oSymTable is non-null. */
 void SymTable_free(SymTable_T oSymTable);
@@ -34,6 +81,29 @@ size_t SymTable_getLength(SymTable_T oSymTable);
 int SymTable_put(SymTable_T oSymTable, const char *pcKey,
 const void *pvValue);
 
+/* Looks up the binding in oSymTable with the key pcKey, adding a new
+   binding with key pcKey and value pvValue if no such binding exists.
+   Returns a pointer to the value of the binding, through which it may
+   be read or replaced, and sets *piAdded (if piAdded is non-null) to 1
+   if the binding was added or 0 if it already existed. If insufficient
+   memory is available, oSymTable is unchanged and NULL is returned.
+   The pointer remains valid until a binding is added to or removed
+   from oSymTable, or oSymTable is compacted.
+   Precondition: oSymTable and pcKey are non-null. */
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded);
+
+/* Adds a binding to oSymTable for each i < uCount with key apcKeys[i]
+   and value apvValues[i] (or NULL if apvValues is NULL). Keys that are
+   already in oSymTable, or that repeat an earlier key of apcKeys, are
+   skipped. The table is sized for all uCount bindings before any is
+   added. Returns 1 on success. If insufficient memory is available,
+   oSymTable is unchanged and returns 0.
+   Precondition: oSymTable, apcKeys and each apcKeys[i] are
+   non-null. */
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount);
+
 /* Replaces the value of a binding in oSymTable that has the key pcKey
    with pvValue. Returns the previous value of the binding. If a
    binding with key pcKey does not exist, oSymTable is unchanged and
@@ -52,12 +122,64 @@ int SymTable_contains(SymTable_T oSymTable, const char *pcKey);
    Precondition: oSymtable and pcKey are non-null. */
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey);
 
+/* Sets apvValues[i], for each i < uCount, to the value of the binding
+   in oSymTable with key apcKeys[i], or to NULL if no such binding
+   exists, as uCount calls of SymTable_get would. Returns the number of
+   keys that were found. The lookups are interleaved so that their
+   memory accesses overlap, which is faster than separate calls on a
+   table too large for the cache.
+   Precondition: oSymTable, apcKeys, apvValues and each apcKeys[i] are
+   non-null. */
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[]);
+
 /* Removes the binding in oSymTable with key pcKey. Returns the value of
    that binding, and frees allocated memory. If no such binding exists,
    oSymTable is unchanged and NULL is returned.
    Precondition: oSymtable and pcKey are non-null.  */
 void *SymTable_remove(SymTable_T oSymTable, const char *pcKey);
 
+/* Each of the following functions takes its key as the uLength
+   characters starting at pcKey, which need not be followed by a null
+   character, and otherwise behaves as the function of the same name
+   without the final N: SymTable_getN(oSymTable, pcKey, strlen(pcKey))
+   is SymTable_get(oSymTable, pcKey). A key can thus be looked up in
+   place within a larger buffer, and a table that is given the length
+   need not compute it. A key that is added is copied, followed by a
+   null character, unless the table borrows its keys.
+   Precondition: oSymTable and pcKey are non-null, and none of the
+   uLength characters at pcKey is the null character. */
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue);
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded);
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue);
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength);
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength);
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength);
+
+/* Each of the following functions takes its key as the string of
+   oAtom, and otherwise behaves as the function of the same name
+   without the final Atom. The length of the key, and its hash code if
+   oSymTable hashes with SymHash_default, are taken from oAtom instead
+   of being computed. A table that borrows its keys stores the atom's
+   own string, so that a later lookup of the same atom matches the
+   binding by pointer without comparing characters.
+   Precondition: oSymTable and oAtom are non-null. */
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue);
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded);
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue);
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom);
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom);
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom);
+
 /* Applies function *pfApply to each binding in oSymTable, with pvExtra
    as an extra parameter for the function.
    Precondition: oSymtable and pfApply are non-null. */
@@ -65,6 +187,119 @@ void SymTable_map(SymTable_T oSymTable,
 void (*pfApply) (const char *pcKey, void *pvValue, void *pvExtra),
 const void *pvExtra);
 
+/* Returns the number of shards into which oSymTable divides its
+   bindings. Every binding belongs to exactly one shard. An
+   implementation that does not shard its bindings has one shard.
+   Precondition: oSymTable is non-null. */
+size_t SymTable_getShardCount(SymTable_T oSymTable);
+
+/* Applies function *pfApply to each binding in shard uShard of
+   oSymTable, with pvExtra as an extra parameter for the function. In
+   a thread-safe implementation, different shards may be mapped by
+   different threads at once.
+   Precondition: oSymtable and pfApply are non-null, and uShard is
+   less than SymTable_getShardCount(oSymTable). */
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply) (const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra);
+
+/* Applies function *pfApply to each binding in oSymTable, like
+   SymTable_map, but divides the bindings among up to uThreads threads
+   that run at once. pfApply may thus be called from several threads
+   at once, and must not add or remove bindings of oSymTable. If
+   uPartSize is 0, every call receives pvExtra as its extra parameter.
+   Otherwise each thread passes its own block of uPartSize zeroed
+   bytes, aligned for any object, and once every binding has been
+   visited, *pfReduce is called on the calling thread with pvExtra and
+   each block in turn, to combine the threads' results. Returns 1 on
+   success, or 0, without calling pfApply, if insufficient memory is
+   available.
+   Precondition: oSymtable and pfApply are non-null, uThreads is
+   positive, and pfReduce is non-null if uPartSize is positive. */
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply) (const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce) (void *pvExtra, void *pvPart));
+
+/* Applies function *pfApply to each binding in oSymTable whose key is
+   at least pcLow and at most pcHigh, with pvExtra as an extra
+   parameter for the function. Keys are ordered as strcmp orders them,
+   and a null pcLow or pcHigh leaves that end of the range open. An
+   ordered implementation visits only the bindings in the range, in
+   ascending order of their keys. Any other visits every binding to
+   find them, and applies pfApply in no particular order. pfApply must
+   not add or remove bindings of oSymTable.
+   Precondition: oSymtable and pfApply are non-null. */
+void SymTable_mapRange(SymTable_T oSymTable, const char *pcLow,
+const char *pcHigh,
+void (*pfApply) (const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra);
+
+/* Applies function *pfApply to each binding in oSymTable whose key
+   starts with pcPrefix, with pvExtra as an extra parameter for the
+   function. Every key starts with the empty string. As with
+   SymTable_mapRange, an ordered implementation visits only those
+   bindings, in ascending order of their keys, and any other visits
+   every binding to find them. pfApply must not add or remove bindings
+   of oSymTable.
+   Precondition: oSymtable, pcPrefix and pfApply are non-null. */
+void SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+void (*pfApply) (const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra);
+
+/* Returns the greatest key in oSymTable that is at most pcKey, as
+   strcmp orders keys, and sets *ppvValue (if ppvValue is non-null) to
+   the value of its binding. If there is no such key, returns NULL and
+   leaves *ppvValue unchanged. The key remains valid until its binding
+   is removed or oSymTable is compacted. An ordered implementation
+   takes time logarithmic in the number of bindings; any other visits
+   every binding.
+   Precondition: oSymtable and pcKey are non-null. */
+const char *SymTable_floor(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue);
+
+/* Returns the least key in oSymTable that is at least pcKey, and
+   otherwise behaves as SymTable_floor.
+   Precondition: oSymtable and pcKey are non-null. */
+const char *SymTable_ceiling(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue);
+
+/* A SymTableIter is a cursor over the bindings of one SymTable, which
+   can be advanced one binding at a time and abandoned at any point. */
+typedef struct SymTableIter *SymTableIter_T;
+
+/* Create and return a new iterator over the bindings of oSymTable,
+   positioned before the first binding, or return NULL if insufficient
+   memory is available. Bindings may be added to and removed from
+   oSymTable while the iterator exists: every binding that is in
+   oSymTable from SymTable_iterBegin to the end of the iteration is
+   visited once, and no binding is visited after it has been removed.
+   A binding added during the iteration may or may not be visited. An
+   implementation that rehashes bindings in place may visit a binding
+   a second time if it has to grow during the iteration.
+   Precondition: oSymTable is non-null. */
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable);
+
+/* Advances oIter to the next binding of its SymTable. Returns 1 if
+   there is one, or 0 if every binding has been visited.
+   Precondition: oIter is non-null. */
+int SymTable_iterNext(SymTableIter_T oIter);
+
+/* Returns the key of the binding at which oIter is positioned.
+   Precondition: oIter is non-null, the last call of SymTable_iterNext
+   on it returned 1, and the binding has not been removed since. */
+const char *SymTable_iterKey(SymTableIter_T oIter);
+
+/* Returns the value of the binding at which oIter is positioned.
+   Precondition: oIter is non-null, the last call of SymTable_iterNext
+   on it returned 1, and the binding has not been removed since. */
+void *SymTable_iterValue(SymTableIter_T oIter);
+
+/* Frees oIter. SymTable_free frees every iterator of the SymTable that
+   is still in use, so such iterators must not be used afterwards.
+   Precondition: oIter is non-null. */
+void SymTable_iterFree(SymTableIter_T oIter);
+
 #endif
 
 /*--------------------------------------------------------------------*/
\ No newline at end of file
@@ -0,0 +1,2214 @@
+/*--------------------------------------------------------------------*/
+/* symtableart.c                                                      */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stddef.h>
+#include "symtable.h"
+#include "symarena.h"
+#include "symparallel.h"
+#include "symprefetch.h"
+
+/* Number of bytes of its compressed path that an inner node stores.
+   The rest of a longer path is read from a key below the node when an
+   insertion or an ordered query needs it, and skipped by lookups,
+   which compare the whole key at the leaf. With 8, a node of four
+   children takes one 64-byte cache line. Override with
+   -D SYMTABLE_PREFIX_BYTES. */
+#ifndef SYMTABLE_PREFIX_BYTES
+#define SYMTABLE_PREFIX_BYTES 8
+#endif
+
+/* Kinds of node: a leaf, and inner nodes of up to 4, 16, 48 and 256
+   children. */
+enum {NODE_LEAF, NODE_4, NODE_16, NODE_48, NODE_256};
+
+/* Number of children that each kind of node can hold, and the number
+   at which an inner node is replaced by one of the next smaller kind
+   once a child is removed. */
+static const size_t auCapacity[] = {0, 4, 16, 48, 256};
+static const size_t auShrinkAt[] = {0, 0, 3, 12, 40};
+
+/* Key length assumed for the bindings that SymTable_reserve makes room
+   for. */
+static const size_t RESERVED_KEY_LENGTH = 15;
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableNode is the start of every node of the radix tree. Each
+   key is followed by its null character, which no key contains, so no
+   key is a prefix of another one, and bytes order keys as strcmp
+   does. */
+struct SymTableNode
+{
+    /* NODE_LEAF, NODE_4, NODE_16, NODE_48 or NODE_256 */
+    unsigned char ucType;
+};
+
+/* A SymTableLeaf holds a binding. Its key is copied just after it, in
+   the same block, unless the table borrows its keys. */
+struct SymTableLeaf
+{
+    /* Kind of node */
+    struct SymTableNode sNode;
+
+    /* Length of the key */
+    size_t uLength;
+
+    /* Value of the binding */
+    void *pvValue;
+
+    /* Pointer to the key: acKey, or the caller's key */
+    char *pcKey;
+
+    /* Copy of the key, followed by a null character */
+    char acKey[];
+};
+
+/* A SymTableInner is the start of every inner node. All keys below an
+   inner node at depth d share their first d bytes, followed by the
+   bytes of its compressed path, so those bytes are stored once, in the
+   node, instead of in a chain of nodes of one child each. The next
+   byte of a key selects a child. */
+struct SymTableInner
+{
+    /* Kind of node */
+    struct SymTableNode sNode;
+
+    /* Number of children */
+    unsigned short usCount;
+
+    /* Length of the compressed path */
+    size_t uPrefixLength;
+
+    /* First bytes of the compressed path */
+    unsigned char aucPrefix[SYMTABLE_PREFIX_BYTES];
+};
+
+/* A SymTableNode4 or SymTableNode16 keeps the bytes of its children
+   in ascending order, each child at the index of its byte. */
+struct SymTableNode4
+{
+    struct SymTableInner sInner;
+    unsigned char aucKeys[4];
+    struct SymTableNode *apsChildren[4];
+};
+
+struct SymTableNode16
+{
+    struct SymTableInner sInner;
+    unsigned char aucKeys[16];
+    struct SymTableNode *apsChildren[16];
+};
+
+/* A SymTableNode48 maps each byte to 1 more than the index of its
+   child, or to 0 if it has none. */
+struct SymTableNode48
+{
+    struct SymTableInner sInner;
+    unsigned char aucIndex[256];
+    struct SymTableNode *apsChildren[48];
+};
+
+/* A SymTableNode256 has a child pointer, or NULL, for each byte. */
+struct SymTableNode256
+{
+    struct SymTableInner sInner;
+    struct SymTableNode *apsChildren[256];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable is an adaptive radix tree implementation of a symbol
+   table. A lookup follows one child per byte of the key past the
+   compressed paths, and compares the key with another only at the
+   leaf. Every node, leaf and copied key is allocated from the table's
+   SymArena. */
+struct SymTable
+{
+    /* Pointer to the root node, or NULL if the table is empty */
+    struct SymTableNode *psRoot;
+
+    /* Number of Bindings */
+    size_t symTableLength;
+
+    /* 1 if the leaves point to their callers' keys instead of copies
+       of them */
+    int iBorrowsKeys;
+
+    /* Pool from which every node is allocated */
+    struct SymArena sArena;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter visits the bindings of its SymTable in ascending
+   order of their keys. A leaf does not move while other bindings are
+   added or removed, so the iterator holds the leaf at which it is
+   positioned, and finds the next one by seeking the least key greater
+   than the leaf's. Every iterator in use is linked into its SymTable,
+   so that removing the binding at which an iterator is positioned can
+   move the iterator to the next binding first. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* ITER_BEFORE, ITER_AT, ITER_PENDING or ITER_DONE */
+    int iState;
+
+    /* Leaf at which the iterator is positioned, or which it visits
+       next if the iterator is pending */
+    struct SymTableLeaf *psLeaf;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/* States of a SymTableIter: before the first binding, positioned at
+   psLeaf, about to visit psLeaf because the binding at which it was
+   positioned has been removed, and past the last binding. */
+enum {ITER_BEFORE, ITER_AT, ITER_PENDING, ITER_DONE};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
+{
+    /* Pointer to each leaf, in order */
+    struct SymTableLeaf **ppsLeaves;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+};
+
+/* A SymTableRange is the work of a SymTable_mapRange. */
+struct SymTableRange
+{
+    /* Least and greatest key of the range, or NULL if that end is
+       open, and their lengths */
+    const char *pcLow;
+    size_t uLowLength;
+    const char *pcHigh;
+    size_t uHighLength;
+
+    /* Function applied to each binding in the range, and its extra
+       parameter */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+    void *pvExtra;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return byte uDepth of the uLength characters at pcKey followed by a
+   null character, or a null character if uDepth is past the end. */
+
+static unsigned char SymTable_byte(const char *pcKey, size_t uLength,
+size_t uDepth)
+{
+    assert(pcKey != NULL);
+
+    if (uDepth < uLength)
+        return (unsigned char)pcKey[uDepth];
+    return (unsigned char)'\0';
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes of a leaf of oSymTable whose key has
+   length uLength. */
+
+static size_t SymTable_leafSize(SymTable_T oSymTable, size_t uLength)
+{
+    assert(oSymTable != NULL);
+
+    if (oSymTable->iBorrowsKeys)
+        return offsetof(struct SymTableLeaf, acKey);
+    return offsetof(struct SymTableLeaf, acKey) + uLength + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes of an inner node of kind ucType. */
+
+static size_t SymTable_nodeSize(unsigned char ucType)
+{
+    switch (ucType) {
+    case NODE_4:
+        return sizeof(struct SymTableNode4);
+    case NODE_16:
+        return sizeof(struct SymTableNode16);
+    case NODE_48:
+        return sizeof(struct SymTableNode48);
+    default:
+        assert(ucType == NODE_256);
+        return sizeof(struct SymTableNode256);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the smallest kind of inner node that can hold uCount
+   children. */
+
+static unsigned char SymTable_fitType(size_t uCount)
+{
+    unsigned char ucType = NODE_4;
+
+    while (auCapacity[ucType] < uCount)
+        ucType++;
+    return ucType;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new leaf of oSymTable binding the uLength characters at
+   pcKey to pvValue, or NULL if insufficient memory is available. */
+
+static struct SymTableLeaf *SymTable_newLeaf(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, const void *pvValue)
+{
+    struct SymTableLeaf *psLeaf;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psLeaf = (struct SymTableLeaf *)SymArena_alloc(&oSymTable->sArena,
+        SymTable_leafSize(oSymTable, uLength));
+    if (psLeaf == NULL)
+        return NULL;
+
+    psLeaf->sNode.ucType = NODE_LEAF;
+    psLeaf->uLength = uLength;
+    psLeaf->pvValue = (void *)pvValue;
+    if (oSymTable->iBorrowsKeys)
+        psLeaf->pcKey = (char *)pcKey;
+    else {
+        memcpy(psLeaf->acKey, pcKey, uLength);
+        psLeaf->acKey[uLength] = '\0';
+        psLeaf->pcKey = psLeaf->acKey;
+    }
+    return psLeaf;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new inner node of oSymTable of kind ucType, with no
+   children and an empty path, or NULL if insufficient memory is
+   available. */
+
+static struct SymTableInner *SymTable_newInner(SymTable_T oSymTable,
+unsigned char ucType)
+{
+    struct SymTableInner *psInner;
+    size_t uSize;
+
+    assert(oSymTable != NULL);
+
+    uSize = SymTable_nodeSize(ucType);
+    psInner = (struct SymTableInner *)SymArena_alloc(
+        &oSymTable->sArena, uSize);
+    if (psInner == NULL)
+        return NULL;
+
+    memset(psInner, 0, uSize);
+    psInner->sNode.ucType = ucType;
+    return psInner;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Sets *ppucKeys and *pppsChildren to the arrays of bytes and children
+   of psInner, which is a SymTableNode4 or a SymTableNode16. */
+
+static void SymTable_sortedArrays(struct SymTableInner *psInner,
+unsigned char **ppucKeys, struct SymTableNode ***pppsChildren)
+{
+    assert(psInner != NULL);
+
+    if (psInner->sNode.ucType == NODE_4) {
+        *ppucKeys = ((struct SymTableNode4 *)psInner)->aucKeys;
+        *pppsChildren = ((struct SymTableNode4 *)psInner)->apsChildren;
+    } else {
+        assert(psInner->sNode.ucType == NODE_16);
+        *ppucKeys = ((struct SymTableNode16 *)psInner)->aucKeys;
+        *pppsChildren = ((struct SymTableNode16 *)psInner)->apsChildren;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a pointer to the pointer to the child of psInner for byte
+   uc, or NULL if it has none. */
+
+static struct SymTableNode **SymTable_findChild(
+struct SymTableInner *psInner, unsigned char uc)
+{
+    struct SymTableNode48 *psNode48;
+    struct SymTableNode **ppsChildren;
+    unsigned char *pucKeys;
+    size_t i;
+
+    assert(psInner != NULL);
+
+    switch (psInner->sNode.ucType) {
+    case NODE_48:
+        psNode48 = (struct SymTableNode48 *)psInner;
+        if (psNode48->aucIndex[uc] == 0)
+            return NULL;
+        return &psNode48->apsChildren[psNode48->aucIndex[uc] - 1];
+    case NODE_256:
+        ppsChildren = ((struct SymTableNode256 *)psInner)->apsChildren;
+        return ppsChildren[uc] == NULL ? NULL : &ppsChildren[uc];
+    default:
+        SymTable_sortedArrays(psInner, &pucKeys, &ppsChildren);
+        for (i = (size_t)0; i < psInner->usCount && pucKeys[i] <= uc;
+             i++)
+            if (pucKeys[i] == uc)
+                return &ppsChildren[i];
+        return NULL;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the child of psInner with the least byte that is at least
+   iByte, setting *piByte to that byte, or NULL if there is none. */
+
+static struct SymTableNode *SymTable_nextChild(
+struct SymTableInner *psInner, int iByte, int *piByte)
+{
+    struct SymTableNode48 *psNode48;
+    struct SymTableNode **ppsChildren;
+    unsigned char *pucKeys;
+    size_t i;
+
+    assert(psInner != NULL);
+    assert(piByte != NULL);
+
+    switch (psInner->sNode.ucType) {
+    case NODE_48:
+        psNode48 = (struct SymTableNode48 *)psInner;
+        for (; iByte < 256; iByte++)
+            if (psNode48->aucIndex[iByte] != 0) {
+                *piByte = iByte;
+                return psNode48->apsChildren[
+                    psNode48->aucIndex[iByte] - 1];
+            }
+        return NULL;
+    case NODE_256:
+        ppsChildren = ((struct SymTableNode256 *)psInner)->apsChildren;
+        for (; iByte < 256; iByte++)
+            if (ppsChildren[iByte] != NULL) {
+                *piByte = iByte;
+                return ppsChildren[iByte];
+            }
+        return NULL;
+    default:
+        SymTable_sortedArrays(psInner, &pucKeys, &ppsChildren);
+        for (i = (size_t)0; i < psInner->usCount; i++)
+            if (pucKeys[i] >= iByte) {
+                *piByte = pucKeys[i];
+                return ppsChildren[i];
+            }
+        return NULL;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the child of psInner with the greatest byte that is at most
+   iByte, setting *piByte to that byte, or NULL if there is none. */
+
+static struct SymTableNode *SymTable_prevChild(
+struct SymTableInner *psInner, int iByte, int *piByte)
+{
+    struct SymTableNode48 *psNode48;
+    struct SymTableNode **ppsChildren;
+    unsigned char *pucKeys;
+    size_t i;
+
+    assert(psInner != NULL);
+    assert(piByte != NULL);
+
+    switch (psInner->sNode.ucType) {
+    case NODE_48:
+        psNode48 = (struct SymTableNode48 *)psInner;
+        for (; iByte >= 0; iByte--)
+            if (psNode48->aucIndex[iByte] != 0) {
+                *piByte = iByte;
+                return psNode48->apsChildren[
+                    psNode48->aucIndex[iByte] - 1];
+            }
+        return NULL;
+    case NODE_256:
+        ppsChildren = ((struct SymTableNode256 *)psInner)->apsChildren;
+        for (; iByte >= 0; iByte--)
+            if (ppsChildren[iByte] != NULL) {
+                *piByte = iByte;
+                return ppsChildren[iByte];
+            }
+        return NULL;
+    default:
+        SymTable_sortedArrays(psInner, &pucKeys, &ppsChildren);
+        for (i = psInner->usCount; i-- > 0; )
+            if (pucKeys[i] <= iByte) {
+                *piByte = pucKeys[i];
+                return ppsChildren[i];
+            }
+        return NULL;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf with the least key in subtree psNode. */
+
+static struct SymTableLeaf *SymTable_minLeaf(
+struct SymTableNode *psNode)
+{
+    int iByte;
+
+    assert(psNode != NULL);
+
+    while (psNode->ucType != NODE_LEAF)
+        psNode = SymTable_nextChild((struct SymTableInner *)psNode, 0,
+                                    &iByte);
+    return (struct SymTableLeaf *)psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf with the greatest key in subtree psNode. */
+
+static struct SymTableLeaf *SymTable_maxLeaf(
+struct SymTableNode *psNode)
+{
+    int iByte;
+
+    assert(psNode != NULL);
+
+    while (psNode->ucType != NODE_LEAF)
+        psNode = SymTable_prevChild((struct SymTableInner *)psNode, 255,
+                                    &iByte);
+    return (struct SymTableLeaf *)psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return byte i of the compressed path of psInner, which starts at
+   depth uDepth of the keys below it. */
+
+static unsigned char SymTable_pathByte(struct SymTableInner *psInner,
+size_t i, size_t uDepth)
+{
+    struct SymTableLeaf *psLeaf;
+
+    assert(psInner != NULL);
+    assert(i < psInner->uPrefixLength);
+
+    if (i < SYMTABLE_PREFIX_BYTES)
+        return psInner->aucPrefix[i];
+    psLeaf = SymTable_minLeaf(&psInner->sNode);
+    return SymTable_byte(psLeaf->pcKey, psLeaf->uLength, uDepth + i);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of leading bytes of the compressed path of
+   psInner, which starts at depth uDepth of the keys below it, that are
+   equal to the bytes of the uLength characters at pcKey from that
+   depth. The bytes of the path that the node does not store are read
+   from the least key below it. */
+
+static size_t SymTable_matchPath(struct SymTableInner *psInner,
+size_t uDepth, const char *pcKey, size_t uLength)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t uStored;
+    size_t i;
+
+    assert(psInner != NULL);
+    assert(pcKey != NULL);
+
+    uStored = psInner->uPrefixLength < SYMTABLE_PREFIX_BYTES ?
+        psInner->uPrefixLength : SYMTABLE_PREFIX_BYTES;
+    for (i = (size_t)0; i < uStored; i++)
+        if (psInner->aucPrefix[i] !=
+            SymTable_byte(pcKey, uLength, uDepth + i))
+            return i;
+
+    if (i == psInner->uPrefixLength)
+        return i;
+    psLeaf = SymTable_minLeaf(&psInner->sNode);
+    for (; i < psInner->uPrefixLength; i++)
+        if (SymTable_byte(psLeaf->pcKey, psLeaf->uLength, uDepth + i) !=
+            SymTable_byte(pcKey, uLength, uDepth + i))
+            return i;
+    return i;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 if the bytes of the compressed path of psInner that it
+   stores are equal to the bytes of the uLength characters at pcKey
+   from depth uDepth, or 0 otherwise. A lookup checks only these, and
+   leaves the rest of the path to the comparison at the leaf. */
+
+static int SymTable_storedMatches(struct SymTableInner *psInner,
+size_t uDepth, const char *pcKey, size_t uLength)
+{
+    size_t i;
+
+    assert(psInner != NULL);
+    assert(pcKey != NULL);
+
+    for (i = (size_t)0; i < psInner->uPrefixLength &&
+         i < SYMTABLE_PREFIX_BYTES; i++)
+        if (psInner->aucPrefix[i] !=
+            SymTable_byte(pcKey, uLength, uDepth + i))
+            return 0;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 if the key of psLeaf is the uLength characters at pcKey, or
+   0 otherwise. */
+
+static int SymTable_leafMatches(const struct SymTableLeaf *psLeaf,
+const char *pcKey, size_t uLength)
+{
+    assert(psLeaf != NULL);
+    assert(pcKey != NULL);
+
+    return psLeaf->uLength == uLength && (psLeaf->pcKey == pcKey ||
+        memcmp(psLeaf->pcKey, pcKey, uLength) == 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a negative number, 0 or a positive number as the key of
+   psLeaf is less than, equal to or greater than the uLength characters
+   at pcKey. */
+
+static int SymTable_compareLeaf(const struct SymTableLeaf *psLeaf,
+const char *pcKey, size_t uLength)
+{
+    size_t uShorter;
+    int iOrder;
+
+    assert(psLeaf != NULL);
+    assert(pcKey != NULL);
+
+    uShorter = psLeaf->uLength < uLength ? psLeaf->uLength : uLength;
+    iOrder = memcmp(psLeaf->pcKey, pcKey, uShorter);
+    if (iOrder != 0 || psLeaf->uLength == uLength)
+        return iOrder;
+    return psLeaf->uLength < uLength ? -1 : 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Adds psChild to psInner, which is not full, for byte uc, which must
+   be greater than the byte of every child that psInner has if psInner
+   is a SymTableNode48 that has never lost a child. */
+
+static void SymTable_appendChild(struct SymTableInner *psInner,
+unsigned char uc, struct SymTableNode *psChild)
+{
+    struct SymTableNode48 *psNode48;
+    struct SymTableNode **ppsChildren;
+    unsigned char *pucKeys;
+    size_t i;
+
+    assert(psInner != NULL);
+    assert(psChild != NULL);
+    assert(psInner->usCount < auCapacity[psInner->sNode.ucType]);
+
+    switch (psInner->sNode.ucType) {
+    case NODE_48:
+        psNode48 = (struct SymTableNode48 *)psInner;
+        for (i = psInner->usCount; psNode48->apsChildren[i] != NULL; )
+            i = (i + 1) % 48;
+        psNode48->apsChildren[i] = psChild;
+        psNode48->aucIndex[uc] = (unsigned char)(i + 1);
+        break;
+    case NODE_256:
+        ((struct SymTableNode256 *)psInner)->apsChildren[uc] = psChild;
+        break;
+    default:
+        SymTable_sortedArrays(psInner, &pucKeys, &ppsChildren);
+        for (i = psInner->usCount; i > 0 && pucKeys[i - 1] > uc; i--) {
+            pucKeys[i] = pucKeys[i - 1];
+            ppsChildren[i] = ppsChildren[i - 1];
+        }
+        pucKeys[i] = uc;
+        ppsChildren[i] = psChild;
+        break;
+    }
+    psInner->usCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replaces inner node *ppsRef of oSymTable with a node of kind ucType
+   that has the same path and children. Returns 1 on success, or 0,
+   leaving the node unchanged, if insufficient memory is available. */
+
+static int SymTable_convert(SymTable_T oSymTable,
+struct SymTableNode **ppsRef, unsigned char ucType)
+{
+    struct SymTableInner *psOld;
+    struct SymTableInner *psNew;
+    struct SymTableNode *psChild;
+    int iByte;
+
+    assert(oSymTable != NULL);
+    assert(ppsRef != NULL);
+
+    psOld = (struct SymTableInner *)*ppsRef;
+    psNew = SymTable_newInner(oSymTable, ucType);
+    if (psNew == NULL)
+        return 0;
+
+    psNew->uPrefixLength = psOld->uPrefixLength;
+    memcpy(psNew->aucPrefix, psOld->aucPrefix, SYMTABLE_PREFIX_BYTES);
+    for (psChild = SymTable_nextChild(psOld, 0, &iByte);
+         psChild != NULL;
+         psChild = SymTable_nextChild(psOld, iByte + 1, &iByte))
+        SymTable_appendChild(psNew, (unsigned char)iByte, psChild);
+
+    *ppsRef = &psNew->sNode;
+    SymArena_release(&oSymTable->sArena, psOld,
+                     SymTable_nodeSize(psOld->sNode.ucType));
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Adds psChild to inner node *ppsRef of oSymTable for byte uc, which
+   has no child yet, first replacing the node with a larger kind if it
+   is full. Returns 1 on success, or 0, leaving the node unchanged, if
+   insufficient memory is available. */
+
+static int SymTable_addChild(SymTable_T oSymTable,
+struct SymTableNode **ppsRef, unsigned char uc,
+struct SymTableNode *psChild)
+{
+    struct SymTableInner *psInner;
+
+    assert(oSymTable != NULL);
+    assert(ppsRef != NULL);
+
+    psInner = (struct SymTableInner *)*ppsRef;
+    if (psInner->usCount == auCapacity[psInner->sNode.ucType]) {
+        if (!SymTable_convert(oSymTable, ppsRef,
+                (unsigned char)(psInner->sNode.ucType + 1)))
+            return 0;
+        psInner = (struct SymTableInner *)*ppsRef;
+    }
+
+    SymTable_appendChild(psInner, uc, psChild);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Removes the child for byte uc from inner node *ppsRef of oSymTable.
+   Replaces a node of any kind left with one child by that child,
+   prepending the node's path and the child's byte to the child's path,
+   and a node left with few children by a smaller kind if memory
+   allows. A node that could not be made smaller is tried again on each
+   later removal. */
+
+static void SymTable_removeChild(SymTable_T oSymTable,
+struct SymTableNode **ppsRef, unsigned char uc)
+{
+    struct SymTableInner *psInner;
+    struct SymTableInner *psChild;
+    struct SymTableNode *psOnly;
+    struct SymTableNode48 *psNode48;
+    struct SymTableNode **ppsChildren;
+    unsigned char aucPath[SYMTABLE_PREFIX_BYTES];
+    unsigned char *pucKeys;
+    size_t uStored;
+    size_t i;
+    int iByte;
+
+    assert(oSymTable != NULL);
+    assert(ppsRef != NULL);
+
+    psInner = (struct SymTableInner *)*ppsRef;
+    switch (psInner->sNode.ucType) {
+    case NODE_48:
+        psNode48 = (struct SymTableNode48 *)psInner;
+        psNode48->apsChildren[psNode48->aucIndex[uc] - 1] = NULL;
+        psNode48->aucIndex[uc] = 0;
+        break;
+    case NODE_256:
+        ((struct SymTableNode256 *)psInner)->apsChildren[uc] = NULL;
+        break;
+    default:
+        SymTable_sortedArrays(psInner, &pucKeys, &ppsChildren);
+        for (i = (size_t)0; pucKeys[i] != uc; i++)
+            assert(i < psInner->usCount);
+        memmove(pucKeys + i, pucKeys + i + 1,
+                psInner->usCount - i - 1);
+        memmove(ppsChildren + i, ppsChildren + i + 1,
+                (psInner->usCount - i - 1) *
+                sizeof(struct SymTableNode *));
+        break;
+    }
+    psInner->usCount--;
+
+    /* Every kind of node is replaced as soon as it is left with one
+       child, so no node ever loses its last child. */
+    assert(psInner->usCount > 0);
+    if (psInner->usCount > 1) {
+        if (psInner->usCount <= auShrinkAt[psInner->sNode.ucType])
+            (void)SymTable_convert(oSymTable, ppsRef,
+                (unsigned char)(psInner->sNode.ucType - 1));
+        return;
+    }
+
+    /* The only child takes the node's place. */
+    psOnly = SymTable_nextChild(psInner, 0, &iByte);
+    assert(psOnly != NULL);
+    if (psOnly->ucType != NODE_LEAF) {
+        psChild = (struct SymTableInner *)psOnly;
+        uStored = psInner->uPrefixLength < SYMTABLE_PREFIX_BYTES ?
+            psInner->uPrefixLength : SYMTABLE_PREFIX_BYTES;
+        memcpy(aucPath, psInner->aucPrefix, uStored);
+        if (uStored < SYMTABLE_PREFIX_BYTES)
+            aucPath[uStored++] = (unsigned char)iByte;
+        for (i = (size_t)0; uStored < SYMTABLE_PREFIX_BYTES &&
+             i < psChild->uPrefixLength; i++)
+            aucPath[uStored++] = psChild->aucPrefix[i];
+        memcpy(psChild->aucPrefix, aucPath, uStored);
+        psChild->uPrefixLength += psInner->uPrefixLength + 1;
+    }
+    *ppsRef = psOnly;
+    SymArena_release(&oSymTable->sArena, psInner,
+                     SymTable_nodeSize(psInner->sNode.ucType));
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->psRoot = NULL;
+    oSymTable->symTableLength = 0;
+    oSymTable->iBorrowsKeys = 0;
+    SymArena_init(&oSymTable->sArena);
+    oSymTable->psFirstIter = NULL;
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The tree selects children by the bytes of keys instead of hashing
+   them, so pfHash is not used. */
+
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
+
+    return SymTable_new();
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    if (!SymTable_reserve(oSymTable, uCapacity))
+    {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->iBorrowsKeys = 1;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Each binding added takes a leaf, and at most one new node of four
+   children. Replacing a full node frees the old one, whose block is
+   reused. */
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    assert(oSymTable != NULL);
+
+    if (uCapacity <= oSymTable->symTableLength)
+        return 1;
+
+    return SymArena_reserve(&oSymTable->sArena,
+        (uCapacity - oSymTable->symTableLength) *
+        (SymArena_slabBytes(SymTable_leafSize(oSymTable,
+                                              RESERVED_KEY_LENGTH)) +
+         SymArena_slabBytes(sizeof(struct SymTableNode4))));
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter, *psNextIter;
+
+    assert(oSymTable != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
+    {
+        psNextIter = psIter->psNextIter;
+        free(psIter);
+    }
+
+    /* Every node lives in the arena, so the tree need not be
+       walked. */
+    SymArena_freeAll(&oSymTable->sArena);
+    free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    return oSymTable->symTableLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf of oSymTable whose key is the uLength characters at
+   pcKey, or NULL if there is none. */
+
+static struct SymTableLeaf *SymTable_lookup(SymTable_T oSymTable,
+const char *pcKey, size_t uLength)
+{
+    struct SymTableNode *psNode;
+    struct SymTableInner *psInner;
+    struct SymTableNode **ppsChild;
+    size_t uDepth = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psNode = oSymTable->psRoot;
+    while (psNode != NULL && psNode->ucType != NODE_LEAF) {
+        psInner = (struct SymTableInner *)psNode;
+        if (!SymTable_storedMatches(psInner, uDepth, pcKey, uLength))
+            return NULL;
+        uDepth += psInner->uPrefixLength;
+
+        ppsChild = SymTable_findChild(psInner,
+            SymTable_byte(pcKey, uLength, uDepth));
+        if (ppsChild == NULL)
+            return NULL;
+        psNode = *ppsChild;
+        uDepth++;
+    }
+
+    if (psNode == NULL ||
+        !SymTable_leafMatches((struct SymTableLeaf *)psNode, pcKey,
+                              uLength))
+        return NULL;
+    return (struct SymTableLeaf *)psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Puts a new node of four children in place of node *ppsRef of
+   oSymTable, which is at depth uDepth. The new node's path is the
+   uMatch bytes of the uLength characters at pcKey from that depth,
+   which the keys below the old node share, and its children are the
+   old node and a new leaf binding pcKey to pvValue, which differ in
+   the next byte. An old inner node keeps only the part of its path
+   after that byte. Returns a pointer to the value of the new leaf, or
+   NULL, leaving the tree unchanged, if insufficient memory is
+   available. */
+
+static void **SymTable_split(SymTable_T oSymTable,
+struct SymTableNode **ppsRef, size_t uDepth, size_t uMatch,
+const char *pcKey, size_t uLength, const void *pvValue)
+{
+    struct SymTableNode *psOld;
+    struct SymTableInner *psInner;
+    struct SymTableInner *psSplit;
+    struct SymTableLeaf *psLeaf;
+    struct SymTableLeaf *psNewLeaf;
+    unsigned char ucOld;
+    size_t uRest;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(ppsRef != NULL);
+
+    psNewLeaf = SymTable_newLeaf(oSymTable, pcKey, uLength, pvValue);
+    if (psNewLeaf == NULL)
+        return NULL;
+    psSplit = SymTable_newInner(oSymTable, NODE_4);
+    if (psSplit == NULL) {
+        SymArena_release(&oSymTable->sArena, psNewLeaf,
+                         SymTable_leafSize(oSymTable, uLength));
+        return NULL;
+    }
+
+    psSplit->uPrefixLength = uMatch;
+    for (i = (size_t)0; i < uMatch && i < SYMTABLE_PREFIX_BYTES; i++)
+        psSplit->aucPrefix[i] = SymTable_byte(pcKey, uLength,
+                                              uDepth + i);
+
+    psOld = *ppsRef;
+    if (psOld->ucType == NODE_LEAF) {
+        psLeaf = (struct SymTableLeaf *)psOld;
+        ucOld = SymTable_byte(psLeaf->pcKey, psLeaf->uLength,
+                              uDepth + uMatch);
+    } else {
+        psInner = (struct SymTableInner *)psOld;
+        ucOld = SymTable_pathByte(psInner, uMatch, uDepth);
+        uRest = psInner->uPrefixLength - uMatch - 1;
+        if (psInner->uPrefixLength <= SYMTABLE_PREFIX_BYTES)
+            memmove(psInner->aucPrefix, psInner->aucPrefix + uMatch + 1,
+                    uRest);
+        else {
+            psLeaf = SymTable_minLeaf(psOld);
+            for (i = (size_t)0; i < uRest && i < SYMTABLE_PREFIX_BYTES;
+                 i++)
+                psInner->aucPrefix[i] = SymTable_byte(psLeaf->pcKey,
+                    psLeaf->uLength, uDepth + uMatch + 1 + i);
+        }
+        psInner->uPrefixLength = uRest;
+    }
+
+    SymTable_appendChild(psSplit, ucOld, psOld);
+    SymTable_appendChild(psSplit,
+        SymTable_byte(pcKey, uLength, uDepth + uMatch),
+        &psNewLeaf->sNode);
+    *ppsRef = &psSplit->sNode;
+    return &psNewLeaf->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, adding a new binding with that key and value
+   pvValue if none exists, walking the tree only once. Returns a
+   pointer to the value of the binding and sets *piAdded to 1 if it
+   was added or 0 if it already existed. Returns NULL, leaving the
+   bindings of oSymTable unchanged, if insufficient memory is
+   available. */
+
+static void **SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, const void *pvValue, int *piAdded)
+{
+    struct SymTableNode **ppsRef;
+    struct SymTableNode **ppsChild;
+    struct SymTableNode *psNode;
+    struct SymTableInner *psInner;
+    struct SymTableLeaf *psLeaf;
+    void **ppvValue;
+    size_t uDepth = 0;
+    size_t uMatch;
+    unsigned char uc;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    ppsRef = &oSymTable->psRoot;
+    for (;;) {
+        psNode = *ppsRef;
+        if (psNode == NULL) {
+            psLeaf = SymTable_newLeaf(oSymTable, pcKey, uLength,
+                                      pvValue);
+            if (psLeaf == NULL)
+                return NULL;
+            *ppsRef = &psLeaf->sNode;
+            ppvValue = &psLeaf->pvValue;
+            break;
+        }
+
+        if (psNode->ucType == NODE_LEAF) {
+            psLeaf = (struct SymTableLeaf *)psNode;
+            if (SymTable_leafMatches(psLeaf, pcKey, uLength)) {
+                *piAdded = 0;
+                return &psLeaf->pvValue;
+            }
+            /* The keys differ at the latest at the shorter one's null
+               character. */
+            for (uMatch = 0; SymTable_byte(psLeaf->pcKey,
+                     psLeaf->uLength, uDepth + uMatch) ==
+                 SymTable_byte(pcKey, uLength, uDepth + uMatch);
+                 uMatch++)
+                ;
+            ppvValue = SymTable_split(oSymTable, ppsRef, uDepth, uMatch,
+                                      pcKey, uLength, pvValue);
+            break;
+        }
+
+        psInner = (struct SymTableInner *)psNode;
+        uMatch = SymTable_matchPath(psInner, uDepth, pcKey, uLength);
+        if (uMatch < psInner->uPrefixLength) {
+            ppvValue = SymTable_split(oSymTable, ppsRef, uDepth, uMatch,
+                                      pcKey, uLength, pvValue);
+            break;
+        }
+        uDepth += psInner->uPrefixLength;
+
+        uc = SymTable_byte(pcKey, uLength, uDepth);
+        ppsChild = SymTable_findChild(psInner, uc);
+        if (ppsChild == NULL) {
+            psLeaf = SymTable_newLeaf(oSymTable, pcKey, uLength,
+                                      pvValue);
+            if (psLeaf == NULL)
+                return NULL;
+            if (!SymTable_addChild(oSymTable, ppsRef, uc,
+                                   &psLeaf->sNode)) {
+                SymArena_release(&oSymTable->sArena, psLeaf,
+                                 SymTable_leafSize(oSymTable, uLength));
+                return NULL;
+            }
+            ppvValue = &psLeaf->pvValue;
+            break;
+        }
+        ppsRef = ppsChild;
+        uDepth++;
+    }
+
+    if (ppvValue == NULL)
+        return NULL;
+    oSymTable->symTableLength++;
+    *piAdded = 1;
+    return ppvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength, pvValue,
+                              &iAdded) == NULL)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putN(oSymTable, oAtom->acName, oAtom->uLength,
+                         pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    void **ppvValue;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    ppvValue = SymTable_findOrInsert(oSymTable, pcKey, uLength, pvValue,
+                                     &iAdded);
+    if (ppvValue == NULL)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return ppvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetN(oSymTable, oAtom->acName, oAtom->uLength,
+                              pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    char *pcAdded;
+    size_t uBytes = 0;
+    size_t i;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    if (uCount == 0)
+        return 1;
+
+    /* Remembers which keys this call added, to undo them if a later
+       allocation fails. */
+    pcAdded = (char*)calloc(uCount, sizeof(char));
+    if (pcAdded == NULL)
+        return 0;
+
+    /* Carve every leaf, and every node that the leaves may need, out
+       of one block of the arena. */
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        uBytes += SymArena_slabBytes(SymTable_leafSize(oSymTable,
+                strlen(apcKeys[i]))) +
+            SymArena_slabBytes(sizeof(struct SymTableNode4));
+    }
+    if (!SymArena_reserve(&oSymTable->sArena, uBytes))
+    {
+        free(pcAdded);
+        return 0;
+    }
+
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        if (SymTable_findOrInsert(oSymTable, apcKeys[i],
+                strlen(apcKeys[i]),
+                apvValues == NULL ? NULL : apvValues[i], &iAdded)
+            == NULL)
+        {
+            while (i-- > 0)
+                if (pcAdded[i])
+                    (void)SymTable_remove(oSymTable, apcKeys[i]);
+            free(pcAdded);
+            return 0;
+        }
+        pcAdded[i] = (char)iAdded;
+    }
+
+    free(pcAdded);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes of arena slabs that a copy of subtree
+   psNode of oSymTable takes if each of its inner nodes is of the
+   smallest kind that holds its children. */
+
+static size_t SymTable_treeBytes(SymTable_T oSymTable,
+struct SymTableNode *psNode)
+{
+    struct SymTableInner *psInner;
+    struct SymTableNode *psChild;
+    size_t uBytes;
+    int iByte;
+
+    assert(oSymTable != NULL);
+    assert(psNode != NULL);
+
+    if (psNode->ucType == NODE_LEAF)
+        return SymArena_slabBytes(SymTable_leafSize(oSymTable,
+            ((struct SymTableLeaf *)psNode)->uLength));
+
+    psInner = (struct SymTableInner *)psNode;
+    uBytes = SymArena_slabBytes(SymTable_nodeSize(
+        SymTable_fitType(psInner->usCount)));
+    for (psChild = SymTable_nextChild(psInner, 0, &iByte);
+         psChild != NULL;
+         psChild = SymTable_nextChild(psInner, iByte + 1, &iByte))
+        uBytes += SymTable_treeBytes(oSymTable, psChild);
+    return uBytes;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a copy of subtree psNode allocated from the arena of oCopy,
+   with each inner node of the smallest kind that holds its children,
+   or NULL if insufficient memory is available. */
+
+static struct SymTableNode *SymTable_copyTree(SymTable_T oCopy,
+struct SymTableNode *psNode)
+{
+    struct SymTableLeaf *psLeaf;
+    struct SymTableInner *psInner;
+    struct SymTableInner *psNewInner;
+    struct SymTableNode *psChild;
+    struct SymTableNode *psNewChild;
+    int iByte;
+
+    assert(oCopy != NULL);
+    assert(psNode != NULL);
+
+    if (psNode->ucType == NODE_LEAF) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        psLeaf = SymTable_newLeaf(oCopy, psLeaf->pcKey, psLeaf->uLength,
+                                  psLeaf->pvValue);
+        return psLeaf == NULL ? NULL : &psLeaf->sNode;
+    }
+
+    psInner = (struct SymTableInner *)psNode;
+    psNewInner = SymTable_newInner(oCopy,
+                                   SymTable_fitType(psInner->usCount));
+    if (psNewInner == NULL)
+        return NULL;
+    psNewInner->uPrefixLength = psInner->uPrefixLength;
+    memcpy(psNewInner->aucPrefix, psInner->aucPrefix,
+           SYMTABLE_PREFIX_BYTES);
+
+    for (psChild = SymTable_nextChild(psInner, 0, &iByte);
+         psChild != NULL;
+         psChild = SymTable_nextChild(psInner, iByte + 1, &iByte))
+    {
+        psNewChild = SymTable_copyTree(oCopy, psChild);
+        if (psNewChild == NULL)
+            return NULL;
+        SymTable_appendChild(psNewInner, (unsigned char)iByte,
+                             psNewChild);
+    }
+    return &psNewInner->sNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The tree is copied into a new arena, with every node shrunk to fit
+   its children, and the copy then takes the place of the old one. */
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    struct SymTable sCopy;
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    sCopy.psRoot = NULL;
+    sCopy.symTableLength = oSymTable->symTableLength;
+    sCopy.iBorrowsKeys = oSymTable->iBorrowsKeys;
+    SymArena_init(&sCopy.sArena);
+    sCopy.psFirstIter = NULL;
+
+    if (oSymTable->psRoot != NULL)
+    {
+        if (!SymArena_reserve(&sCopy.sArena,
+                SymTable_treeBytes(oSymTable, oSymTable->psRoot)))
+            return 0;
+        sCopy.psRoot = SymTable_copyTree(&sCopy, oSymTable->psRoot);
+        if (sCopy.psRoot == NULL)
+        {
+            SymArena_freeAll(&sCopy.sArena);
+            return 0;
+        }
+    }
+
+    /* Point every iterator at its leaf's copy, while the old leaf can
+       still be read. */
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+    {
+        if (psIter->iState != ITER_AT && psIter->iState != ITER_PENDING)
+            continue;
+        psIter->psLeaf = SymTable_lookup(&sCopy, psIter->psLeaf->pcKey,
+                                         psIter->psLeaf->uLength);
+        assert(psIter->psLeaf != NULL);
+    }
+
+    SymArena_freeAll(&oSymTable->sArena);
+    oSymTable->sArena = sCopy.sArena;
+    oSymTable->psRoot = sCopy.psRoot;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    struct SymTableLeaf *psLeaf;
+    void *pvPrevValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psLeaf = SymTable_lookup(oSymTable, pcKey, uLength);
+    if (psLeaf == NULL)
+        return NULL;
+
+    pvPrevValue = psLeaf->pvValue;
+    psLeaf->pvValue = (void *)pvValue;
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_replaceN(oSymTable, oAtom->acName, oAtom->uLength,
+                             pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_lookup(oSymTable, pcKey, uLength) != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_containsN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    struct SymTableLeaf *psLeaf;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psLeaf = SymTable_lookup(oSymTable, pcKey, uLength);
+    if (psLeaf == NULL)
+        return NULL;
+    return psLeaf->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_getN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The lookups of a group descend the tree in step: each pass takes
+   every unfinished lookup down one node and prefetches the node that
+   it reaches, before any lookup takes the next one. */
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    struct SymTableNode *apsNode[SYMPREFETCH_GROUP];
+    size_t auDepth[SYMPREFETCH_GROUP];
+    size_t auLength[SYMPREFETCH_GROUP];
+    struct SymTableInner *psInner;
+    struct SymTableNode **ppsChild;
+    const char *pcKey;
+    size_t uStart, uGroup, i;
+    size_t uFound = 0;
+    int iMoved;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    for (uStart = 0; uStart < uCount; uStart += uGroup) {
+        uGroup = uCount - uStart < SYMPREFETCH_GROUP ?
+            uCount - uStart : SYMPREFETCH_GROUP;
+
+        for (i = 0; i < uGroup; i++) {
+            assert(apcKeys[uStart + i] != NULL);
+            auLength[i] = strlen(apcKeys[uStart + i]);
+            auDepth[i] = 0;
+            apsNode[i] = oSymTable->psRoot;
+            apvValues[uStart + i] = NULL;
+        }
+
+        do {
+            iMoved = 0;
+            for (i = 0; i < uGroup; i++) {
+                if (apsNode[i] == NULL ||
+                    apsNode[i]->ucType == NODE_LEAF)
+                    continue;
+                psInner = (struct SymTableInner *)apsNode[i];
+                pcKey = apcKeys[uStart + i];
+                apsNode[i] = NULL;
+                if (!SymTable_storedMatches(psInner, auDepth[i], pcKey,
+                                            auLength[i]))
+                    continue;
+                auDepth[i] += psInner->uPrefixLength;
+                ppsChild = SymTable_findChild(psInner,
+                    SymTable_byte(pcKey, auLength[i], auDepth[i]));
+                auDepth[i]++;
+                if (ppsChild == NULL)
+                    continue;
+                apsNode[i] = *ppsChild;
+                SYMPREFETCH(apsNode[i]);
+                iMoved = 1;
+            }
+        } while (iMoved);
+
+        for (i = 0; i < uGroup; i++)
+            if (apsNode[i] != NULL && SymTable_leafMatches(
+                    (struct SymTableLeaf *)apsNode[i],
+                    apcKeys[uStart + i], auLength[i])) {
+                apvValues[uStart + i] =
+                    ((struct SymTableLeaf *)apsNode[i])->pvValue;
+                uFound++;
+            }
+    }
+
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf with the least key in subtree psNode, at depth
+   uDepth, that is greater than the uLength characters at pcKey, or at
+   least them if iStrict is 0, or NULL if there is none. The keys of
+   the subtree agree with pcKey in their first uDepth bytes. */
+
+static struct SymTableLeaf *SymTable_ceilingLeaf(
+struct SymTableNode *psNode, size_t uDepth, const char *pcKey,
+size_t uLength, int iStrict)
+{
+    struct SymTableInner *psInner;
+    struct SymTableNode **ppsChild;
+    struct SymTableLeaf *psLeaf;
+    size_t uMatch;
+    int iOrder;
+    int iByte;
+
+    assert(psNode != NULL);
+    assert(pcKey != NULL);
+
+    if (psNode->ucType == NODE_LEAF) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        iOrder = SymTable_compareLeaf(psLeaf, pcKey, uLength);
+        return iOrder > 0 || (iOrder == 0 && !iStrict) ? psLeaf : NULL;
+    }
+
+    psInner = (struct SymTableInner *)psNode;
+    uMatch = SymTable_matchPath(psInner, uDepth, pcKey, uLength);
+    if (uMatch < psInner->uPrefixLength) {
+        if (SymTable_pathByte(psInner, uMatch, uDepth) >
+            SymTable_byte(pcKey, uLength, uDepth + uMatch))
+            return SymTable_minLeaf(psNode);
+        return NULL;
+    }
+    uDepth += psInner->uPrefixLength;
+
+    iByte = SymTable_byte(pcKey, uLength, uDepth);
+    ppsChild = SymTable_findChild(psInner, (unsigned char)iByte);
+    if (ppsChild != NULL) {
+        psLeaf = SymTable_ceilingLeaf(*ppsChild, uDepth + 1, pcKey,
+                                      uLength, iStrict);
+        if (psLeaf != NULL)
+            return psLeaf;
+    }
+
+    psNode = SymTable_nextChild(psInner, iByte + 1, &iByte);
+    return psNode == NULL ? NULL : SymTable_minLeaf(psNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf with the greatest key in subtree psNode, at depth
+   uDepth, that is at most the uLength characters at pcKey, or NULL if
+   there is none, as SymTable_ceilingLeaf does for the least. */
+
+static struct SymTableLeaf *SymTable_floorLeaf(
+struct SymTableNode *psNode, size_t uDepth, const char *pcKey,
+size_t uLength)
+{
+    struct SymTableInner *psInner;
+    struct SymTableNode **ppsChild;
+    struct SymTableLeaf *psLeaf;
+    size_t uMatch;
+    int iByte;
+
+    assert(psNode != NULL);
+    assert(pcKey != NULL);
+
+    if (psNode->ucType == NODE_LEAF) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        return SymTable_compareLeaf(psLeaf, pcKey, uLength) <= 0 ?
+            psLeaf : NULL;
+    }
+
+    psInner = (struct SymTableInner *)psNode;
+    uMatch = SymTable_matchPath(psInner, uDepth, pcKey, uLength);
+    if (uMatch < psInner->uPrefixLength) {
+        if (SymTable_pathByte(psInner, uMatch, uDepth) <
+            SymTable_byte(pcKey, uLength, uDepth + uMatch))
+            return SymTable_maxLeaf(psNode);
+        return NULL;
+    }
+    uDepth += psInner->uPrefixLength;
+
+    iByte = SymTable_byte(pcKey, uLength, uDepth);
+    ppsChild = SymTable_findChild(psInner, (unsigned char)iByte);
+    if (ppsChild != NULL) {
+        psLeaf = SymTable_floorLeaf(*ppsChild, uDepth + 1, pcKey,
+                                    uLength);
+        if (psLeaf != NULL)
+            return psLeaf;
+    }
+
+    psNode = SymTable_prevChild(psInner, iByte - 1, &iByte);
+    return psNode == NULL ? NULL : SymTable_maxLeaf(psNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves every iterator of oSymTable that is positioned at psLeaf, or
+   about to visit it, to the leaf after it, before psLeaf is
+   removed. */
+
+static void SymTable_skipLeaf(SymTable_T oSymTable,
+struct SymTableLeaf *psLeaf)
+{
+    struct SymTableIter *psIter;
+    struct SymTableLeaf *psNextLeaf = NULL;
+    int iFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(psLeaf != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+    {
+        if ((psIter->iState != ITER_AT &&
+             psIter->iState != ITER_PENDING) ||
+            psIter->psLeaf != psLeaf)
+            continue;
+        if (!iFound) {
+            psNextLeaf = SymTable_ceilingLeaf(oSymTable->psRoot, 0,
+                psLeaf->pcKey, psLeaf->uLength, 1);
+            iFound = 1;
+        }
+        psIter->iState = psNextLeaf == NULL ? ITER_DONE : ITER_PENDING;
+        psIter->psLeaf = psNextLeaf;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    struct SymTableNode **ppsRef;
+    struct SymTableNode **ppsParent = NULL;
+    struct SymTableNode *psNode;
+    struct SymTableInner *psInner;
+    struct SymTableLeaf *psLeaf;
+    size_t uDepth = 0;
+    unsigned char uc = 0;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    ppsRef = &oSymTable->psRoot;
+    for (;;) {
+        psNode = *ppsRef;
+        if (psNode == NULL)
+            return NULL;
+        if (psNode->ucType == NODE_LEAF)
+            break;
+
+        psInner = (struct SymTableInner *)psNode;
+        if (!SymTable_storedMatches(psInner, uDepth, pcKey, uLength))
+            return NULL;
+        uDepth += psInner->uPrefixLength;
+
+        ppsParent = ppsRef;
+        uc = SymTable_byte(pcKey, uLength, uDepth);
+        ppsRef = SymTable_findChild(psInner, uc);
+        if (ppsRef == NULL)
+            return NULL;
+        uDepth++;
+    }
+
+    psLeaf = (struct SymTableLeaf *)psNode;
+    if (!SymTable_leafMatches(psLeaf, pcKey, uLength))
+        return NULL;
+
+    if (oSymTable->psFirstIter != NULL)
+        SymTable_skipLeaf(oSymTable, psLeaf);
+
+    if (ppsParent == NULL)
+        oSymTable->psRoot = NULL;
+    else
+        SymTable_removeChild(oSymTable, ppsParent, uc);
+
+    pvValue = psLeaf->pvValue;
+    SymArena_release(&oSymTable->sArena, psLeaf,
+                     SymTable_leafSize(oSymTable, psLeaf->uLength));
+    oSymTable->symTableLength--;
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies pfApply, with extra parameter pvExtra, to each binding of
+   subtree psNode in ascending order of their keys. */
+
+static void SymTable_mapNode(struct SymTableNode *psNode,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra)
+{
+    struct SymTableLeaf *psLeaf;
+    struct SymTableInner *psInner;
+    struct SymTableNode *psChild;
+    int iByte;
+
+    assert(psNode != NULL);
+    assert(pfApply != NULL);
+
+    if (psNode->ucType == NODE_LEAF) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        (*pfApply)(psLeaf->pcKey, psLeaf->pvValue, pvExtra);
+        return;
+    }
+
+    psInner = (struct SymTableInner *)psNode;
+    for (psChild = SymTable_nextChild(psInner, 0, &iByte);
+         psChild != NULL;
+         psChild = SymTable_nextChild(psInner, iByte + 1, &iByte))
+        SymTable_mapNode(psChild, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Children are visited in order of their bytes, so the bindings are
+   visited in ascending order of their keys. */
+
+void SymTable_map(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    if (oSymTable->psRoot != NULL)
+        SymTable_mapNode(oSymTable->psRoot, pfApply, (void *)pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(uShard == 0);
+    assert(pfApply != NULL);
+
+    SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   of leaves uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    size_t i;
+
+    assert(psJob != NULL);
+
+    for (i = uBegin; i < uEnd; i++)
+        (*psJob->pfApply)(psJob->ppsLeaves[i]->pcKey,
+                          psJob->ppsLeaves[i]->pvValue, pvPart);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Appends the leaves of subtree psNode, in order, to ppsLeaves, at
+   index *puCount onwards, adding their number to *puCount. */
+
+static void SymTable_gatherLeaves(struct SymTableNode *psNode,
+struct SymTableLeaf **ppsLeaves, size_t *puCount)
+{
+    struct SymTableInner *psInner;
+    struct SymTableNode *psChild;
+    int iByte;
+
+    assert(psNode != NULL);
+    assert(ppsLeaves != NULL);
+    assert(puCount != NULL);
+
+    if (psNode->ucType == NODE_LEAF) {
+        ppsLeaves[(*puCount)++] = (struct SymTableLeaf *)psNode;
+        return;
+    }
+
+    psInner = (struct SymTableInner *)psNode;
+    for (psChild = SymTable_nextChild(psInner, 0, &iByte);
+         psChild != NULL;
+         psChild = SymTable_nextChild(psInner, iByte + 1, &iByte))
+        SymTable_gatherLeaves(psChild, ppsLeaves, puCount);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The leaves are first gathered into an array, so that the threads
+   can start their ranges without walking the tree. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+    size_t uLeaves = 0;
+    int iSuccess;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sJob.ppsLeaves = (struct SymTableLeaf **)malloc(
+        oSymTable->symTableLength * sizeof(struct SymTableLeaf *));
+    if (sJob.ppsLeaves == NULL && oSymTable->symTableLength > 0)
+        return 0;
+    sJob.pfApply = pfApply;
+
+    if (oSymTable->psRoot != NULL)
+        SymTable_gatherLeaves(oSymTable->psRoot, sJob.ppsLeaves,
+                              &uLeaves);
+    assert(uLeaves == oSymTable->symTableLength);
+
+    iSuccess = SymParallel_run(&sJob, uLeaves, SymTable_mapSlice,
+        uThreads, pvExtra, uPartSize, pfReduce);
+
+    free(sJob.ppsLeaves);
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of psRange to the bindings of subtree psNode,
+   at depth uDepth, whose keys are in the range. If iLow is 1, the
+   keys of the subtree agree with the low end of the range in their
+   first uDepth bytes, so some of them may be less than it; if iLow is
+   0, none is. iHigh is the same for the high end. Subtrees entirely
+   outside the range are not entered, and those entirely inside it
+   are mapped without further comparisons. */
+
+static void SymTable_mapBetween(struct SymTableRange *psRange,
+struct SymTableNode *psNode, size_t uDepth, int iLow, int iHigh)
+{
+    struct SymTableLeaf *psLeaf;
+    struct SymTableInner *psInner;
+    struct SymTableNode *psChild;
+    size_t uMatch;
+    int iFirst = 0;
+    int iLast = 255;
+    int iByte;
+
+    assert(psRange != NULL);
+    assert(psNode != NULL);
+
+    if (!iLow && !iHigh) {
+        SymTable_mapNode(psNode, psRange->pfApply, psRange->pvExtra);
+        return;
+    }
+
+    if (psNode->ucType == NODE_LEAF) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        if (iLow && SymTable_compareLeaf(psLeaf, psRange->pcLow,
+                                         psRange->uLowLength) < 0)
+            return;
+        if (iHigh && SymTable_compareLeaf(psLeaf, psRange->pcHigh,
+                                          psRange->uHighLength) > 0)
+            return;
+        (*psRange->pfApply)(psLeaf->pcKey, psLeaf->pvValue,
+                            psRange->pvExtra);
+        return;
+    }
+
+    /* A path that leaves an end of the range decides on which side
+       of that end the whole subtree lies. */
+    psInner = (struct SymTableInner *)psNode;
+    if (iLow) {
+        uMatch = SymTable_matchPath(psInner, uDepth, psRange->pcLow,
+                                    psRange->uLowLength);
+        if (uMatch < psInner->uPrefixLength) {
+            if (SymTable_pathByte(psInner, uMatch, uDepth) <
+                SymTable_byte(psRange->pcLow, psRange->uLowLength,
+                              uDepth + uMatch))
+                return;
+            iLow = 0;
+        }
+    }
+    if (iHigh) {
+        uMatch = SymTable_matchPath(psInner, uDepth, psRange->pcHigh,
+                                    psRange->uHighLength);
+        if (uMatch < psInner->uPrefixLength) {
+            if (SymTable_pathByte(psInner, uMatch, uDepth) >
+                SymTable_byte(psRange->pcHigh, psRange->uHighLength,
+                              uDepth + uMatch))
+                return;
+            iHigh = 0;
+        }
+    }
+    uDepth += psInner->uPrefixLength;
+
+    if (iLow)
+        iFirst = SymTable_byte(psRange->pcLow, psRange->uLowLength,
+                               uDepth);
+    if (iHigh)
+        iLast = SymTable_byte(psRange->pcHigh, psRange->uHighLength,
+                              uDepth);
+    for (psChild = SymTable_nextChild(psInner, iFirst, &iByte);
+         psChild != NULL && iByte <= iLast;
+         psChild = SymTable_nextChild(psInner, iByte + 1, &iByte))
+        SymTable_mapBetween(psRange, psChild, uDepth + 1,
+                            iLow && iByte == iFirst,
+                            iHigh && iByte == iLast);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapRange(SymTable_T oSymTable, const char *pcLow,
+const char *pcHigh,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableRange sRange;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    if (oSymTable->psRoot == NULL)
+        return;
+
+    sRange.pcLow = pcLow;
+    sRange.uLowLength = pcLow == NULL ? 0 : strlen(pcLow);
+    sRange.pcHigh = pcHigh;
+    sRange.uHighLength = pcHigh == NULL ? 0 : strlen(pcHigh);
+    sRange.pfApply = pfApply;
+    sRange.pvExtra = (void *)pvExtra;
+    SymTable_mapBetween(&sRange, oSymTable->psRoot, 0, pcLow != NULL,
+                        pcHigh != NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The walk follows pcPrefix down the tree, and maps the whole subtree
+   at which pcPrefix runs out, without comparing its keys. */
+
+void SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableNode *psNode;
+    struct SymTableInner *psInner;
+    struct SymTableNode **ppsChild;
+    struct SymTableLeaf *psLeaf;
+    size_t uLength;
+    size_t uDepth = 0;
+    size_t uMatch;
+
+    assert(oSymTable != NULL);
+    assert(pcPrefix != NULL);
+    assert(pfApply != NULL);
+
+    uLength = strlen(pcPrefix);
+    psNode = oSymTable->psRoot;
+    while (psNode != NULL && psNode->ucType != NODE_LEAF) {
+        psInner = (struct SymTableInner *)psNode;
+        uMatch = SymTable_matchPath(psInner, uDepth, pcPrefix, uLength);
+        if (uDepth + uMatch >= uLength) {
+            SymTable_mapNode(psNode, pfApply, (void *)pvExtra);
+            return;
+        }
+        if (uMatch < psInner->uPrefixLength)
+            return;
+        uDepth += psInner->uPrefixLength;
+
+        ppsChild = SymTable_findChild(psInner,
+            (unsigned char)pcPrefix[uDepth]);
+        if (ppsChild == NULL)
+            return;
+        psNode = *ppsChild;
+        uDepth++;
+    }
+
+    if (psNode == NULL)
+        return;
+    psLeaf = (struct SymTableLeaf *)psNode;
+    if (psLeaf->uLength >= uLength &&
+        memcmp(psLeaf->pcKey, pcPrefix, uLength) == 0)
+        (*pfApply)(psLeaf->pcKey, psLeaf->pvValue, (void *)pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_floor(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue)
+{
+    struct SymTableLeaf *psLeaf;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (oSymTable->psRoot == NULL)
+        return NULL;
+    psLeaf = SymTable_floorLeaf(oSymTable->psRoot, 0, pcKey,
+                                strlen(pcKey));
+    if (psLeaf == NULL)
+        return NULL;
+
+    if (ppvValue != NULL)
+        *ppvValue = psLeaf->pvValue;
+    return psLeaf->pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_ceiling(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue)
+{
+    struct SymTableLeaf *psLeaf;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (oSymTable->psRoot == NULL)
+        return NULL;
+    psLeaf = SymTable_ceilingLeaf(oSymTable->psRoot, 0, pcKey,
+                                  strlen(pcKey), 0);
+    if (psLeaf == NULL)
+        return NULL;
+
+    if (ppvValue != NULL)
+        *ppvValue = psLeaf->pvValue;
+    return psLeaf->pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->iState = ITER_BEFORE;
+    psIter->psLeaf = NULL;
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    struct SymTableNode *psRoot;
+
+    assert(oIter != NULL);
+
+    psRoot = oIter->oSymTable->psRoot;
+    switch (oIter->iState) {
+    case ITER_DONE:
+        return 0;
+    case ITER_BEFORE:
+        oIter->psLeaf = psRoot == NULL ? NULL :
+            SymTable_minLeaf(psRoot);
+        break;
+    case ITER_AT:
+        oIter->psLeaf = SymTable_ceilingLeaf(psRoot, 0,
+            oIter->psLeaf->pcKey, oIter->psLeaf->uLength, 1);
+        break;
+    default:
+        break;
+    }
+
+    oIter->iState = oIter->psLeaf == NULL ? ITER_DONE : ITER_AT;
+    return oIter->psLeaf != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->iState == ITER_AT);
+
+    return oIter->psLeaf->pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->iState == ITER_AT);
+
+    return oIter->psLeaf->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+
+    assert(oIter != NULL);
+
+    for (ppsLink = &oIter->oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,2119 @@
+/*--------------------------------------------------------------------*/
+/* symtableconcurrent.c                                               */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "symtable.h"
+#include "symhash.h"
+#include "symarena.h"
+#include "symepoch.h"
+#include "symparallel.h"
+#include "symprefetch.h"
+#include "symcursor.h"
+
+/* Maximum load factor of a SymTable, as a percentage of its number of
+   buckets. Once a new binding pushes the table past it, the bucket
+   array is grown. Override with -D SYMTABLE_MAX_LOAD_PERCENT. */
+#ifndef SYMTABLE_MAX_LOAD_PERCENT
+#define SYMTABLE_MAX_LOAD_PERCENT 100
+#endif
+
+/* Number of reader/writer locks that guard the buckets of a SymTable.
+   It must be a power of two, no greater than INITIAL_BUCKETS, so that
+   a bucket's lock is chosen by masking the low-order bits of its
+   index, and so that every bucket array holds a whole number of
+   stripes. Threads that work on keys in different stripes never wait
+   for each other. Override with -D SYMTABLE_LOCK_STRIPES. */
+#ifndef SYMTABLE_LOCK_STRIPES
+#define SYMTABLE_LOCK_STRIPES 64
+#endif
+
+#if SYMTABLE_LOCK_STRIPES < 1 || \
+    (SYMTABLE_LOCK_STRIPES & (SYMTABLE_LOCK_STRIPES - 1)) != 0
+#error "SYMTABLE_LOCK_STRIPES must be a power of two"
+#endif
+
+/* SymTable_get and SymTable_contains take no lock, relying on SymEpoch
+   to keep removed nodes and replaced bucket arrays alive while they
+   read. Compile with -D SYMTABLE_LOCKED_READS to make them take the
+   stripe lock for reading instead, to compare the two. */
+
+/* Number of buckets in a new SymTable. Bucket counts are always powers
+   of two, so a hash is reduced to a bucket index with a mask. */
+static const size_t INITIAL_BUCKETS = 512;
+
+/* Key length assumed for the bindings that SymTable_reserve makes room
+   for in the node arenas. */
+static const size_t RESERVED_KEY_LENGTH = 15;
+
+/* Number of removed nodes that a stripe collects before it tries to
+   release the ones that no reader can reach any more, and that it
+   collects past the ones a try leaves behind before the next try. */
+static const size_t RECLAIM_BATCH = 32;
+
+/*--------------------------------------------------------------------*/
+
+/* Each binding in a SymTable is stored as a SymTableNode in the chain
+   of its bucket. Every chain is in increasing order of the reversed
+   bits of its nodes' hash codes, and nodes with equal hash codes are
+   in the order they were added. A node and its key are a single block
+   allocated from the SymArena of the node's lock stripe. A table that
+   borrows its keys stores a pointer to the caller's key in place of
+   the key's characters. Readers follow the links and read the value
+   without a lock, so those are atomic. A removed node keeps its link
+   until no reader can reach it. */
+struct SymTableNode
+{
+    /* Full hash of the key, reduced to a bucket index when used */
+    size_t uHash;
+
+    /* Binding's Value */
+    void *_Atomic pvValue;
+
+    /* Pointer to the next SymTableNode in the chain */
+    struct SymTableNode *_Atomic psNextNode;
+
+    /* Pointer to the next removed node of the same stripe */
+    struct SymTableNode *psNextRetired;
+
+    /* SymEpoch epoch in which the node was removed */
+    size_t uRetireEpoch;
+
+    /* Length of the key, compared before its characters */
+    size_t uLength;
+
+    /* Unique String Key, stored inline, or a pointer to it */
+    char acKey[];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableBuckets is a bucket array together with its size, so that
+   a reader that loads one pointer sees both. */
+struct SymTableBuckets
+{
+    /* Number of Buckets */
+    size_t uCount;
+
+    /* Pointer to the first SymTableNode of each bucket */
+    struct SymTableNode *_Atomic apsFirstNode[];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableStripe is one lock of a SymTable together with the state
+   that the lock guards besides the buckets themselves. Since the
+   number of buckets is a multiple of the number of stripes, a binding
+   stays in the same stripe when the bucket array is resized, and so
+   can be allocated from, and counted in, its stripe alone. */
+struct SymTableStripe
+{
+    /* Lock held for writing to change the chains of the stripe's
+       buckets, or for reading to look at them consistently */
+    pthread_rwlock_t sLock;
+
+    /* Number of Bindings in the stripe's buckets, only changed while
+       the lock is held for writing but read without it */
+    atomic_size_t uLength;
+
+    /* Pool from which the stripe's SymTableNodes are allocated */
+    struct SymArena sArena;
+
+    /* Pointer to the most recently removed node that may still be
+       reachable by a reader, which links to the older ones */
+    struct SymTableNode *psRetired;
+
+    /* Number of nodes in the psRetired list */
+    size_t uRetired;
+
+    /* Number of nodes in the psRetired list at which the stripe next
+       tries to release them */
+    size_t uReclaimAt;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable is a hash table implementation of a symbol table that
+   many threads may use at once. Operations that change one binding
+   lock only the stripe of its bucket, and lookups take no lock at
+   all. Operations that affect the whole table, such as resizing the
+   bucket array, take every stripe lock for writing, in order. */
+struct SymTable
+{
+    /* Pointer to the bucket array, replaced as a whole on a resize */
+    struct SymTableBuckets *_Atomic psBuckets;
+
+    /* Number of times a resize has started or finished moving nodes
+       between bucket arrays; odd while one is in progress */
+    atomic_size_t uResizes;
+
+    /* Fewest buckets that removing bindings may shrink the table to */
+    size_t minBuckets;
+
+    /* Function that hashes keys */
+    SymTable_HashFunction pfHash;
+
+    /* 1 if the nodes point to their callers' keys instead of holding
+       copies of them */
+    int iBorrowsKeys;
+
+    /* Locks, lengths and arenas of the buckets, by stripe */
+    struct SymTableStripe asStripes[SYMTABLE_LOCK_STRIPES];
+
+    /* Lock held while using psFirstIter or the fields of any iterator,
+       taken after any stripe lock */
+    pthread_mutex_t sIterLock;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter walks the buckets of its SymTable in the reversed
+   binary order of their indices, one chain at a time. Because the
+   chains are sorted, that walk visits the nodes in increasing order of
+   their reversed hash codes whatever the number of buckets, and a
+   resize keeps the nodes in that order, so growing or shrinking the
+   table never makes the iterator skip or revisit a binding. Every
+   iterator in use is linked into its SymTable, so that removing a node
+   can move past it any iterator that was about to visit it. An
+   iterator belongs to one thread. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Node that the iterator visits next, or NULL if it visits next
+       the first node whose reversed hash code is at least uFrom */
+    struct SymTableNode *psNextNode;
+    size_t uFrom;
+
+    /* 1 if every bucket has been visited */
+    int iDone;
+
+    /* Node at which the iterator is positioned, or NULL */
+    struct SymTableNode *psCurrentNode;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Bucket array whose chains are visited */
+    struct SymTableBuckets *psBuckets;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes in a SymTableNode of oSymTable whose key
+   has length uLength. */
+
+static size_t SymTable_nodeSize(SymTable_T oSymTable, size_t uLength)
+{
+    if (oSymTable->iBorrowsKeys)
+        return offsetof(struct SymTableNode, acKey) + sizeof(char *);
+    return offsetof(struct SymTableNode, acKey) + uLength + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the key of psNode, a node of oSymTable. */
+
+static const char *SymTable_key(SymTable_T oSymTable,
+const struct SymTableNode *psNode)
+{
+    const char *pcKey;
+
+    if (!oSymTable->iBorrowsKeys)
+        return psNode->acKey;
+    memcpy(&pcKey, psNode->acKey, sizeof(pcKey));
+    return pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the node that the link *ppsLink points to. */
+
+static struct SymTableNode *SymTable_follow(
+struct SymTableNode *_Atomic *ppsLink)
+{
+    assert(ppsLink != NULL);
+
+    return atomic_load_explicit(ppsLink, memory_order_acquire);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Makes the link *ppsLink point to psNode, whose fields must already
+   be set, so that a reader that follows the link sees them. */
+
+static void SymTable_publish(struct SymTableNode *_Atomic *ppsLink,
+struct SymTableNode *psNode)
+{
+    assert(ppsLink != NULL);
+
+    atomic_store_explicit(ppsLink, psNode, memory_order_release);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of buckets needed to hold uLength bindings without
+   exceeding SYMTABLE_MAX_LOAD_PERCENT: uBuckets, doubled as many times
+   as necessary. Doubling stops early if it would make the bucket array
+   overflow size_t; the table then keeps working with longer chains. */
+
+static size_t SymTable_bucketsFor(size_t uBuckets, size_t uLength)
+{
+    const size_t MAX_BUCKETS =
+        ((size_t)-1 / sizeof(struct SymTableNode *)) / 2;
+
+    while (uLength * 100 > uBuckets * SYMTABLE_MAX_LOAD_PERCENT &&
+           uBuckets <= MAX_BUCKETS)
+        uBuckets *= 2;
+
+    return uBuckets;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new array of uBuckets empty buckets, or NULL if
+   insufficient memory is available. */
+
+static struct SymTableBuckets *SymTable_newBuckets(size_t uBuckets)
+{
+    struct SymTableBuckets *psBuckets;
+    size_t i;
+
+    psBuckets = (struct SymTableBuckets *)malloc(
+        offsetof(struct SymTableBuckets, apsFirstNode) +
+        uBuckets * sizeof(struct SymTableNode *_Atomic));
+    if (psBuckets == NULL)
+        return NULL;
+
+    psBuckets->uCount = uBuckets;
+    for (i = (size_t)0; i < uBuckets; i++)
+        atomic_init(&psBuckets->apsFirstNode[i], NULL);
+
+    return psBuckets;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the current bucket array of oSymTable. */
+
+static struct SymTableBuckets *SymTable_buckets(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return atomic_load_explicit(&oSymTable->psBuckets,
+                                memory_order_acquire);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the link to the first node of the bucket in psBuckets that
+   holds the chain of a binding whose key hashes to uHash. */
+
+static struct SymTableNode *_Atomic *SymTable_chain(
+struct SymTableBuckets *psBuckets, size_t uHash)
+{
+    assert(psBuckets != NULL);
+
+    return psBuckets->apsFirstNode + (uHash & (psBuckets->uCount - 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the stripe of oSymTable whose lock guards the bucket of a
+   binding whose key hashes to uHash. */
+
+static struct SymTableStripe *SymTable_stripe(SymTable_T oSymTable,
+size_t uHash)
+{
+    assert(oSymTable != NULL);
+
+    return oSymTable->asStripes + (uHash & (SYMTABLE_LOCK_STRIPES - 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Takes every stripe lock of oSymTable, for writing if iWrite is 1 or
+   for reading if it is 0, in order of the stripes. */
+
+static void SymTable_lockAll(SymTable_T oSymTable, int iWrite)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+    {
+        if (iWrite)
+            pthread_rwlock_wrlock(&oSymTable->asStripes[i].sLock);
+        else
+            pthread_rwlock_rdlock(&oSymTable->asStripes[i].sLock);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Releases every stripe lock of oSymTable. */
+
+static void SymTable_unlockAll(SymTable_T oSymTable)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = SYMTABLE_LOCK_STRIPES; i-- > 0; )
+        pthread_rwlock_unlock(&oSymTable->asStripes[i].sLock);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Create, initialize, and return a new and empty SymTable_T object
+   with uBuckets buckets that hashes keys with pfHash, or return NULL
+   if insufficient memory is available. */
+
+static SymTable_T SymTable_create(SymTable_HashFunction pfHash,
+size_t uBuckets)
+{
+    SymTable_T oSymTable;
+    struct SymTableBuckets *psBuckets;
+    struct SymTableStripe *psStripe;
+    size_t i;
+
+    assert(pfHash != NULL);
+    assert(SYMTABLE_LOCK_STRIPES <= INITIAL_BUCKETS);
+
+    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    if (oSymTable == NULL)
+        return NULL;
+
+    psBuckets = SymTable_newBuckets(uBuckets);
+    if (psBuckets == NULL)
+    {
+        free(oSymTable);
+        return NULL;
+    }
+
+    for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+    {
+        psStripe = oSymTable->asStripes + i;
+        if (pthread_rwlock_init(&psStripe->sLock, NULL) != 0)
+            break;
+        atomic_init(&psStripe->uLength, 0);
+        SymArena_init(&psStripe->sArena);
+        psStripe->psRetired = NULL;
+        psStripe->uRetired = 0;
+        psStripe->uReclaimAt = RECLAIM_BATCH;
+    }
+    if (i < SYMTABLE_LOCK_STRIPES ||
+        pthread_mutex_init(&oSymTable->sIterLock, NULL) != 0)
+    {
+        while (i-- > 0)
+            pthread_rwlock_destroy(&oSymTable->asStripes[i].sLock);
+        free(psBuckets);
+        free(oSymTable);
+        return NULL;
+    }
+
+    atomic_init(&oSymTable->psBuckets, psBuckets);
+    atomic_init(&oSymTable->uResizes, 0);
+    oSymTable->minBuckets = uBuckets;
+    oSymTable->pfHash = pfHash;
+    oSymTable->iBorrowsKeys = 0;
+    oSymTable->psFirstIter = NULL;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+    return SymTable_create(SymHash_default, INITIAL_BUCKETS);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
+
+    return SymTable_create(pfHash, INITIAL_BUCKETS);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_create(SymHash_default,
+        SymTable_bucketsFor(INITIAL_BUCKETS, uCapacity));
+    if (oSymTable == NULL)
+        return NULL;
+
+    if (!SymTable_reserve(oSymTable, uCapacity))
+    {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->iBorrowsKeys = 1;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* No other thread may be using oSymTable, so no lock is taken and the
+   removed nodes need not wait for readers. */
+
+void SymTable_free(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter, *psNextIter;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
+    {
+        psNextIter = psIter->psNextIter;
+        free(psIter);
+    }
+
+    /* Every node lives in an arena, so the chains need not be
+       walked. */
+    for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+    {
+        SymArena_freeAll(&oSymTable->asStripes[i].sArena);
+        pthread_rwlock_destroy(&oSymTable->asStripes[i].sLock);
+    }
+    pthread_mutex_destroy(&oSymTable->sIterLock);
+
+    free(SymTable_buckets(oSymTable));
+    free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bindings in oSymTable, summed over its stripes
+   without taking their locks. While other threads add or remove
+   bindings the sum is only approximate; it is exact if every stripe
+   lock of oSymTable is held. */
+
+static size_t SymTable_sumLengths(SymTable_T oSymTable)
+{
+    size_t uLength = 0;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+        uLength += atomic_load_explicit(
+            &oSymTable->asStripes[i].uLength, memory_order_relaxed);
+
+    return uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return SymTable_sumLengths(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 if oSymTable has grown past SYMTABLE_MAX_LOAD_PERCENT, or 0
+   otherwise, after a binding has been added to psStripe. The stripes
+   are only summed once psStripe holds more than its share of the
+   bindings, so most calls look at no other stripe. The lock of
+   psStripe must be held. */
+
+static int SymTable_overloaded(SymTable_T oSymTable,
+struct SymTableStripe *psStripe)
+{
+    size_t uShare;
+
+    assert(oSymTable != NULL);
+    assert(psStripe != NULL);
+
+    uShare = SymTable_buckets(oSymTable)->uCount /
+        SYMTABLE_LOCK_STRIPES * SYMTABLE_MAX_LOAD_PERCENT;
+    return atomic_load_explicit(&psStripe->uLength,
+                                memory_order_relaxed) * 100 > uShare &&
+        SymTable_sumLengths(oSymTable) * 100 >
+        uShare * SYMTABLE_LOCK_STRIPES;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 if oSymTable can shrink, having fallen below a quarter of
+   SYMTABLE_MAX_LOAD_PERCENT, or 0 otherwise, after a binding has been
+   removed from psStripe. As with SymTable_overloaded, the stripes are
+   only summed once psStripe holds less than its share. The lock of
+   psStripe must be held. */
+
+static int SymTable_underloaded(SymTable_T oSymTable,
+struct SymTableStripe *psStripe)
+{
+    size_t uBuckets;
+    size_t uShare;
+
+    assert(oSymTable != NULL);
+    assert(psStripe != NULL);
+
+    uBuckets = SymTable_buckets(oSymTable)->uCount;
+    uShare = uBuckets / SYMTABLE_LOCK_STRIPES *
+        SYMTABLE_MAX_LOAD_PERCENT;
+    return uBuckets > oSymTable->minBuckets &&
+        atomic_load_explicit(&psStripe->uLength,
+                             memory_order_relaxed) * 400 < uShare &&
+        SymTable_sumLengths(oSymTable) * 400 <
+        uShare * SYMTABLE_LOCK_STRIPES;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves psIter past the bucket of psBuckets whose index is uCursor,
+   so that it visits next the first node of the following bucket in
+   reversed binary order, if there is one. The stripe lock of the
+   bucket and the iterator lock must be held. */
+
+static void SymTable_skipBucket(struct SymTableIter *psIter,
+struct SymTableBuckets *psBuckets, size_t uCursor)
+{
+    assert(psIter != NULL);
+    assert(psBuckets != NULL);
+
+    uCursor = SymCursor_next(uCursor, psBuckets->uCount - 1);
+    psIter->psNextNode = NULL;
+    psIter->uFrom = SymCursor_reverseBits(uCursor);
+    psIter->iDone = uCursor == 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves psIter past psNode, a node in psBuckets, to the node that
+   follows it. The stripe lock of psNode and the iterator lock must be
+   held. */
+
+static void SymTable_skipNode(struct SymTableIter *psIter,
+struct SymTableBuckets *psBuckets, struct SymTableNode *psNode)
+{
+    struct SymTableNode *psNextNode;
+
+    assert(psIter != NULL);
+    assert(psBuckets != NULL);
+    assert(psNode != NULL);
+
+    psNextNode = SymTable_follow(&psNode->psNextNode);
+    if (psNextNode != NULL)
+        psIter->psNextNode = psNextNode;
+    else
+        SymTable_skipBucket(psIter, psBuckets,
+                            psNode->uHash & (psBuckets->uCount - 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks in the bucket of psBuckets where psIter's uFrom falls for the
+   first node whose reversed hash code is at least uFrom, and makes it
+   the next node of psIter, or moves psIter past the bucket if there
+   is none. The stripe lock of the bucket and the iterator lock must be
+   held. */
+
+static void SymTable_seek(struct SymTableIter *psIter,
+struct SymTableBuckets *psBuckets)
+{
+    struct SymTableNode *psTempNode;
+    size_t uCursor;
+
+    assert(psIter != NULL);
+    assert(psBuckets != NULL);
+
+    uCursor = SymCursor_reverseBits(psIter->uFrom) &
+        (psBuckets->uCount - 1);
+    for (psTempNode = SymTable_follow(
+             psBuckets->apsFirstNode + uCursor);
+         psTempNode != NULL;
+         psTempNode = SymTable_follow(&psTempNode->psNextNode))
+    {
+        if (SymCursor_reverseBits(psTempNode->uHash) >= psIter->uFrom)
+        {
+            psIter->psNextNode = psTempNode;
+            return;
+        }
+    }
+    SymTable_skipBucket(psIter, psBuckets, uCursor);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a hash code in the stripe of the node that psIter visits
+   next, or of the bucket in which it looks for that node. The
+   iterator lock must be held. */
+
+static size_t SymTable_iterTarget(struct SymTableIter *psIter)
+{
+    assert(psIter != NULL);
+
+    if (psIter->psNextNode != NULL)
+        return psIter->psNextNode->uHash;
+    return SymCursor_reverseBits(psIter->uFrom);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves every node of oSymTable into psNewBuckets, an array of empty
+   buckets, makes it the current bucket array, and frees the old one
+   once no reader can be using it. The old buckets are emptied in
+   reversed binary order, which yields the nodes in increasing order of
+   their reversed hash codes, and each node is pushed onto the front of
+   its new chain, which is reversed afterwards, so that every new chain
+   is sorted too and the iterators can go on from where they are. A
+   reader that meets a node while it is being moved may be led into
+   another chain and miss its key, so uResizes tells readers to check a
+   miss again. Every stripe lock of oSymTable must be held for
+   writing. */
+
+static void SymTable_relink(SymTable_T oSymTable,
+struct SymTableBuckets *psNewBuckets)
+{
+    struct SymTableBuckets *psOldBuckets;
+    struct SymTableNode *psTempNode, *psNextNode, *psReversed;
+    struct SymTableNode *_Atomic *ppsNewChain;
+    size_t uResizes;
+    size_t uCursor;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(psNewBuckets != NULL);
+    assert(psNewBuckets->uCount >= SYMTABLE_LOCK_STRIPES);
+
+    psOldBuckets = SymTable_buckets(oSymTable);
+    uResizes = atomic_load_explicit(&oSymTable->uResizes,
+                                    memory_order_relaxed);
+    atomic_store_explicit(&oSymTable->uResizes, uResizes + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    uCursor = 0;
+    do
+    {
+        while ((psTempNode = SymTable_follow(
+                    psOldBuckets->apsFirstNode + uCursor)) != NULL)
+        {
+            ppsNewChain = SymTable_chain(psNewBuckets,
+                                         psTempNode->uHash);
+            SymTable_publish(psOldBuckets->apsFirstNode + uCursor,
+                             SymTable_follow(&psTempNode->psNextNode));
+            SymTable_publish(&psTempNode->psNextNode,
+                             SymTable_follow(ppsNewChain));
+            SymTable_publish(ppsNewChain, psTempNode);
+        }
+        uCursor = SymCursor_next(uCursor, psOldBuckets->uCount - 1);
+    } while (uCursor != 0);
+
+    for (i = (size_t)0; i < psNewBuckets->uCount; i++)
+    {
+        psReversed = NULL;
+        for (psTempNode = SymTable_follow(
+                 psNewBuckets->apsFirstNode + i);
+             psTempNode != NULL;
+             psTempNode = psNextNode)
+        {
+            psNextNode = SymTable_follow(&psTempNode->psNextNode);
+            SymTable_publish(&psTempNode->psNextNode, psReversed);
+            psReversed = psTempNode;
+        }
+        SymTable_publish(psNewBuckets->apsFirstNode + i, psReversed);
+    }
+
+    atomic_store_explicit(&oSymTable->psBuckets, psNewBuckets,
+                          memory_order_release);
+    atomic_store_explicit(&oSymTable->uResizes, uResizes + 2,
+                          memory_order_release);
+
+    SymEpoch_synchronize();
+    free(psOldBuckets);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Resizes oSymTable to uNewBuckets buckets, a power of two. Every
+   stripe lock of oSymTable must be held for writing. Returns 0 for an
+   unsuccessful resize (memory allocation failed, oSymTable is
+   unchanged) or 1 for a successful resize. */
+
+static int SymTable_resize(SymTable_T oSymTable, size_t uNewBuckets)
+{
+    struct SymTableBuckets *psNewBuckets;
+
+    assert(oSymTable != NULL);
+
+    if (uNewBuckets == SymTable_buckets(oSymTable)->uCount)
+        return 1;
+
+    psNewBuckets = SymTable_newBuckets(uNewBuckets);
+    if (psNewBuckets == NULL)
+        return 0;
+
+    SymTable_relink(oSymTable, psNewBuckets);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Grows oSymTable, once no other operation is in progress, to the
+   fewest buckets that keep its load within SYMTABLE_MAX_LOAD_PERCENT.
+   Called without any lock of oSymTable held. The table is left as it
+   is if memory allocation fails. */
+
+static void SymTable_grow(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    SymTable_lockAll(oSymTable, 1);
+
+    /* Another thread may have grown the table in the meantime, in
+       which case this does nothing. */
+    (void)SymTable_resize(oSymTable,
+        SymTable_bucketsFor(SymTable_buckets(oSymTable)->uCount,
+                            SymTable_sumLengths(oSymTable)));
+
+    SymTable_unlockAll(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Shrinks oSymTable, once no other operation is in progress, if its
+   load is still below a quarter of SYMTABLE_MAX_LOAD_PERCENT, to the
+   fewest buckets (but no fewer than its minimum) that keep the load
+   below half of it. A table with iterators in use is not shrunk.
+   Called without any lock of oSymTable held. The table is left as it
+   is if memory allocation fails. */
+
+static void SymTable_shrink(SymTable_T oSymTable)
+{
+    size_t uBuckets;
+    size_t uLength;
+    int iIterating;
+
+    assert(oSymTable != NULL);
+
+    SymTable_lockAll(oSymTable, 1);
+
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    iIterating = oSymTable->psFirstIter != NULL;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    uBuckets = SymTable_buckets(oSymTable)->uCount;
+    uLength = SymTable_sumLengths(oSymTable);
+    if (!iIterating && uBuckets > oSymTable->minBuckets &&
+        uLength * 400 < uBuckets * SYMTABLE_MAX_LOAD_PERCENT)
+        (void)SymTable_resize(oSymTable,
+            SymTable_bucketsFor(oSymTable->minBuckets, uLength * 2));
+
+    SymTable_unlockAll(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for pcKey, whose length is uLength. */
+
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return (*oSymTable->pfHash)(pcKey, uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for the string of oAtom, which is the
+   one computed when it was interned if oSymTable hashes with
+   SymHash_default. */
+
+static size_t SymTable_atomHash(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (oSymTable->pfHash == SymHash_default)
+        return oAtom->uHash;
+    return SymTable_hash(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the node of the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash, or NULL if there is none.
+   The stripe lock of uHash must be held. */
+
+static struct SymTableNode *SymTable_find(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash)
+{
+    struct SymTableNode *psTempNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    for (psTempNode = SymTable_follow(
+             SymTable_chain(SymTable_buckets(oSymTable), uHash));
+         psTempNode != NULL;
+         psTempNode = SymTable_follow(&psTempNode->psNextNode))
+        if (psTempNode->uHash == uHash &&
+            psTempNode->uLength == uLength &&
+            (SymTable_key(oSymTable, psTempNode) == pcKey ||
+             !memcmp(SymTable_key(oSymTable, psTempNode), pcKey,
+                     uLength)))
+            return psTempNode;
+
+    return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the node of the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash, or NULL if there is none,
+   without taking any lock.
+   A miss that may have crossed a resize is looked up again. The
+   calling thread must be reading as SymEpoch defines it, and may use
+   the node only until it stops. */
+
+static struct SymTableNode *SymTable_lookup(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash)
+{
+    struct SymTableNode *psNode;
+    size_t uResizes;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    for (;;)
+    {
+        uResizes = atomic_load_explicit(&oSymTable->uResizes,
+                                        memory_order_acquire);
+        if (uResizes % 2 == 0)
+        {
+            psNode = SymTable_find(oSymTable, pcKey, uLength, uHash);
+            if (psNode != NULL)
+                return psNode;
+
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&oSymTable->uResizes,
+                                     memory_order_relaxed) == uResizes)
+                return NULL;
+        }
+        sched_yield();
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Adds a binding whose key is the uLength characters at pcKey, which
+   hash to uHash, and value pvValue to its chain in oSymTable, after
+   every node whose reversed hash code is at most that of uHash.
+   Returns the new node, or NULL, leaving oSymTable
+   unchanged, if insufficient memory is available. The stripe lock of
+   uHash must be held for writing. */
+
+static struct SymTableNode *SymTable_insert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue)
+{
+    struct SymTableStripe *psStripe;
+    struct SymTableNode *psNewNode;
+    struct SymTableNode *_Atomic *ppsLink;
+    size_t uReversed;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psStripe = SymTable_stripe(oSymTable, uHash);
+    psNewNode = (struct SymTableNode *)SymArena_alloc(
+        &psStripe->sArena, SymTable_nodeSize(oSymTable, uLength));
+    if (psNewNode == NULL)
+        return NULL;
+    if (oSymTable->iBorrowsKeys)
+        memcpy(psNewNode->acKey, &pcKey, sizeof(pcKey));
+    else
+    {
+        memcpy(psNewNode->acKey, pcKey, uLength);
+        psNewNode->acKey[uLength] = '\0';
+    }
+
+    uReversed = SymCursor_reverseBits(uHash);
+    for (ppsLink = SymTable_chain(SymTable_buckets(oSymTable), uHash);
+         SymTable_follow(ppsLink) != NULL &&
+         SymCursor_reverseBits(SymTable_follow(ppsLink)->uHash) <=
+         uReversed;
+         ppsLink = &SymTable_follow(ppsLink)->psNextNode)
+        ;
+    psNewNode->uHash = uHash;
+    psNewNode->uLength = uLength;
+    atomic_init(&psNewNode->pvValue, (void *)pvValue);
+    atomic_init(&psNewNode->psNextNode, SymTable_follow(ppsLink));
+    SymTable_publish(ppsLink, psNewNode);
+    atomic_fetch_add_explicit(&psStripe->uLength, 1,
+                              memory_order_relaxed);
+
+    return psNewNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Releases the removed nodes of psStripe, a stripe of oSymTable, that
+   no reader can reach any more. The lock of psStripe must be held for
+   writing. */
+
+static void SymTable_reclaim(SymTable_T oSymTable,
+struct SymTableStripe *psStripe)
+{
+    struct SymTableNode *psTempNode, *psNextRetired;
+    struct SymTableNode **ppsLink;
+    size_t uEpoch;
+
+    assert(oSymTable != NULL);
+    assert(psStripe != NULL);
+
+    uEpoch = SymEpoch_advance();
+
+    /* The list runs from the newest node to the oldest, so once one
+       node can be released, so can every node after it. */
+    for (ppsLink = &psStripe->psRetired; *ppsLink != NULL;
+         ppsLink = &(*ppsLink)->psNextRetired)
+        if ((*ppsLink)->uRetireEpoch + 2 <= uEpoch)
+            break;
+
+    for (psTempNode = *ppsLink; psTempNode != NULL;
+         psTempNode = psNextRetired)
+    {
+        psNextRetired = psTempNode->psNextRetired;
+        SymArena_release(&psStripe->sArena, psTempNode,
+            SymTable_nodeSize(oSymTable, psTempNode->uLength));
+        psStripe->uRetired--;
+    }
+    *ppsLink = NULL;
+
+    /* A reader that lags keeps the newer nodes, so wait for another
+       batch before scanning them again. */
+    psStripe->uReclaimAt = psStripe->uRetired + RECLAIM_BATCH;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Removes the binding in oSymTable whose key is the uLength characters
+   at pcKey, which hash to uHash, moving past it any iterator that was
+   about to visit it. The node is only released once no reader can
+   reach it. Returns 1 and sets *ppvValue to its value, or returns 0 if
+   there is no such binding. The stripe lock of uHash must be held for
+   writing. */
+
+static int SymTable_unlink(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t uHash, void **ppvValue)
+{
+    struct SymTableStripe *psStripe;
+    struct SymTableNode *psTempNode;
+    struct SymTableNode *_Atomic *ppsLink;
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(ppvValue != NULL);
+
+    for (ppsLink = SymTable_chain(SymTable_buckets(oSymTable), uHash);
+         (psTempNode = SymTable_follow(ppsLink)) != NULL;
+         ppsLink = &psTempNode->psNextNode)
+    {
+        if (psTempNode->uHash != uHash ||
+            psTempNode->uLength != uLength ||
+            (SymTable_key(oSymTable, psTempNode) != pcKey &&
+             memcmp(SymTable_key(oSymTable, psTempNode), pcKey,
+                    uLength)))
+            continue;
+
+        pthread_mutex_lock(&oSymTable->sIterLock);
+        for (psIter = oSymTable->psFirstIter; psIter != NULL;
+             psIter = psIter->psNextIter)
+            if (psIter->psNextNode == psTempNode)
+                SymTable_skipNode(psIter, SymTable_buckets(oSymTable),
+                                  psTempNode);
+        pthread_mutex_unlock(&oSymTable->sIterLock);
+
+        /* The node keeps its own link, so a reader standing on it can
+           still go on down the chain. */
+        SymTable_publish(ppsLink,
+                         SymTable_follow(&psTempNode->psNextNode));
+        *ppvValue = atomic_load_explicit(&psTempNode->pvValue,
+                                         memory_order_relaxed);
+
+        psStripe = SymTable_stripe(oSymTable, uHash);
+        psTempNode->uRetireEpoch = SymEpoch_current();
+        psTempNode->psNextRetired = psStripe->psRetired;
+        psStripe->psRetired = psTempNode;
+        if (++psStripe->uRetired >= psStripe->uReclaimAt)
+            SymTable_reclaim(oSymTable, psStripe);
+        atomic_fetch_sub_explicit(&psStripe->uLength, 1,
+                                  memory_order_relaxed);
+        return 1;
+    }
+
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash, adding a new binding with
+   that key and value pvValue if none exists, and then grows the table
+   if it has become too full. Returns the binding's SymTableNode and
+   sets *piAdded to 1 if it was added or 0 if it already existed.
+   Returns NULL, leaving oSymTable unchanged, if insufficient memory is
+   available. */
+
+static struct SymTableNode *SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue,
+int *piAdded)
+{
+    struct SymTableStripe *psStripe;
+    struct SymTableNode *psNode;
+    int iGrow = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    psStripe = SymTable_stripe(oSymTable, uHash);
+
+    pthread_rwlock_wrlock(&psStripe->sLock);
+    psNode = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    *piAdded = 0;
+    if (psNode == NULL)
+    {
+        psNode = SymTable_insert(oSymTable, pcKey, uLength, uHash,
+                                 pvValue);
+        *piAdded = psNode != NULL;
+        iGrow = psNode != NULL &&
+            SymTable_overloaded(oSymTable, psStripe);
+    }
+    pthread_rwlock_unlock(&psStripe->sLock);
+
+    /* Growing takes every stripe lock, so it must wait until this
+       one is released. The node does not move when the bucket array
+       is resized. */
+    if (iGrow)
+        SymTable_grow(oSymTable);
+
+    return psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength,
+            SymTable_hash(oSymTable, pcKey, uLength), pvValue, &iAdded)
+        == NULL)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, oAtom->acName, oAtom->uLength,
+            SymTable_atomHash(oSymTable, oAtom), pvValue, &iAdded)
+        == NULL)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_putOrGetN for a key that hashes to uHash.
+   The returned pointer is not guarded by any lock, so threads that
+   share the binding must coordinate their use of it themselves. */
+
+static void **SymTable_putOrGetHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue,
+int *piAdded)
+{
+    struct SymTableNode *psNode;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psNode = SymTable_findOrInsert(oSymTable, pcKey, uLength, uHash,
+                                   pvValue, &iAdded);
+    if (psNode == NULL)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return (void **)&psNode->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength), pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom), pvValue,
+        piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Every stripe lock is held for the whole call, so other threads that
+   lock a stripe see either none or all of the new bindings. */
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    char *pcAdded;
+    size_t *puHashes;
+    size_t uLength;
+    size_t i;
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    if (uCount == 0)
+        return 1;
+
+    /* Remembers which keys this call added, to undo them if a later
+       allocation fails. */
+    pcAdded = (char*)calloc(uCount, sizeof(char));
+    if (pcAdded == NULL)
+        return 0;
+    puHashes = (size_t *)malloc(uCount * sizeof(size_t));
+    if (puHashes == NULL)
+    {
+        free(pcAdded);
+        return 0;
+    }
+
+    /* Hash every key before taking the locks. */
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        puHashes[i] = SymTable_hash(oSymTable, apcKeys[i],
+                                    strlen(apcKeys[i]));
+    }
+
+    SymTable_lockAll(oSymTable, 1);
+
+    /* Size the bucket array for every binding at once, so the inserts
+       below never grow it. */
+    if (!SymTable_resize(oSymTable,
+            SymTable_bucketsFor(SymTable_buckets(oSymTable)->uCount,
+                SymTable_sumLengths(oSymTable) + uCount)))
+    {
+        SymTable_unlockAll(oSymTable);
+        free(puHashes);
+        free(pcAdded);
+        return 0;
+    }
+
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        uLength = strlen(apcKeys[i]);
+        if (SymTable_find(oSymTable, apcKeys[i], uLength, puHashes[i])
+            != NULL)
+            continue;
+
+        if (SymTable_insert(oSymTable, apcKeys[i], uLength,
+                puHashes[i], apvValues == NULL ? NULL : apvValues[i])
+            == NULL)
+        {
+            while (i-- > 0)
+                if (pcAdded[i])
+                    (void)SymTable_unlink(oSymTable, apcKeys[i],
+                        strlen(apcKeys[i]), puHashes[i], &pvValue);
+            SymTable_unlockAll(oSymTable);
+            free(puHashes);
+            free(pcAdded);
+            return 0;
+        }
+        pcAdded[i] = 1;
+    }
+
+    SymTable_unlockAll(oSymTable);
+    free(puHashes);
+    free(pcAdded);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    struct SymTableStripe *psStripe;
+    size_t uLength;
+    size_t i;
+    int iSuccess = 1;
+
+    assert(oSymTable != NULL);
+
+    SymTable_lockAll(oSymTable, 1);
+
+    if (!SymTable_resize(oSymTable, SymTable_bucketsFor(
+            SymTable_buckets(oSymTable)->uCount, uCapacity)))
+    {
+        SymTable_unlockAll(oSymTable);
+        return 0;
+    }
+    oSymTable->minBuckets =
+        SymTable_bucketsFor(oSymTable->minBuckets, uCapacity);
+
+    uLength = SymTable_sumLengths(oSymTable);
+
+    /* Assume the new bindings spread evenly over the stripes. */
+    if (uCapacity > uLength)
+    {
+        for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES && iSuccess; i++)
+        {
+            psStripe = oSymTable->asStripes + i;
+            iSuccess = SymArena_reserve(&psStripe->sArena,
+                ((uCapacity - uLength) / SYMTABLE_LOCK_STRIPES + 1) *
+                SymArena_slabBytes(
+                    SymTable_nodeSize(oSymTable, RESERVED_KEY_LENGTH)));
+        }
+    }
+
+    SymTable_unlockAll(oSymTable);
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Copies every node of oSymTable, chain by chain and in order, into
+   psCopies, an array of empty buckets shaped like the current ones,
+   allocating each copy from the arena in psNewArenas of its stripe.
+   Returns 1 on success, or 0, freeing every copy, if insufficient
+   memory is available. Every stripe lock of oSymTable must be
+   held. */
+
+static int SymTable_copyNodes(SymTable_T oSymTable,
+struct SymTableBuckets *psCopies, struct SymArena *psNewArenas)
+{
+    struct SymTableBuckets *psBuckets;
+    struct SymTableNode *psTempNode, *psNewNode;
+    struct SymTableNode *_Atomic *ppsNewLink;
+    size_t uLength, uSize;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(psCopies != NULL);
+    assert(psNewArenas != NULL);
+
+    psBuckets = SymTable_buckets(oSymTable);
+    for (i = (size_t)0; i < psBuckets->uCount; i++)
+    {
+        ppsNewLink = psCopies->apsFirstNode + i;
+        for (psTempNode = SymTable_follow(psBuckets->apsFirstNode + i);
+             psTempNode != NULL;
+             psTempNode = SymTable_follow(&psTempNode->psNextNode))
+        {
+            uLength = psTempNode->uLength;
+            uSize = SymTable_nodeSize(oSymTable, uLength);
+            psNewNode = (struct SymTableNode *)SymArena_alloc(
+                psNewArenas + (i & (SYMTABLE_LOCK_STRIPES - 1)), uSize);
+            if (psNewNode == NULL)
+            {
+                for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+                    SymArena_freeAll(psNewArenas + i);
+                return 0;
+            }
+            psNewNode->uHash = psTempNode->uHash;
+            psNewNode->uLength = uLength;
+            atomic_init(&psNewNode->pvValue,
+                atomic_load_explicit(&psTempNode->pvValue,
+                                     memory_order_relaxed));
+            atomic_init(&psNewNode->psNextNode, NULL);
+            memcpy(psNewNode->acKey, psTempNode->acKey,
+                   uSize - offsetof(struct SymTableNode, acKey));
+            atomic_init(ppsNewLink, psNewNode);
+            ppsNewLink = &psNewNode->psNextNode;
+        }
+    }
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compacting copies the nodes of every stripe into a fresh arena,
+   dropping the released blocks and unused space of the old one, and
+   then shrinks the bucket array to fit. The copies are published as a
+   whole, so readers see either the old nodes or the new ones, and the
+   old ones are freed once no reader can be using them. */
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    struct SymTableBuckets *psBuckets, *psCopies, *psNewBuckets;
+    struct SymTableNode *psTempNode, *psNewNode;
+    struct SymTableIter *psIter;
+    struct SymTableStripe *psStripe;
+    struct SymArena *psNewArenas;
+    size_t uNewBuckets;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    SymTable_lockAll(oSymTable, 1);
+
+    psBuckets = SymTable_buckets(oSymTable);
+    uNewBuckets = SymTable_bucketsFor(INITIAL_BUCKETS,
+                                      SymTable_sumLengths(oSymTable));
+    psNewArenas = (struct SymArena *)malloc(
+        SYMTABLE_LOCK_STRIPES * sizeof(struct SymArena));
+    psCopies = SymTable_newBuckets(psBuckets->uCount);
+    psNewBuckets = SymTable_newBuckets(uNewBuckets);
+    if (psNewArenas != NULL)
+        for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+            SymArena_init(psNewArenas + i);
+
+    if (psNewArenas == NULL || psCopies == NULL ||
+        psNewBuckets == NULL ||
+        !SymTable_copyNodes(oSymTable, psCopies, psNewArenas))
+    {
+        SymTable_unlockAll(oSymTable);
+        free(psNewArenas);
+        free(psCopies);
+        free(psNewBuckets);
+        return 0;
+    }
+
+    /* Walk the old and new chains side by side to move the iterators
+       onto the copies. */
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+    {
+        for (i = (size_t)0; i < psBuckets->uCount; i++)
+        {
+            for (psTempNode = SymTable_follow(
+                     psBuckets->apsFirstNode + i),
+                 psNewNode = SymTable_follow(
+                     psCopies->apsFirstNode + i);
+                 psTempNode != NULL;
+                 psTempNode = SymTable_follow(&psTempNode->psNextNode),
+                 psNewNode = SymTable_follow(&psNewNode->psNextNode))
+            {
+                if (psIter->psCurrentNode == psTempNode)
+                    psIter->psCurrentNode = psNewNode;
+                if (psIter->psNextNode == psTempNode)
+                    psIter->psNextNode = psNewNode;
+            }
+        }
+    }
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    atomic_store_explicit(&oSymTable->psBuckets, psCopies,
+                          memory_order_release);
+    SymEpoch_synchronize();
+
+    /* The old arenas hold the removed nodes too. */
+    for (i = (size_t)0; i < SYMTABLE_LOCK_STRIPES; i++)
+    {
+        psStripe = oSymTable->asStripes + i;
+        SymArena_freeAll(&psStripe->sArena);
+        psStripe->sArena = psNewArenas[i];
+        psStripe->psRetired = NULL;
+        psStripe->uRetired = 0;
+        psStripe->uReclaimAt = RECLAIM_BATCH;
+    }
+    free(psNewArenas);
+    free(psBuckets);
+
+    /* Moving the copies into fewer buckets keeps them in order, so the
+       iterators go on from where they are. */
+    if (uNewBuckets != psCopies->uCount)
+        SymTable_relink(oSymTable, psNewBuckets);
+    else
+        free(psNewBuckets);
+    oSymTable->minBuckets = uNewBuckets;
+
+    SymTable_unlockAll(oSymTable);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_replaceN for a key that hashes to
+   uHash. */
+
+static void *SymTable_replaceHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue)
+{
+    struct SymTableStripe *psStripe;
+    struct SymTableNode *psNode;
+    void *pvPrevValue = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psStripe = SymTable_stripe(oSymTable, uHash);
+
+    pthread_rwlock_wrlock(&psStripe->sLock);
+    psNode = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    if (psNode != NULL)
+        pvPrevValue = atomic_exchange_explicit(&psNode->pvValue,
+            (void *)pvValue, memory_order_acq_rel);
+    pthread_rwlock_unlock(&psStripe->sLock);
+
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_replaceHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash, without taking a lock
+   unless SYMTABLE_LOCKED_READS is defined or the calling thread cannot
+   get a SymEpoch record. Returns 1 and sets *ppvValue to its value, or
+   returns 0 if there is no such binding. */
+
+static int SymTable_read(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t uHash, void **ppvValue)
+{
+    struct SymEpochReader *psReader = NULL;
+    struct SymTableStripe *psStripe;
+    struct SymTableNode *psNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(ppvValue != NULL);
+
+    psStripe = SymTable_stripe(oSymTable, uHash);
+
+#ifndef SYMTABLE_LOCKED_READS
+    psReader = SymEpoch_enter();
+#endif
+    if (psReader != NULL)
+        psNode = SymTable_lookup(oSymTable, pcKey, uLength, uHash);
+    else
+    {
+        pthread_rwlock_rdlock(&psStripe->sLock);
+        psNode = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    }
+
+    if (psNode != NULL)
+        *ppvValue = atomic_load_explicit(&psNode->pvValue,
+                                         memory_order_acquire);
+
+    if (psReader != NULL)
+        SymEpoch_exit(psReader);
+    else
+        pthread_rwlock_unlock(&psStripe->sLock);
+
+    return psNode != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_read(oSymTable, pcKey, uLength,
+                         SymTable_hash(oSymTable, pcKey, uLength),
+                         &pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_read(oSymTable, oAtom->acName, oAtom->uLength,
+                         SymTable_atomHash(oSymTable, oAtom), &pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (!SymTable_read(oSymTable, pcKey, uLength,
+                       SymTable_hash(oSymTable, pcKey, uLength),
+                       &pvValue))
+        return NULL;
+
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (!SymTable_read(oSymTable, oAtom->acName, oAtom->uLength,
+                       SymTable_atomHash(oSymTable, oAtom), &pvValue))
+        return NULL;
+
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    size_t auHash[SYMPREFETCH_GROUP];
+    size_t auLength[SYMPREFETCH_GROUP];
+    struct SymEpochReader *psReader = NULL;
+    struct SymTableStripe *psStripe;
+    struct SymTableBuckets *psBuckets;
+    struct SymTableNode *psNode;
+    size_t uStart, uGroup, i;
+    size_t uFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    for (uStart = 0; uStart < uCount; uStart += uGroup)
+    {
+        uGroup = uCount - uStart < SYMPREFETCH_GROUP ?
+            uCount - uStart : SYMPREFETCH_GROUP;
+
+        for (i = 0; i < uGroup; i++)
+        {
+            assert(apcKeys[uStart + i] != NULL);
+            auLength[i] = strlen(apcKeys[uStart + i]);
+            auHash[i] = SymTable_hash(oSymTable, apcKeys[uStart + i],
+                                      auLength[i]);
+        }
+
+        /* Each group is read in an epoch of its own, so that a long
+           batch does not hold up a resize that waits for readers. */
+#ifndef SYMTABLE_LOCKED_READS
+        psReader = SymEpoch_enter();
+#endif
+        if (psReader != NULL)
+        {
+            /* Prefetch every bucket of the group, then the first node
+               of every chain. The bucket array may be replaced in
+               between, which only wastes a prefetch. */
+            psBuckets = SymTable_buckets(oSymTable);
+            for (i = 0; i < uGroup; i++)
+                SYMPREFETCH(SymTable_chain(psBuckets, auHash[i]));
+            for (i = 0; i < uGroup; i++)
+            {
+                psNode = SymTable_follow(
+                    SymTable_chain(psBuckets, auHash[i]));
+                if (psNode != NULL)
+                    SYMPREFETCH(psNode);
+            }
+        }
+
+        for (i = 0; i < uGroup; i++)
+        {
+            if (psReader != NULL)
+                psNode = SymTable_lookup(oSymTable, apcKeys[uStart + i],
+                                         auLength[i], auHash[i]);
+            else
+            {
+                psStripe = SymTable_stripe(oSymTable, auHash[i]);
+                pthread_rwlock_rdlock(&psStripe->sLock);
+                psNode = SymTable_find(oSymTable, apcKeys[uStart + i],
+                                       auLength[i], auHash[i]);
+            }
+
+            apvValues[uStart + i] = NULL;
+            if (psNode != NULL)
+            {
+                apvValues[uStart + i] = atomic_load_explicit(
+                    &psNode->pvValue, memory_order_acquire);
+                uFound++;
+            }
+
+            if (psReader == NULL)
+                pthread_rwlock_unlock(&psStripe->sLock);
+        }
+
+        if (psReader != NULL)
+            SymEpoch_exit(psReader);
+    }
+
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_removeN for a key that hashes to
+   uHash. */
+
+static void *SymTable_removeHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash)
+{
+    struct SymTableStripe *psStripe;
+    void *pvPrevValue = NULL;
+    int iShrink = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psStripe = SymTable_stripe(oSymTable, uHash);
+
+    pthread_rwlock_wrlock(&psStripe->sLock);
+    if (SymTable_unlink(oSymTable, pcKey, uLength, uHash,
+                        &pvPrevValue))
+        iShrink = SymTable_underloaded(oSymTable, psStripe);
+    pthread_rwlock_unlock(&psStripe->sLock);
+
+    if (iShrink)
+        SymTable_shrink(oSymTable);
+
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Every stripe lock is held for reading while the bindings are
+   visited, so pfApply sees a consistent table, and must not add or
+   remove bindings of oSymTable. */
+
+void SymTable_map(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableBuckets *psBuckets;
+    struct SymTableNode *psTempNode;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTable_lockAll(oSymTable, 0);
+
+    psBuckets = SymTable_buckets(oSymTable);
+    for (i = (size_t)0; i < psBuckets->uCount; i++)
+        for (psTempNode = SymTable_follow(psBuckets->apsFirstNode + i);
+             psTempNode != NULL;
+             psTempNode = SymTable_follow(&psTempNode->psNextNode))
+            (*pfApply)(SymTable_key(oSymTable, psTempNode),
+                atomic_load_explicit(&psTempNode->pvValue,
+                                     memory_order_relaxed),
+                (void *)pvExtra);
+
+    SymTable_unlockAll(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(uShard == 0);
+    assert(pfApply != NULL);
+
+    SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   in buckets uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    struct SymTableNode *psTempNode;
+    size_t i;
+
+    assert(psJob != NULL);
+
+    for (i = uBegin; i < uEnd; i++)
+        for (psTempNode = SymTable_follow(
+                 psJob->psBuckets->apsFirstNode + i);
+             psTempNode != NULL;
+             psTempNode = SymTable_follow(&psTempNode->psNextNode))
+            (*psJob->pfApply)(
+                SymTable_key(psJob->oSymTable, psTempNode),
+                atomic_load_explicit(&psTempNode->pvValue,
+                                     memory_order_relaxed),
+                pvPart);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* As in SymTable_map, every stripe lock is held for reading while the
+   bindings are visited. The bucket array is divided into ranges of
+   buckets, and the threads that visit them take no lock of their
+   own. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+    int iSuccess;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    SymTable_lockAll(oSymTable, 0);
+
+    sJob.oSymTable = oSymTable;
+    sJob.psBuckets = SymTable_buckets(oSymTable);
+    sJob.pfApply = pfApply;
+    iSuccess = SymParallel_run(&sJob, sJob.psBuckets->uCount,
+        SymTable_mapSlice, uThreads, pvExtra, uPartSize, pfReduce);
+
+    SymTable_unlockAll(oSymTable);
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->psNextNode = NULL;
+    psIter->uFrom = 0;
+    psIter->iDone = 0;
+    psIter->psCurrentNode = NULL;
+
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The stripe of a node or bucket does not depend on the size of the
+   bucket array, so its lock can be taken before the array is looked
+   at. Another thread that removes the node that the iterator visits
+   next may move the iterator into another stripe before that lock is
+   taken, in which case it is taken again. */
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    SymTable_T oSymTable;
+    struct SymTableBuckets *psBuckets;
+    struct SymTableStripe *psStripe;
+    size_t uTarget;
+
+    assert(oIter != NULL);
+
+    oSymTable = oIter->oSymTable;
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    uTarget = SymTable_iterTarget(oIter);
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+    for (;;)
+    {
+        psStripe = SymTable_stripe(oSymTable, uTarget);
+        pthread_rwlock_rdlock(&psStripe->sLock);
+        pthread_mutex_lock(&oSymTable->sIterLock);
+
+        if (oIter->iDone)
+            break;
+
+        uTarget = SymTable_iterTarget(oIter);
+        if (SymTable_stripe(oSymTable, uTarget) == psStripe)
+        {
+            psBuckets = SymTable_buckets(oSymTable);
+            if (oIter->psNextNode == NULL)
+                SymTable_seek(oIter, psBuckets);
+
+            if (oIter->psNextNode != NULL)
+            {
+                oIter->psCurrentNode = oIter->psNextNode;
+                SymTable_skipNode(oIter, psBuckets,
+                                  oIter->psCurrentNode);
+                pthread_mutex_unlock(&oSymTable->sIterLock);
+                pthread_rwlock_unlock(&psStripe->sLock);
+                return 1;
+            }
+            uTarget = SymTable_iterTarget(oIter);
+        }
+
+        pthread_mutex_unlock(&oSymTable->sIterLock);
+        pthread_rwlock_unlock(&psStripe->sLock);
+    }
+
+    oIter->psCurrentNode = NULL;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+    pthread_rwlock_unlock(&psStripe->sLock);
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    struct SymTableNode *psNode;
+
+    assert(oIter != NULL);
+
+    pthread_mutex_lock(&oIter->oSymTable->sIterLock);
+    psNode = oIter->psCurrentNode;
+    pthread_mutex_unlock(&oIter->oSymTable->sIterLock);
+
+    assert(psNode != NULL);
+    return SymTable_key(oIter->oSymTable, psNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    struct SymTableNode *psNode;
+
+    assert(oIter != NULL);
+
+    pthread_mutex_lock(&oIter->oSymTable->sIterLock);
+    psNode = oIter->psCurrentNode;
+    pthread_mutex_unlock(&oIter->oSymTable->sIterLock);
+
+    assert(psNode != NULL);
+    return atomic_load_explicit(&psNode->pvValue, memory_order_acquire);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+    SymTable_T oSymTable;
+
+    assert(oIter != NULL);
+
+    oSymTable = oIter->oSymTable;
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    for (ppsLink = &oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
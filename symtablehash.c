@@ -4,366 +4,1871 @@
 /*--------------------------------------------------------------------*/
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdio.h>
 #include "symtable.h"
-
-/* Valid bucket sizes for Hash implementation of SymTable. Ends with
-   value 0 to define the maximum bucket size (which precedes it). */
-static const size_t bucket_sizes[9] =
-        {509, 1021, 2039, 4093, 8191, 16381, 32749, 65521, 0};
+#include "symhash.h"
+#include "symarena.h"
+#include "symparallel.h"
+#include "symprefetch.h"
+
+/* Maximum load factor of a SymTable, as a percentage of its number of
+   buckets. Once a new binding would push the table past it, the
+   bucket array is doubled. Override with
+   -D SYMTABLE_MAX_LOAD_PERCENT. */
+#ifndef SYMTABLE_MAX_LOAD_PERCENT
+#define SYMTABLE_MAX_LOAD_PERCENT 100
+#endif
+
+/* Number of old buckets moved into the new bucket array by each
+   operation while an expansion is in progress. 0 moves every bucket
+   at once, inside the SymTable_put call that triggers the expansion.
+   Override with -D SYMTABLE_REHASH_STEP. */
+#ifndef SYMTABLE_REHASH_STEP
+#define SYMTABLE_REHASH_STEP 8
+#endif
+
+/* Largest number of bindings that a SymTable keeps without a bucket
+   array, searching its entries in order instead. A table is given a
+   bucket array once it grows past this, and gives it up again once it
+   shrinks to half of it. Override with -D SYMTABLE_LIST_MAX. */
+#ifndef SYMTABLE_LIST_MAX
+#define SYMTABLE_LIST_MAX 8
+#endif
+
+/* How a successful lookup reorders the chain that it walks, so that
+   frequently used bindings drift toward the head of their chains: 0
+   leaves it as it is, 1 moves the binding found to the head, and 2
+   swaps it with the binding before it. Entries, and so iteration
+   order, never move, and SymTable_getBatch leaves chains as they are.
+   Override with -D SYMTABLE_REORDER. */
+#ifndef SYMTABLE_REORDER
+#define SYMTABLE_REORDER 0
+#endif
+
+/* Fewest buckets that a SymTable with a bucket array has. Bucket
+   counts are always powers of two, so a hash is reduced to a bucket
+   index with a mask. */
+static const size_t INITIAL_BUCKETS = 16;
+
+/* Number of entries, and of keys of up to 15 characters, that a
+   SymTable holds inside its own structure, from 1 to 32. Override with
+   -D SYMTABLE_INLINE_COUNT. */
+#ifndef SYMTABLE_INLINE_COUNT
+#define SYMTABLE_INLINE_COUNT 8
+#endif
+
+/* Number of bytes of a key slot inside a SymTable. */
+enum {INLINE_KEY_SIZE = 16};
+
+/* Fewest entries that an entry array outside the SymTable has. */
+static const size_t INITIAL_ENTRIES = 16;
+
+/* Key length assumed for the bindings that SymTable_reserve makes room
+   for in the key arena. */
+static const size_t RESERVED_KEY_LENGTH = 15;
+
+/* Index that marks the end of a chain or an empty bucket. */
+static const size_t NO_ENTRY = (size_t)-1;
 
 /*--------------------------------------------------------------------*/
 
-/* Each binding in a Symtable is stored as a SymTableNode. SymTableNodes
-   are linked to each other to form a linked list structure. */
-struct SymTableNode
+/* Each binding in a SymTable is stored as a SymTableEntry in a dense
+   array, in the order in which the bindings were added. The entries
+   whose keys fall into the same bucket are linked into a chain by
+   their indices. Each key is copied into a key slot of the table or a
+   block of its SymArena, unless the table borrows its keys. */
+struct SymTableEntry
 {
-    /* Unique String Key */
-    const char *pcKey;
+    /* Full hash of pcKey, reduced to a bucket index when used */
+    size_t uHash;
 
     /* Binding's Value */
     void *pvValue;
 
-    /* Pointed to the next SymTableNode in linked list */
-    struct SymTableNode *psNextNode;
+    /* Index of the next SymTableEntry in the chain, or NO_ENTRY */
+    size_t uNext;
+
+    /* Unique String Key, or NULL if the binding has been removed */
+    char *pcKey;
+
+    /* Length of pcKey, compared before its characters */
+    size_t uLength;
 };
 
 /*--------------------------------------------------------------------*/
 
 /* A SymTable is a hash table implementation of a symbol table that
-   points to hash buckets containing bindings and stores the number of
-   bindings and buckets . */
+   stores its bindings in a dense array of entries, and points to hash
+   buckets holding the index of the first entry of each chain. Removed
+   bindings leave holes in the entry array until it is squeezed. While
+   a resize is in progress, the buckets of the previous bucket array
+   that have not been moved yet are kept alive alongside the new
+   one. A table of up to SYMTABLE_LIST_MAX bindings has no bucket
+   array at all, and its first entries and short keys are kept inside
+   the SymTable itself, so a small table needs no memory beyond its
+   structure. */
 struct SymTable
 {
-    /* Pointer to the first hash bucket */
-    struct SymTableNode **ppsFirstNode;
+    /* Pointer to the first hash bucket, or NULL if the table has no
+       bucket array */
+    size_t *puFirstEntry;
 
     /* Number of Bindings */
     size_t symTableLength;
 
-    /* Number of Buckets */
+    /* Number of Buckets, or 0 if the table has no bucket array */
     size_t buckets;
+
+    /* Fewest buckets that removing bindings may shrink the table to,
+       or 0 if it may give up its bucket array */
+    size_t minBuckets;
+
+    /* Pointer to the first bucket of the previous bucket array, or
+       NULL if no resize is in progress */
+    size_t *puOldFirstEntry;
+
+    /* Number of Buckets in the previous bucket array */
+    size_t oldBuckets;
+
+    /* Index of the next previous bucket to move; every previous
+       bucket below it is empty */
+    size_t migrateIndex;
+
+    /* Pointer to the first entry, in insertion order: asInlineEntries
+       until the table needs more entries than that */
+    struct SymTableEntry *psEntries;
+
+    /* Number of entries in use, including holes */
+    size_t entryCount;
+
+    /* Number of entries allocated */
+    size_t entryCapacity;
+
+    /* Function that hashes keys */
+    SymTable_HashFunction pfHash;
+
+    /* 1 if the entries point to their callers' keys instead of copies
+       of them */
+    int iBorrowsKeys;
+
+    /* Bit i is set if aacInlineKeys[i] holds a key */
+    unsigned long ulKeySlotsUsed;
+
+    /* Room for the entries of a small table */
+    struct SymTableEntry asInlineEntries[SYMTABLE_INLINE_COUNT];
+
+    /* Room for the copies of short keys */
+    char aacInlineKeys[SYMTABLE_INLINE_COUNT][INLINE_KEY_SIZE];
+
+    /* Pool from which every other copied key is allocated */
+    struct SymArena sArena;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
 };
 
 /*--------------------------------------------------------------------*/
 
-SymTable_T SymTable_new(void)
+/* A SymTableIter walks the entry array of its SymTable in order, so
+   it visits bindings in the order in which they were added, including
+   bindings added during the iteration. Every iterator in use is linked
+   into its SymTable, so that squeezing the entry array can renumber
+   the iterator's positions along with the entries. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Index of the entry at which the iterator is positioned, or
+       NO_ENTRY */
+    size_t uCurrent;
+
+    /* Index of the first entry that the iterator has not examined */
+    size_t uNext;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
 {
+    /* SymTable whose bindings are visited */
     SymTable_T oSymTable;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of buckets needed to hold uLength bindings without
+   exceeding SYMTABLE_MAX_LOAD_PERCENT: uBuckets, doubled as many times
+   as necessary. Doubling stops early if it would make the bucket array
+   overflow size_t; the table then keeps working with longer chains. */
+
+static size_t SymTable_bucketsFor(size_t uBuckets, size_t uLength)
+{
+    const size_t MAX_BUCKETS = ((size_t)-1 / sizeof(size_t)) / 2;
+
+    while (uLength * 100 > uBuckets * SYMTABLE_MAX_LOAD_PERCENT &&
+           uBuckets <= MAX_BUCKETS)
+        uBuckets *= 2;
+
+    return uBuckets;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of buckets that oSymTable needs to hold uLength
+   bindings: none if it has no bucket array and may keep them without
+   one, and otherwise no fewer than it has and than its minimum. */
+
+static size_t SymTable_bucketsNeeded(SymTable_T oSymTable,
+size_t uLength)
+{
+    size_t uBuckets;
+
+    assert(oSymTable != NULL);
+
+    if (oSymTable->buckets == 0 && oSymTable->minBuckets == 0 &&
+        uLength <= SYMTABLE_LIST_MAX)
+        return 0;
+
+    uBuckets = oSymTable->buckets > oSymTable->minBuckets ?
+        oSymTable->buckets : oSymTable->minBuckets;
+    if (uBuckets < INITIAL_BUCKETS)
+        uBuckets = INITIAL_BUCKETS;
+    return SymTable_bucketsFor(uBuckets, uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new array of uBuckets empty buckets, or NULL if
+   insufficient memory is available. */
+
+static size_t *SymTable_newBuckets(size_t uBuckets)
+{
+    size_t *puBuckets;
     size_t i;
-    struct SymTableNode **ppsFirstNode;
 
-    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
-    if (oSymTable == NULL)
+    puBuckets = (size_t *)malloc(uBuckets * sizeof(size_t));
+    if (puBuckets == NULL)
         return NULL;
 
-    ppsFirstNode = (struct SymTableNode **)malloc(
-            sizeof(struct SymTableNode *) * bucket_sizes[0]);
-    if (ppsFirstNode == NULL)
+    for (i = (size_t)0; i < uBuckets; i++)
+        puBuckets[i] = NO_ENTRY;
+
+    return puBuckets;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Grows oSymTable's entry array to hold at least uEntries entries.
+   Returns 1 on success, or 0, leaving oSymTable unchanged, if
+   insufficient memory is available. */
+
+static int SymTable_growEntries(SymTable_T oSymTable, size_t uEntries)
+{
+    struct SymTableEntry *psEntries;
+
+    assert(oSymTable != NULL);
+
+    if (uEntries <= oSymTable->entryCapacity)
+        return 1;
+
+    if (oSymTable->psEntries == oSymTable->asInlineEntries)
     {
-        free(oSymTable);
-        return NULL;
+        psEntries = (struct SymTableEntry *)malloc(
+            uEntries * sizeof(struct SymTableEntry));
+        if (psEntries == NULL)
+            return 0;
+        memcpy(psEntries, oSymTable->asInlineEntries,
+               oSymTable->entryCount * sizeof(struct SymTableEntry));
+    }
+    else
+    {
+        psEntries = (struct SymTableEntry *)realloc(
+            oSymTable->psEntries,
+            uEntries * sizeof(struct SymTableEntry));
+        if (psEntries == NULL)
+            return 0;
     }
 
-    oSymTable->ppsFirstNode = ppsFirstNode;
-    oSymTable->buckets = bucket_sizes[0];
-    oSymTable->symTableLength = 0;
+    oSymTable->psEntries = psEntries;
+    oSymTable->entryCapacity = uEntries;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Shrinks oSymTable's entry array to uEntries entries, which must be
+   at least the number in use, moving the entries back inside the table
+   if they fit. The array is left as it is if it is already inside the
+   table or if memory allocation fails. */
+
+static void SymTable_shrinkEntries(SymTable_T oSymTable,
+size_t uEntries)
+{
+    struct SymTableEntry *psEntries;
+
+    assert(oSymTable != NULL);
+    assert(uEntries >= oSymTable->entryCount);
+
+    if (oSymTable->psEntries == oSymTable->asInlineEntries)
+        return;
 
-    for (i = (size_t)0; i < oSymTable->buckets; i++)
+    if (uEntries <= SYMTABLE_INLINE_COUNT)
     {
-        *(oSymTable->ppsFirstNode + i) = NULL;
+        memcpy(oSymTable->asInlineEntries, oSymTable->psEntries,
+               oSymTable->entryCount * sizeof(struct SymTableEntry));
+        free(oSymTable->psEntries);
+        oSymTable->psEntries = oSymTable->asInlineEntries;
+        oSymTable->entryCapacity = SYMTABLE_INLINE_COUNT;
+        return;
     }
 
-    return oSymTable;
+    psEntries = (struct SymTableEntry *)realloc(oSymTable->psEntries,
+        uEntries * sizeof(struct SymTableEntry));
+    if (psEntries == NULL)
+        return;
+
+    oSymTable->psEntries = psEntries;
+    oSymTable->entryCapacity = uEntries;
 }
 
 /*--------------------------------------------------------------------*/
 
-void SymTable_free(SymTable_T oSymTable)
+/* Return a copy of the uLength characters at pcKey, followed by a null
+   character, in a free key slot of oSymTable if the copy fits in one
+   and otherwise in a block of its arena, or NULL if insufficient
+   memory is available. */
+
+static char *SymTable_copyKey(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
 {
+    char *pcKeyCopy = NULL;
     size_t i;
 
     assert(oSymTable != NULL);
+    assert(pcKey != NULL);
 
-    for (i = (size_t)0; i < oSymTable->buckets; i++) {
-        struct SymTableNode *psCurrentNode = oSymTable->ppsFirstNode[i];
-        struct SymTableNode *psNextNode;
+    if (uLength < INLINE_KEY_SIZE)
+        for (i = (size_t)0; i < SYMTABLE_INLINE_COUNT; i++)
+            if (!(oSymTable->ulKeySlotsUsed & (1UL << i))) {
+                oSymTable->ulKeySlotsUsed |= 1UL << i;
+                pcKeyCopy = oSymTable->aacInlineKeys[i];
+                break;
+            }
 
-        while (psCurrentNode != NULL) {
-            psNextNode = psCurrentNode->psNextNode;
-            free((void *)psCurrentNode->pcKey);
-            free(psCurrentNode);
-            psCurrentNode = psNextNode;
-        }
+    if (pcKeyCopy == NULL) {
+        pcKeyCopy = (char *)SymArena_alloc(&oSymTable->sArena,
+                                           uLength + 1);
+        if (pcKeyCopy == NULL)
+            return NULL;
     }
 
-    free(oSymTable->ppsFirstNode);
-    free(oSymTable);
+    memcpy(pcKeyCopy, pcKey, uLength);
+    pcKeyCopy[uLength] = '\0';
+    return pcKeyCopy;
 }
 
-
 /*--------------------------------------------------------------------*/
 
-size_t SymTable_getLength(SymTable_T oSymTable)
+/* Return 1 if pcKey is kept in a key slot of oSymTable, or 0 if it is
+   in the arena or borrowed. */
+
+static int SymTable_isInlineKey(SymTable_T oSymTable, const char *pcKey)
 {
-    return oSymTable->symTableLength;
+    assert(oSymTable != NULL);
+
+    return pcKey >= oSymTable->aacInlineKeys[0] &&
+        pcKey < oSymTable->aacInlineKeys[0] +
+        sizeof(oSymTable->aacInlineKeys);
 }
 
 /*--------------------------------------------------------------------*/
 
+/* Gives pcKey, a copy of a key of length uLength made by
+   SymTable_copyKey that is no longer used, back to its key slot or
+   arena block. */
+
+static void SymTable_releaseKey(SymTable_T oSymTable, char *pcKey,
+size_t uLength)
+{
+    size_t uSlot;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_isInlineKey(oSymTable, pcKey)) {
+        uSlot = (size_t)(pcKey - oSymTable->aacInlineKeys[0]) /
+            INLINE_KEY_SIZE;
+        oSymTable->ulKeySlotsUsed &= ~(1UL << uSlot);
+    }
+    else
+        SymArena_release(&oSymTable->sArena, pcKey, uLength + 1);
+}
+
+/*--------------------------------------------------------------------*/
 
-/* Return a hash code for pcKey that is between 0 and uBucketCount-1,
-   inclusive. */
+/* Create, initialize, and return a new and empty SymTable_T object
+   with uBuckets buckets, or no bucket array if uBuckets is 0, and room
+   for uEntries entries that hashes keys with pfHash, or return NULL if
+   insufficient memory is available. */
 
-static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
+static SymTable_T SymTable_create(SymTable_HashFunction pfHash,
+size_t uBuckets, size_t uEntries)
 {
-   const size_t HASH_MULTIPLIER = 65599;
-   size_t u;
-   size_t uHash = 0;
+    SymTable_T oSymTable;
+    size_t *puFirstEntry = NULL;
+
+    assert(pfHash != NULL);
+
+    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    if (oSymTable == NULL)
+        return NULL;
+
+    if (uBuckets != 0)
+    {
+        puFirstEntry = SymTable_newBuckets(uBuckets);
+        if (puFirstEntry == NULL)
+        {
+            free(oSymTable);
+            return NULL;
+        }
+    }
 
-   assert(pcKey != NULL);
+    oSymTable->puFirstEntry = puFirstEntry;
+    oSymTable->buckets = uBuckets;
+    oSymTable->minBuckets = uBuckets;
+    oSymTable->symTableLength = 0;
+    oSymTable->puOldFirstEntry = NULL;
+    oSymTable->oldBuckets = 0;
+    oSymTable->migrateIndex = 0;
+    oSymTable->psEntries = oSymTable->asInlineEntries;
+    oSymTable->entryCount = 0;
+    oSymTable->entryCapacity = SYMTABLE_INLINE_COUNT;
+    oSymTable->pfHash = pfHash;
+    oSymTable->iBorrowsKeys = 0;
+    oSymTable->ulKeySlotsUsed = 0;
+    SymArena_init(&oSymTable->sArena);
+    oSymTable->psFirstIter = NULL;
+
+    if (!SymTable_growEntries(oSymTable, uEntries))
+    {
+        free(puFirstEntry);
+        free(oSymTable);
+        return NULL;
+    }
 
-   for (u = 0; pcKey[u] != '\0'; u++)
-       uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
-   return uHash % uBucketCount;
+    return oSymTable;
 }
 
 /*--------------------------------------------------------------------*/
 
-/* Expands oSymTable to the next number of buckets, to a maximum of
-   65521 buckets. Returns 0 for an unsuccessful expansion (oSymTable is
-   null or memory allocation failed) or Returns 1 for successful
-   expansion. Returns 0 if maximum bucket size has been reached. */
-static int SymTable_expand(SymTable_T oSymTable)
+SymTable_T SymTable_new(void)
 {
-    struct SymTableNode **ppsNewBucketArray;
-    struct SymTableNode *psTempOldNode, *psTempNewNode, *psTempNextNode;
-    size_t *bucket_size;
-    size_t i;
-    size_t hash;
+    return SymTable_create(SymHash_default, 0, 0);
+}
 
-    assert(oSymTable != NULL);
+/*--------------------------------------------------------------------*/
 
-    bucket_size = (size_t *)&(bucket_sizes[0]);
-    while (*bucket_size != oSymTable->buckets)
-        bucket_size++;
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
 
-    bucket_size++;
+    return SymTable_create(pfHash, 0, 0);
+}
 
-    if (*bucket_size == 0)
-        return 1;
+/*--------------------------------------------------------------------*/
 
-    ppsNewBucketArray = (struct SymTableNode **)calloc(
-            *bucket_size, sizeof(struct SymTableNode *));
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    SymTable_T oSymTable;
 
-    if (ppsNewBucketArray == NULL)
-        return 0;
+    oSymTable = SymTable_create(SymHash_default,
+        uCapacity <= SYMTABLE_LIST_MAX ? 0 :
+        SymTable_bucketsFor(INITIAL_BUCKETS, uCapacity), uCapacity);
+    if (oSymTable == NULL)
+        return NULL;
 
-    for (i = (size_t)0; i < oSymTable->buckets; i++)
+    if (!SymArena_reserve(&oSymTable->sArena, uCapacity *
+            SymArena_slabBytes(RESERVED_KEY_LENGTH + 1)))
     {
-        psTempOldNode = *(oSymTable->ppsFirstNode + i);
-        while (psTempOldNode != NULL){
-            hash = SymTable_hash(psTempOldNode->pcKey, *bucket_size);
+        SymTable_free(oSymTable);
+        return NULL;
+    }
 
-            psTempNextNode = psTempOldNode->psNextNode;
+    return oSymTable;
+}
 
-            psTempNewNode = *(ppsNewBucketArray + hash);
-            *(ppsNewBucketArray + hash) = psTempOldNode;
-            (*(ppsNewBucketArray + hash))->psNextNode = psTempNewNode;
+/*--------------------------------------------------------------------*/
 
-            psTempOldNode = psTempNextNode;
-        }
-    }
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
 
-    free(oSymTable->ppsFirstNode);
-    oSymTable->ppsFirstNode = ppsNewBucketArray;
-    oSymTable->buckets = *bucket_size;
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
 
-    return 1;
+    oSymTable->iBorrowsKeys = 1;
+    return oSymTable;
 }
 
 /*--------------------------------------------------------------------*/
 
-int SymTable_put(SymTable_T oSymTable, const char *pcKey,
-const void *pvValue)
+void SymTable_free(SymTable_T oSymTable)
 {
-    struct SymTableNode *psNewNode;
-    size_t hash;
+    struct SymTableIter *psIter, *psNextIter;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
 
-    if (SymTable_contains(oSymTable, pcKey))
-        return 0;
-
-    if (oSymTable->buckets == oSymTable->symTableLength)
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
     {
-        if (!SymTable_expand(oSymTable))
-            return 0;
+        psNextIter = psIter->psNextIter;
+        free(psIter);
     }
 
-    hash = SymTable_hash(pcKey, oSymTable->buckets);
+    /* Every key lives in the arena or in the table itself, so the
+       entries need not be walked. */
+    SymArena_freeAll(&oSymTable->sArena);
 
-    psNewNode = (struct SymTableNode*)malloc(sizeof(struct SymTableNode));
-    if (psNewNode == NULL)
-        return 0;
+    if (oSymTable->psEntries != oSymTable->asInlineEntries)
+        free(oSymTable->psEntries);
+    free(oSymTable->puFirstEntry);
+    free(oSymTable->puOldFirstEntry);
+    free(oSymTable);
+}
 
-    psNewNode->pcKey = (char*)malloc(strlen(pcKey) + 1);
-    if (psNewNode->pcKey == NULL) {
-        free(psNewNode);
-        return 0;
-    }
+/*--------------------------------------------------------------------*/
 
-    strcpy((char*)psNewNode->pcKey, pcKey);
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    return oSymTable->symTableLength;
+}
 
-    psNewNode->pvValue = (void *)pvValue;
+/*--------------------------------------------------------------------*/
 
-    psNewNode->psNextNode = *(oSymTable->ppsFirstNode + hash);
-    *(oSymTable->ppsFirstNode + hash) = psNewNode;
+/* Return oSymTable's hash code for pcKey, whose length is uLength. */
 
-    oSymTable->symTableLength++;
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
 
-    return 1;
+    return (*oSymTable->pfHash)(pcKey, uLength);
 }
 
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for the string of oAtom, which is the
+   one computed when it was interned if oSymTable hashes with
+   SymHash_default. */
+
+static size_t SymTable_atomHash(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
 
+    if (oSymTable->pfHash == SymHash_default)
+        return oAtom->uHash;
+    return SymTable_hash(oSymTable, oAtom->acName, oAtom->uLength);
+}
 
 /*--------------------------------------------------------------------*/
 
-void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
-const void *pvValue)
+/* Return a pointer to the bucket in oSymTable that holds, or would
+   hold, the chain of a binding whose key hashes to uHash. While a
+   resize is in progress this is the key's previous bucket if that
+   bucket has not been moved yet, and its new bucket otherwise. */
+
+static size_t *SymTable_chain(SymTable_T oSymTable, size_t uHash)
 {
-    struct SymTableNode *psTempNode;
-    void *pvPrevValue;
-    size_t hash;
+    size_t uOldIndex;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    /* assert(pvValue != NULL); */
-
-    hash = SymTable_hash(pcKey, oSymTable->buckets);
-    psTempNode = *(oSymTable->ppsFirstNode + hash);
+    assert(oSymTable->buckets != 0);
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            pvPrevValue = psTempNode->pvValue;
-            psTempNode->pvValue = (void *)pvValue;
-            return pvPrevValue;
-        }
-        psTempNode = psTempNode->psNextNode;
+    if (oSymTable->puOldFirstEntry != NULL) {
+        uOldIndex = uHash & (oSymTable->oldBuckets - 1);
+        if (uOldIndex >= oSymTable->migrateIndex)
+            return oSymTable->puOldFirstEntry + uOldIndex;
     }
 
-    return NULL;
+    return oSymTable->puFirstEntry + (uHash & (oSymTable->buckets - 1));
 }
 
 /*--------------------------------------------------------------------*/
 
-int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+/* Moves up to uSteps buckets of oSymTable's previous bucket array into
+   the current one, or every remaining bucket if uSteps is 0. Frees the
+   previous bucket array once it is empty. Does nothing if no resize is
+   in progress. */
+
+static void SymTable_migrate(SymTable_T oSymTable, size_t uSteps)
 {
-    struct SymTableNode *psTempNode;
-    size_t hash;
+    struct SymTableEntry *psEntries;
+    size_t *puNewChain;
+    size_t uTempOld, uTempNext;
+    size_t uStepsTaken = 0;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
 
-    hash = SymTable_hash(pcKey, oSymTable->buckets);
-    psTempNode = *(oSymTable->ppsFirstNode + hash);
+    if (oSymTable->puOldFirstEntry == NULL)
+        return;
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            return 1;
+    psEntries = oSymTable->psEntries;
+    while (oSymTable->migrateIndex < oSymTable->oldBuckets &&
+           (uSteps == 0 || uStepsTaken < uSteps))
+    {
+        uTempOld = oSymTable->puOldFirstEntry[oSymTable->migrateIndex];
+        while (uTempOld != NO_ENTRY) {
+            puNewChain = oSymTable->puFirstEntry +
+                (psEntries[uTempOld].uHash & (oSymTable->buckets - 1));
+
+            uTempNext = psEntries[uTempOld].uNext;
+
+            psEntries[uTempOld].uNext = *puNewChain;
+            *puNewChain = uTempOld;
+
+            uTempOld = uTempNext;
         }
-        psTempNode = psTempNode->psNextNode;
+        oSymTable->puOldFirstEntry[oSymTable->migrateIndex] = NO_ENTRY;
+
+        oSymTable->migrateIndex++;
+        uStepsTaken++;
     }
 
-    return 0;
+    if (oSymTable->migrateIndex == oSymTable->oldBuckets) {
+        free(oSymTable->puOldFirstEntry);
+        oSymTable->puOldFirstEntry = NULL;
+        oSymTable->oldBuckets = 0;
+        oSymTable->migrateIndex = 0;
+    }
 }
 
 /*--------------------------------------------------------------------*/
 
-void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+/* Links every live entry of oSymTable, which has no bucket array,
+   into puBuckets, a new array of uBuckets empty buckets, and makes it
+   the table's bucket array. */
+
+static void SymTable_index(SymTable_T oSymTable, size_t *puBuckets,
+size_t uBuckets)
 {
-    struct SymTableNode *psTempNode;
-    size_t hash;
+    struct SymTableEntry *psEntries;
+    size_t *puChain;
+    size_t i;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
+    assert(oSymTable->buckets == 0);
+    assert(puBuckets != NULL);
+
+    psEntries = oSymTable->psEntries;
+    for (i = (size_t)0; i < oSymTable->entryCount; i++) {
+        if (psEntries[i].pcKey == NULL)
+            continue;
+        puChain = puBuckets + (psEntries[i].uHash & (uBuckets - 1));
+        psEntries[i].uNext = *puChain;
+        *puChain = i;
+    }
 
-    hash = SymTable_hash(pcKey, oSymTable->buckets);
-    psTempNode = *(oSymTable->ppsFirstNode + hash);
+    oSymTable->puFirstEntry = puBuckets;
+    oSymTable->buckets = uBuckets;
+}
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            return psTempNode->pvValue;
-        }
-        psTempNode = psTempNode->psNextNode;
+/*--------------------------------------------------------------------*/
+
+/* Starts resizing oSymTable to uNewBuckets buckets, a power of two,
+   finishing any resize that is still in progress first. The bindings
+   are moved into the new bucket array SYMTABLE_REHASH_STEP buckets at
+   a time by later operations, except that a table without a bucket
+   array is indexed at once. If uNewBuckets is 0, the bucket array is
+   given up instead. Returns 0 for an unsuccessful resize (memory
+   allocation failed, oSymTable is unchanged) or 1 for a successful
+   resize. */
+
+static int SymTable_resize(SymTable_T oSymTable, size_t uNewBuckets)
+{
+    size_t *puNewBucketArray;
+
+    assert(oSymTable != NULL);
+
+    if (uNewBuckets == oSymTable->buckets)
+        return 1;
+
+    if (uNewBuckets == 0) {
+        SymTable_migrate(oSymTable, 0);
+        free(oSymTable->puFirstEntry);
+        oSymTable->puFirstEntry = NULL;
+        oSymTable->buckets = 0;
+        return 1;
     }
 
-    return NULL;
+    puNewBucketArray = SymTable_newBuckets(uNewBuckets);
+    if (puNewBucketArray == NULL)
+        return 0;
+
+    if (oSymTable->buckets == 0) {
+        SymTable_index(oSymTable, puNewBucketArray, uNewBuckets);
+        return 1;
+    }
+
+    SymTable_migrate(oSymTable, 0);
+
+    oSymTable->puOldFirstEntry = oSymTable->puFirstEntry;
+    oSymTable->oldBuckets = oSymTable->buckets;
+    oSymTable->migrateIndex = 0;
+    oSymTable->puFirstEntry = puNewBucketArray;
+    oSymTable->buckets = uNewBuckets;
+
+    SymTable_migrate(oSymTable, SYMTABLE_REHASH_STEP);
+
+    return 1;
 }
 
 /*--------------------------------------------------------------------*/
 
-void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
-{
-    struct SymTableNode *psTempNode, *psPrevNode;
-    void *pvPrevValue;
-    size_t hash;
+/* Starts expanding oSymTable to uNewBuckets buckets, as
+   SymTable_resize does. Returns 0 for an unsuccessful expansion
+   (memory allocation failed, oSymTable is unchanged) or 1 for a
+   successful expansion. Does nothing and returns 1 if oSymTable
+   already has at least uNewBuckets buckets. */
 
+static int SymTable_expand(SymTable_T oSymTable, size_t uNewBuckets)
+{
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
 
-    hash = SymTable_hash(pcKey, oSymTable->buckets);
-    psTempNode = *(oSymTable->ppsFirstNode + hash);
+    if (uNewBuckets <= oSymTable->buckets)
+        return 1;
 
-    psPrevNode = NULL;
+    return SymTable_resize(oSymTable, uNewBuckets);
+}
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            pvPrevValue = psTempNode->pvValue;
+/*--------------------------------------------------------------------*/
 
-            if (psPrevNode == NULL) {
-                *(oSymTable->ppsFirstNode + hash)
-                    = psTempNode->psNextNode;
-            } else {
-                psPrevNode->psNextNode = psTempNode->psNextNode;
-            }
+/* Starts shrinking oSymTable if its load has fallen below a quarter of
+   SYMTABLE_MAX_LOAD_PERCENT, to the fewest buckets (but no fewer than
+   its minimum) that keep the load below half of it, or gives up its
+   bucket array if it has no minimum and holds no more than half of
+   SYMTABLE_LIST_MAX bindings. The gap between each pair of thresholds
+   keeps a table whose length hovers around one of them from resizing
+   back and forth. The table is left as it is if memory allocation
+   fails. */
 
-            free((void *)psTempNode->pcKey);
-            free(psTempNode);
+static void SymTable_shrink(SymTable_T oSymTable)
+{
+    size_t uMinBuckets;
 
-            oSymTable->symTableLength--;
-            return pvPrevValue;
-        }
-        psPrevNode = psTempNode;
-        psTempNode = psTempNode->psNextNode;
+    assert(oSymTable != NULL);
+
+    if (oSymTable->buckets == 0)
+        return;
+
+    if (oSymTable->minBuckets == 0 &&
+        oSymTable->symTableLength <= SYMTABLE_LIST_MAX / 2)
+    {
+        (void)SymTable_resize(oSymTable, 0);
+        return;
     }
 
-    return NULL;
+    uMinBuckets = oSymTable->minBuckets > INITIAL_BUCKETS ?
+        oSymTable->minBuckets : INITIAL_BUCKETS;
+    if (oSymTable->buckets <= uMinBuckets ||
+        oSymTable->symTableLength * 400 >=
+        oSymTable->buckets * SYMTABLE_MAX_LOAD_PERCENT)
+        return;
+
+    (void)SymTable_resize(oSymTable,
+        SymTable_bucketsFor(uMinBuckets,
+                            oSymTable->symTableLength * 2));
 }
 
 /*--------------------------------------------------------------------*/
 
-void SymTable_map(SymTable_T oSymTable,
-void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
-const void *pvExtra)
+/* Tells every iterator of oSymTable that the entry array is being
+   squeezed, and that the entry at index uOld, or the end of the array
+   if uOld is the number of entries in use, moves to index uNew. */
+
+static void SymTable_renumberIters(SymTable_T oSymTable, size_t uOld,
+size_t uNew)
 {
-    struct SymTableNode *psCurrentNode;
-    size_t i;
+    struct SymTableIter *psIter;
 
     assert(oSymTable != NULL);
-    assert(pfApply != NULL);
 
-    for (i = (size_t)0; i < oSymTable->buckets; i++)
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
     {
-        for (psCurrentNode = *(oSymTable->ppsFirstNode + i);
-        psCurrentNode != NULL;
-        psCurrentNode = psCurrentNode->psNextNode)
-        {
-            (*pfApply)((void*)psCurrentNode->pcKey,
-            (void *)psCurrentNode->pvValue, (void*)pvExtra);
-        }
+        if (psIter->uCurrent == uOld)
+            psIter->uCurrent = uNew;
+        if (psIter->uNext == uOld)
+            psIter->uNext = uNew;
     }
 }
 
-/*--------------------------------------------------------------------*/
\ No newline at end of file
+/*--------------------------------------------------------------------*/
+
+/* Moves the live entries of oSymTable to the front of its entry array,
+   keeping their order, and repoints the bucket or entry that links to
+   each moved entry. Walking one chain per moved entry keeps the cost
+   proportional to the number of entries rather than buckets. Then
+   gives back most of the entry array if it is far larger than the
+   table needs. */
+
+static void SymTable_squeeze(SymTable_T oSymTable)
+{
+    struct SymTableEntry *psEntries;
+    size_t *puLink;
+    size_t i, j;
+    size_t uEntries;
+
+    assert(oSymTable != NULL);
+
+    psEntries = oSymTable->psEntries;
+    for (i = (size_t)0, j = (size_t)0; i < oSymTable->entryCount; i++)
+    {
+        if (oSymTable->psFirstIter != NULL)
+            SymTable_renumberIters(oSymTable, i, j);
+        if (psEntries[i].pcKey == NULL)
+            continue;
+        if (i != j) {
+            /* The entries below i have already been moved, so the
+               chain is consistent while it is walked. */
+            if (oSymTable->buckets != 0) {
+                puLink = SymTable_chain(oSymTable, psEntries[i].uHash);
+                while (*puLink != i)
+                    puLink = &psEntries[*puLink].uNext;
+                *puLink = j;
+            }
+            psEntries[j] = psEntries[i];
+        }
+        j++;
+    }
+    if (oSymTable->psFirstIter != NULL)
+        SymTable_renumberIters(oSymTable, i, j);
+    oSymTable->entryCount = j;
+
+    uEntries = 2 * oSymTable->symTableLength;
+    if (uEntries < INITIAL_ENTRIES)
+        uEntries = INITIAL_ENTRIES;
+    if (oSymTable->symTableLength <= SYMTABLE_INLINE_COUNT / 2)
+        SymTable_shrinkEntries(oSymTable, SYMTABLE_INLINE_COUNT);
+    else if (oSymTable->entryCapacity > 2 * uEntries)
+        SymTable_shrinkEntries(oSymTable, uEntries);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves the entry of oSymTable that *puLink links to toward the head
+   of its chain, which *puHead links to, as SYMTABLE_REORDER says.
+   puPrevLink points to the link to the entry before it, or is NULL if
+   it is at the head. */
+
+static void SymTable_promote(SymTable_T oSymTable, size_t *puHead,
+size_t *puPrevLink, size_t *puLink)
+{
+    struct SymTableEntry *psEntries;
+    size_t uIndex;
+
+    assert(oSymTable != NULL);
+    assert(puHead != NULL);
+    assert(puLink != NULL);
+
+    if (SYMTABLE_REORDER == 0 || puPrevLink == NULL)
+        return;
+
+    psEntries = oSymTable->psEntries;
+    uIndex = *puLink;
+    *puLink = psEntries[uIndex].uNext;
+    if (SYMTABLE_REORDER == 1) {
+        psEntries[uIndex].uNext = *puHead;
+        *puHead = uIndex;
+    } else {
+        psEntries[uIndex].uNext = *puPrevLink;
+        *puPrevLink = uIndex;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the entry in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash, or NO_ENTRY if there is
+   none. A table without a bucket array compares the hash of each of
+   its entries in turn. Otherwise the entry found is moved toward the
+   head of its chain as SYMTABLE_REORDER says. */
+
+static size_t SymTable_find(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t uHash)
+{
+    struct SymTableEntry *psEntries;
+    size_t *puHead;
+    size_t *puLink;
+    size_t *puPrevLink = NULL;
+    size_t uTemp;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psEntries = oSymTable->psEntries;
+    if (oSymTable->buckets == 0) {
+        for (uTemp = (size_t)0; uTemp < oSymTable->entryCount; uTemp++)
+            if (psEntries[uTemp].uHash == uHash &&
+                psEntries[uTemp].uLength == uLength &&
+                psEntries[uTemp].pcKey != NULL &&
+                (psEntries[uTemp].pcKey == pcKey ||
+                 !memcmp(psEntries[uTemp].pcKey, pcKey, uLength)))
+                return uTemp;
+        return NO_ENTRY;
+    }
+
+    puHead = SymTable_chain(oSymTable, uHash);
+    for (puLink = puHead; *puLink != NO_ENTRY;
+         puLink = &psEntries[uTemp].uNext) {
+        uTemp = *puLink;
+        if (psEntries[uTemp].uHash == uHash &&
+            psEntries[uTemp].uLength == uLength &&
+            (psEntries[uTemp].pcKey == pcKey ||
+             !memcmp(psEntries[uTemp].pcKey, pcKey, uLength))) {
+            SymTable_promote(oSymTable, puHead, puPrevLink, puLink);
+            return uTemp;
+        }
+        puPrevLink = puLink;
+    }
+
+    return NO_ENTRY;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to hash, appending a new binding with
+   that key and value pvValue if none exists, walking its chain only
+   once. Returns the index of the binding's SymTableEntry and sets
+   *piAdded to 1 if it was added or 0 if it already existed. Returns
+   NO_ENTRY, leaving the bindings of oSymTable unchanged, if
+   insufficient memory is available. */
+
+static size_t SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t hash, const void *pvValue,
+int *piAdded)
+{
+    struct SymTableEntry *psEntry;
+    size_t *puChain;
+    size_t uIndex;
+    char *pcKeyCopy;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    SymTable_migrate(oSymTable, SYMTABLE_REHASH_STEP);
+
+    uIndex = SymTable_find(oSymTable, pcKey, uLength, hash);
+    if (uIndex != NO_ENTRY) {
+        *piAdded = 0;
+        return uIndex;
+    }
+
+    if (!SymTable_expand(oSymTable,
+            SymTable_bucketsNeeded(oSymTable,
+                                   oSymTable->symTableLength + 1)))
+        return NO_ENTRY;
+
+    /* Reclaim the holes left by removed bindings instead of growing
+       the entry array, if they make up a good part of it. */
+    if (oSymTable->entryCount == oSymTable->entryCapacity)
+    {
+        if (oSymTable->entryCount - oSymTable->symTableLength >
+            oSymTable->entryCount / 4)
+            SymTable_squeeze(oSymTable);
+        else if (!SymTable_growEntries(oSymTable,
+                     oSymTable->entryCapacity < INITIAL_ENTRIES / 2 ?
+                     INITIAL_ENTRIES : 2 * oSymTable->entryCapacity))
+            return NO_ENTRY;
+    }
+
+    if (oSymTable->iBorrowsKeys)
+        pcKeyCopy = (char *)pcKey;
+    else
+    {
+        pcKeyCopy = SymTable_copyKey(oSymTable, pcKey, uLength);
+        if (pcKeyCopy == NULL)
+            return NO_ENTRY;
+    }
+
+    uIndex = oSymTable->entryCount;
+    psEntry = oSymTable->psEntries + uIndex;
+    psEntry->uHash = hash;
+    psEntry->pvValue = (void *)pvValue;
+    psEntry->pcKey = pcKeyCopy;
+    psEntry->uLength = uLength;
+
+    psEntry->uNext = NO_ENTRY;
+    if (oSymTable->buckets != 0) {
+        puChain = SymTable_chain(oSymTable, hash);
+        psEntry->uNext = *puChain;
+        *puChain = uIndex;
+    }
+
+    oSymTable->entryCount++;
+    oSymTable->symTableLength++;
+
+    *piAdded = 1;
+    return uIndex;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength,
+            SymTable_hash(oSymTable, pcKey, uLength), pvValue, &iAdded)
+        == NO_ENTRY)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, oAtom->acName, oAtom->uLength,
+            SymTable_atomHash(oSymTable, oAtom), pvValue, &iAdded)
+        == NO_ENTRY)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_putOrGetN for a key that hashes to
+   hash. */
+
+static void **SymTable_putOrGetHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t hash, const void *pvValue,
+int *piAdded)
+{
+    size_t uIndex;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    uIndex = SymTable_findOrInsert(oSymTable, pcKey, uLength, hash,
+                                   pvValue, &iAdded);
+    if (uIndex == NO_ENTRY)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return &oSymTable->psEntries[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength), pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom), pvValue,
+        piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    char *pcAdded;
+    size_t uKeyBytes = 0;
+    size_t uLength;
+    size_t i;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    if (uCount == 0)
+        return 1;
+
+    /* Remembers which keys this call added, to undo them if a later
+       allocation fails. */
+    pcAdded = (char*)calloc(uCount, sizeof(char));
+    if (pcAdded == NULL)
+        return 0;
+
+    /* Size the bucket array for every binding at once and rehash into
+       it immediately, and make room for every entry, so the inserts
+       below never grow either one. */
+    if (!SymTable_expand(oSymTable, SymTable_bucketsNeeded(oSymTable,
+            oSymTable->symTableLength + uCount)) ||
+        !SymTable_growEntries(oSymTable,
+                              oSymTable->entryCount + uCount))
+    {
+        free(pcAdded);
+        return 0;
+    }
+    SymTable_migrate(oSymTable, 0);
+
+    /* Carve every small key out of one block of the arena. */
+    for (i = (size_t)0; i < uCount && !oSymTable->iBorrowsKeys; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        uKeyBytes += SymArena_slabBytes(strlen(apcKeys[i]) + 1);
+    }
+    if (!SymArena_reserve(&oSymTable->sArena, uKeyBytes))
+    {
+        free(pcAdded);
+        return 0;
+    }
+
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        uLength = strlen(apcKeys[i]);
+        if (SymTable_findOrInsert(oSymTable, apcKeys[i], uLength,
+                SymTable_hash(oSymTable, apcKeys[i], uLength),
+                apvValues == NULL ? NULL : apvValues[i], &iAdded)
+            == NO_ENTRY)
+        {
+            while (i-- > 0)
+                if (pcAdded[i])
+                    (void)SymTable_remove(oSymTable, apcKeys[i]);
+            free(pcAdded);
+            return 0;
+        }
+        pcAdded[i] = (char)iAdded;
+    }
+
+    free(pcAdded);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    size_t uBuckets;
+
+    assert(oSymTable != NULL);
+
+    uBuckets = SymTable_bucketsNeeded(oSymTable, uCapacity);
+    if (!SymTable_expand(oSymTable, uBuckets))
+        return 0;
+    SymTable_migrate(oSymTable, 0);
+    if (uBuckets != 0)
+        oSymTable->minBuckets = SymTable_bucketsFor(
+            oSymTable->minBuckets > INITIAL_BUCKETS ?
+            oSymTable->minBuckets : INITIAL_BUCKETS, uCapacity);
+
+    if (uCapacity <= oSymTable->symTableLength)
+        return 1;
+    if (!SymTable_growEntries(oSymTable, oSymTable->entryCount +
+                              uCapacity - oSymTable->symTableLength))
+        return 0;
+    if (oSymTable->iBorrowsKeys)
+        return 1;
+    return SymArena_reserve(&oSymTable->sArena,
+        (uCapacity - oSymTable->symTableLength) *
+        SymArena_slabBytes(RESERVED_KEY_LENGTH + 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    struct SymTableEntry *psEntries;
+    struct SymArena sNewArena;
+    size_t *puNewBucketArray;
+    size_t *puNewChain;
+    char **ppcNewKeys;
+    size_t uNewBuckets;
+    size_t uKeyBytes = 0;
+    size_t uLength;
+    size_t i, j;
+
+    assert(oSymTable != NULL);
+
+    SymTable_migrate(oSymTable, 0);
+    psEntries = oSymTable->psEntries;
+
+    /* A table that may keep its bindings without a bucket array gives
+       it up. */
+    uNewBuckets = 0;
+    puNewBucketArray = NULL;
+    if (oSymTable->symTableLength > SYMTABLE_LIST_MAX)
+    {
+        uNewBuckets = SymTable_bucketsFor(INITIAL_BUCKETS,
+                                          oSymTable->symTableLength);
+        puNewBucketArray = SymTable_newBuckets(uNewBuckets);
+        if (puNewBucketArray == NULL)
+            return 0;
+    }
+
+    ppcNewKeys = (char **)malloc(
+        (oSymTable->symTableLength + 1) * sizeof(char *));
+    if (ppcNewKeys == NULL)
+    {
+        free(puNewBucketArray);
+        return 0;
+    }
+
+    /* Copy every key into one slab of a fresh arena, dropping the
+       released blocks and half-used slabs of the old one. Borrowed keys
+       and keys in the table's own slots are left where they are. */
+    for (i = (size_t)0; i < oSymTable->entryCount; i++)
+        if (psEntries[i].pcKey != NULL && !oSymTable->iBorrowsKeys &&
+            !SymTable_isInlineKey(oSymTable, psEntries[i].pcKey))
+            uKeyBytes += SymArena_slabBytes(psEntries[i].uLength + 1);
+
+    SymArena_init(&sNewArena);
+    if (!SymArena_reserve(&sNewArena, uKeyBytes))
+    {
+        free(ppcNewKeys);
+        free(puNewBucketArray);
+        return 0;
+    }
+
+    for (i = (size_t)0, j = (size_t)0; i < oSymTable->entryCount; i++)
+    {
+        if (psEntries[i].pcKey == NULL)
+            continue;
+        if (oSymTable->iBorrowsKeys ||
+            SymTable_isInlineKey(oSymTable, psEntries[i].pcKey))
+        {
+            ppcNewKeys[j++] = psEntries[i].pcKey;
+            continue;
+        }
+        uLength = psEntries[i].uLength;
+        ppcNewKeys[j] = (char *)SymArena_alloc(&sNewArena, uLength + 1);
+        if (ppcNewKeys[j] == NULL)
+        {
+            SymArena_freeAll(&sNewArena);
+            free(ppcNewKeys);
+            free(puNewBucketArray);
+            return 0;
+        }
+        memcpy(ppcNewKeys[j], psEntries[i].pcKey, uLength + 1);
+        j++;
+    }
+
+    /* Nothing can fail from here on. Close the holes and relink every
+       entry into the new bucket array. */
+    for (i = (size_t)0, j = (size_t)0; i < oSymTable->entryCount; i++)
+    {
+        if (oSymTable->psFirstIter != NULL)
+            SymTable_renumberIters(oSymTable, i, j);
+        if (psEntries[i].pcKey == NULL)
+            continue;
+        psEntries[j] = psEntries[i];
+        psEntries[j].pcKey = ppcNewKeys[j];
+        psEntries[j].uNext = NO_ENTRY;
+        if (puNewBucketArray != NULL)
+        {
+            puNewChain = puNewBucketArray +
+                (psEntries[j].uHash & (uNewBuckets - 1));
+            psEntries[j].uNext = *puNewChain;
+            *puNewChain = j;
+        }
+        j++;
+    }
+    if (oSymTable->psFirstIter != NULL)
+        SymTable_renumberIters(oSymTable, i, j);
+    oSymTable->entryCount = j;
+    free(ppcNewKeys);
+
+    if (j < oSymTable->entryCapacity)
+        SymTable_shrinkEntries(oSymTable, j);
+
+    SymArena_freeAll(&oSymTable->sArena);
+    oSymTable->sArena = sNewArena;
+    free(oSymTable->puFirstEntry);
+    oSymTable->puFirstEntry = puNewBucketArray;
+    oSymTable->buckets = uNewBuckets;
+    oSymTable->minBuckets = 0;
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the SymTableEntry of the binding in oSymTable
+   whose key is the uLength characters at pcKey, which hash to hash, or
+   NO_ENTRY if there is none, first moving a step of any resize in
+   progress. */
+
+static size_t SymTable_lookup(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t hash)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_migrate(oSymTable, SYMTABLE_REHASH_STEP);
+
+    return SymTable_find(oSymTable, pcKey, uLength, hash);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replaces the value of the binding of oSymTable in the entry with
+   index uIndex, if uIndex is not NO_ENTRY, with pvValue. Returns the
+   previous value, or NULL if uIndex is NO_ENTRY. */
+
+static void *SymTable_swapValue(SymTable_T oSymTable, size_t uIndex,
+const void *pvValue)
+{
+    void *pvPrevValue;
+
+    assert(oSymTable != NULL);
+
+    if (uIndex == NO_ENTRY)
+        return NULL;
+
+    pvPrevValue = oSymTable->psEntries[uIndex].pvValue;
+    oSymTable->psEntries[uIndex].pvValue = (void *)pvValue;
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* assert(pvValue != NULL); */
+
+    return SymTable_swapValue(oSymTable,
+        SymTable_lookup(oSymTable, pcKey, uLength,
+                        SymTable_hash(oSymTable, pcKey, uLength)),
+        pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_swapValue(oSymTable,
+        SymTable_lookup(oSymTable, oAtom->acName, oAtom->uLength,
+                        SymTable_atomHash(oSymTable, oAtom)),
+        pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_lookup(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength)) != NO_ENTRY;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_lookup(oSymTable, oAtom->acName, oAtom->uLength,
+        SymTable_atomHash(oSymTable, oAtom)) != NO_ENTRY;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    size_t uIndex;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    uIndex = SymTable_lookup(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength));
+    if (uIndex == NO_ENTRY)
+        return NULL;
+
+    return oSymTable->psEntries[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    size_t uIndex;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    uIndex = SymTable_lookup(oSymTable, oAtom->acName, oAtom->uLength,
+        SymTable_atomHash(oSymTable, oAtom));
+    if (uIndex == NO_ENTRY)
+        return NULL;
+
+    return oSymTable->psEntries[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    size_t auHash[SYMPREFETCH_GROUP];
+    size_t auLength[SYMPREFETCH_GROUP];
+    size_t auFirst[SYMPREFETCH_GROUP];
+    struct SymTableEntry *psEntries;
+    size_t uStart, uGroup, i, uTemp;
+    size_t uFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    SymTable_migrate(oSymTable, SYMTABLE_REHASH_STEP);
+
+    /* A table without a bucket array is small enough to stay in the
+       cache, so there is nothing to prefetch. */
+    if (oSymTable->buckets == 0) {
+        for (i = 0; i < uCount; i++) {
+            assert(apcKeys[i] != NULL);
+            auLength[0] = strlen(apcKeys[i]);
+            uTemp = SymTable_find(oSymTable, apcKeys[i], auLength[0],
+                SymTable_hash(oSymTable, apcKeys[i], auLength[0]));
+            apvValues[i] = NULL;
+            if (uTemp != NO_ENTRY) {
+                apvValues[i] = oSymTable->psEntries[uTemp].pvValue;
+                uFound++;
+            }
+        }
+        return uFound;
+    }
+
+    psEntries = oSymTable->psEntries;
+    for (uStart = 0; uStart < uCount; uStart += uGroup) {
+        uGroup = uCount - uStart < SYMPREFETCH_GROUP ?
+            uCount - uStart : SYMPREFETCH_GROUP;
+
+        /* Hash every key of the group and prefetch its bucket. */
+        for (i = 0; i < uGroup; i++) {
+            assert(apcKeys[uStart + i] != NULL);
+            auLength[i] = strlen(apcKeys[uStart + i]);
+            auHash[i] = SymTable_hash(oSymTable, apcKeys[uStart + i],
+                                      auLength[i]);
+            SYMPREFETCH(SymTable_chain(oSymTable, auHash[i]));
+        }
+
+        /* Read each bucket and prefetch the first entry of its
+           chain. */
+        for (i = 0; i < uGroup; i++) {
+            auFirst[i] = *SymTable_chain(oSymTable, auHash[i]);
+            if (auFirst[i] != NO_ENTRY)
+                SYMPREFETCH(psEntries + auFirst[i]);
+        }
+
+        /* Prefetch the key of each first entry whose hash matches,
+           which is almost always the key being looked up. */
+        for (i = 0; i < uGroup; i++)
+            if (auFirst[i] != NO_ENTRY &&
+                psEntries[auFirst[i]].uHash == auHash[i])
+                SYMPREFETCH(psEntries[auFirst[i]].pcKey);
+
+        for (i = 0; i < uGroup; i++) {
+            apvValues[uStart + i] = NULL;
+            for (uTemp = auFirst[i]; uTemp != NO_ENTRY;
+                 uTemp = psEntries[uTemp].uNext) {
+                if (psEntries[uTemp].uHash == auHash[i] &&
+                    psEntries[uTemp].uLength == auLength[i] &&
+                    !memcmp(psEntries[uTemp].pcKey,
+                            apcKeys[uStart + i], auLength[i])) {
+                    apvValues[uStart + i] = psEntries[uTemp].pvValue;
+                    uFound++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Empties the entry of oSymTable with index uIndex, which has already
+   been unlinked from its chain, and then squeezes and shrinks
+   oSymTable if it has become too sparse. Returns the value of the
+   binding that the entry held. */
+
+static void *SymTable_vacate(SymTable_T oSymTable, size_t uIndex)
+{
+    struct SymTableEntry *psEntry;
+    void *pvPrevValue;
+
+    assert(oSymTable != NULL);
+
+    psEntry = oSymTable->psEntries + uIndex;
+    pvPrevValue = psEntry->pvValue;
+
+    if (!oSymTable->iBorrowsKeys)
+        SymTable_releaseKey(oSymTable, psEntry->pcKey,
+                            psEntry->uLength);
+    psEntry->pcKey = NULL;
+    psEntry->pvValue = NULL;
+
+    oSymTable->symTableLength--;
+
+    /* Keep the holes from outnumbering the bindings, so that
+       SymTable_map stays proportional to the length. */
+    if (oSymTable->entryCount - oSymTable->symTableLength >
+        oSymTable->symTableLength)
+        SymTable_squeeze(oSymTable);
+    SymTable_shrink(oSymTable);
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_removeN for a key that hashes to hash. */
+
+static void *SymTable_removeHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t hash)
+{
+    struct SymTableEntry *psEntries;
+    size_t *puLink;
+    size_t uTemp;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_migrate(oSymTable, SYMTABLE_REHASH_STEP);
+    psEntries = oSymTable->psEntries;
+
+    if (oSymTable->buckets == 0) {
+        uTemp = SymTable_find(oSymTable, pcKey, uLength, hash);
+        if (uTemp == NO_ENTRY)
+            return NULL;
+        return SymTable_vacate(oSymTable, uTemp);
+    }
+
+    puLink = SymTable_chain(oSymTable, hash);
+
+    for (uTemp = *puLink; uTemp != NO_ENTRY;
+         uTemp = psEntries[uTemp].uNext) {
+        if (psEntries[uTemp].uHash == hash &&
+            psEntries[uTemp].uLength == uLength &&
+            (psEntries[uTemp].pcKey == pcKey ||
+             !memcmp(psEntries[uTemp].pcKey, pcKey, uLength))) {
+            *puLink = psEntries[uTemp].uNext;
+            return SymTable_vacate(oSymTable, uTemp);
+        }
+        puLink = &psEntries[uTemp].uNext;
+    }
+
+    return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom));
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableEntry *psEntry;
+    struct SymTableEntry *psEntriesEnd;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    /* The entries are scanned in order, so the bindings are visited
+       in the order in which they were added. */
+    psEntriesEnd = oSymTable->psEntries + oSymTable->entryCount;
+    for (psEntry = oSymTable->psEntries; psEntry < psEntriesEnd;
+         psEntry++)
+    {
+        if (psEntry->pcKey != NULL)
+            (*pfApply)((void*)psEntry->pcKey, (void *)psEntry->pvValue,
+                       (void*)pvExtra);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(uShard == 0);
+    assert(pfApply != NULL);
+
+    SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   of entries uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    struct SymTableEntry *psEntry;
+    struct SymTableEntry *psEntriesEnd;
+
+    assert(psJob != NULL);
+
+    psEntriesEnd = psJob->oSymTable->psEntries + uEnd;
+    for (psEntry = psJob->oSymTable->psEntries + uBegin;
+         psEntry < psEntriesEnd; psEntry++)
+    {
+        if (psEntry->pcKey != NULL)
+            (*psJob->pfApply)(psEntry->pcKey, psEntry->pvValue,
+                              pvPart);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The entry array is divided into ranges of entries, holes
+   included. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sJob.oSymTable = oSymTable;
+    sJob.pfApply = pfApply;
+    return SymParallel_run(&sJob, oSymTable->entryCount,
+        SymTable_mapSlice, uThreads, pvExtra, uPartSize, pfReduce);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->uCurrent = NO_ENTRY;
+    psIter->uNext = 0;
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    SymTable_T oSymTable;
+    size_t i;
+
+    assert(oIter != NULL);
+
+    oSymTable = oIter->oSymTable;
+    for (i = oIter->uNext; i < oSymTable->entryCount; i++)
+    {
+        if (oSymTable->psEntries[i].pcKey != NULL)
+        {
+            oIter->uCurrent = i;
+            oIter->uNext = i + 1;
+            return 1;
+        }
+    }
+
+    oIter->uCurrent = NO_ENTRY;
+    oIter->uNext = i;
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->uCurrent != NO_ENTRY);
+
+    return oIter->oSymTable->psEntries[oIter->uCurrent].pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->uCurrent != NO_ENTRY);
+
+    return oIter->oSymTable->psEntries[oIter->uCurrent].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+
+    assert(oIter != NULL);
+
+    for (ppsLink = &oIter->oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
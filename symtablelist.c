@@ -4,28 +4,73 @@
 /*--------------------------------------------------------------------*/
 
 #include <assert.h>
+#include <stddef.h>
 #include "symtable.h"
+#include "symarena.h"
+#include "symparallel.h"
+
+/* Number of nodes that a SymTable can hold inside its own structure,
+   from 1 to 32. Override with -D SYMTABLE_INLINE_COUNT. */
+#ifndef SYMTABLE_INLINE_COUNT
+#define SYMTABLE_INLINE_COUNT 8
+#endif
+
+/* How a successful lookup reorders the list, so that frequently used
+   bindings drift toward its front: 0 leaves it as it is, 1 moves the
+   binding found to the front, and 2 swaps it with the binding before
+   it. The list is never reordered while an iterator is in use.
+   Override with -D SYMTABLE_REORDER. */
+#ifndef SYMTABLE_REORDER
+#define SYMTABLE_REORDER 0
+#endif
+
+/* Key length assumed for the bindings that SymTable_reserve makes room
+   for in the node arena. */
+static const size_t RESERVED_KEY_LENGTH = 15;
 
 /*--------------------------------------------------------------------*/
 
 /* Each binding in a Symtable is stored as a SymTableNode. SymTableNodes
-   are linked to each other to form a linked list structure. */
+   are linked to each other to form a linked list structure. A node and
+   its key are a single block allocated from the table's SymArena. A
+   table that borrows its keys stores a pointer to the caller's key in
+   place of the key's characters. */
 struct SymTableNode
 {
-    /* Unique String Key */
-    const char *pcKey;
-
     /* Binding's Value */
     void *pvValue;
 
     /* Pointer to the next SymTableNode in linked list */
     struct SymTableNode *psNextNode;
+
+    /* Length of the key, compared before its characters */
+    size_t uLength;
+
+    /* Unique String Key, stored inline, or a pointer to it */
+    char acKey[];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Number of bytes of an inline node: room for a SymTableNode whose key
+   has up to 15 characters, or is borrowed. */
+enum {INLINE_NODE_SIZE = offsetof(struct SymTableNode, acKey) + 16};
+
+/* A SymTableSlot is room inside a SymTable for one node, aligned as
+   the nodes that the arena hands out are. */
+union SymTableSlot
+{
+    void *pvAlign;
+    size_t uAlign;
+    char acBytes[INLINE_NODE_SIZE];
 };
 
 /*--------------------------------------------------------------------*/
 
 /* A SymTable is a structure that points to the first binding and
-   stores the number of bindings in the linked list. */
+   stores the number of bindings in the linked list. The first nodes
+   whose keys are short are kept in slots of the SymTable itself, so a
+   small table needs no memory beyond its structure. */
 struct SymTable
 {
     /* Pointer to the first SymTableNode */
@@ -33,10 +78,149 @@ struct SymTable
 
     /* Number of Bindings */
     size_t symTableLength;
+
+    /* 1 if the nodes point to their callers' keys instead of holding
+       copies of them */
+    int iBorrowsKeys;
+
+    /* Bit i is set if asSlots[i] holds a node */
+    unsigned long ulSlotsUsed;
+
+    /* Room for the nodes that are kept inside the table */
+    union SymTableSlot asSlots[SYMTABLE_INLINE_COUNT];
+
+    /* Pool from which every other SymTableNode is allocated */
+    struct SymArena sArena;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter walks the list of its SymTable from front to back.
+   Every iterator in use is linked into its SymTable, so that removing
+   a node can move past it any iterator that was about to visit it.
+   Bindings added during the iteration go to the front of the list and
+   are not visited. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Node at which the iterator is positioned, or NULL */
+    struct SymTableNode *psCurrentNode;
+
+    /* Node that the iterator visits next, or NULL */
+    struct SymTableNode *psNextNode;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Pointer to each SymTableNode, in list order */
+    struct SymTableNode **ppsNodes;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
 };
 
 /*--------------------------------------------------------------------*/
 
+/* Return the number of bytes in a SymTableNode of oSymTable whose key
+   has length uLength. */
+
+static size_t SymTable_nodeSize(SymTable_T oSymTable, size_t uLength)
+{
+    if (oSymTable->iBorrowsKeys)
+        return offsetof(struct SymTableNode, acKey) + sizeof(char *);
+    return offsetof(struct SymTableNode, acKey) + uLength + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the key of psNode, a node of oSymTable. */
+
+static const char *SymTable_key(SymTable_T oSymTable,
+const struct SymTableNode *psNode)
+{
+    const char *pcKey;
+
+    if (!oSymTable->iBorrowsKeys)
+        return psNode->acKey;
+    memcpy(&pcKey, psNode->acKey, sizeof(pcKey));
+    return pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 if psNode is kept in a slot of oSymTable, or 0 if it was
+   allocated from the arena. */
+
+static int SymTable_isInline(SymTable_T oSymTable,
+const struct SymTableNode *psNode)
+{
+    const char *pcNode = (const char *)psNode;
+
+    return pcNode >= (const char *)oSymTable->asSlots &&
+        pcNode < (const char *)(oSymTable->asSlots +
+                                SYMTABLE_INLINE_COUNT);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a block for a SymTableNode of oSymTable whose key has length
+   uLength: a free slot of the table if the node fits in one, and
+   otherwise a block of the arena. Returns NULL if insufficient memory
+   is available. */
+
+static struct SymTableNode *SymTable_allocNode(SymTable_T oSymTable,
+size_t uLength)
+{
+    size_t i;
+
+    if (SymTable_nodeSize(oSymTable, uLength) <= INLINE_NODE_SIZE)
+        for (i = (size_t)0; i < SYMTABLE_INLINE_COUNT; i++)
+            if (!(oSymTable->ulSlotsUsed & (1UL << i))) {
+                oSymTable->ulSlotsUsed |= 1UL << i;
+                return (struct SymTableNode *)(oSymTable->asSlots + i);
+            }
+
+    return (struct SymTableNode *)SymArena_alloc(&oSymTable->sArena,
+        SymTable_nodeSize(oSymTable, uLength));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Gives psNode, a node of oSymTable that is no longer linked, back to
+   the slot or arena block it came from. */
+
+static void SymTable_freeNode(SymTable_T oSymTable,
+struct SymTableNode *psNode)
+{
+    size_t uSlot;
+
+    if (SymTable_isInline(oSymTable, psNode)) {
+        uSlot = (size_t)((union SymTableSlot *)psNode -
+                         oSymTable->asSlots);
+        oSymTable->ulSlotsUsed &= ~(1UL << uSlot);
+    } else {
+        SymArena_release(&oSymTable->sArena, psNode,
+            SymTable_nodeSize(oSymTable, psNode->uLength));
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
 SymTable_T SymTable_new(void)
 {
     SymTable_T oSymTable;
@@ -47,6 +231,55 @@ SymTable_T SymTable_new(void)
 
     oSymTable->psFirstNode = NULL;
     oSymTable->symTableLength = 0;
+    oSymTable->iBorrowsKeys = 0;
+    oSymTable->ulSlotsUsed = 0;
+    SymArena_init(&oSymTable->sArena);
+    oSymTable->psFirstIter = NULL;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A linked list compares keys directly and never hashes them, so
+   pfHash is not used. */
+
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
+
+    return SymTable_new();
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    if (!SymTable_reserve(oSymTable, uCapacity))
+    {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->iBorrowsKeys = 1;
     return oSymTable;
 }
 
@@ -54,20 +287,20 @@ SymTable_T SymTable_new(void)
 
 void SymTable_free(SymTable_T oSymTable)
 {
-    struct SymTableNode *psCurrentNode;
-    struct SymTableNode *psNextNode;
+    struct SymTableIter *psIter, *psNextIter;
 
     assert(oSymTable != NULL);
 
-    for (psCurrentNode = oSymTable->psFirstNode;
-        psCurrentNode != NULL;
-        psCurrentNode = psNextNode)
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
     {
-        psNextNode = psCurrentNode->psNextNode;
-        free((void *)psCurrentNode->pcKey);
-        free(psCurrentNode);
+        psNextIter = psIter->psNextIter;
+        free(psIter);
     }
 
+    /* Every node lives in the arena or in the table itself, so the
+       list need not be walked. */
+    SymArena_freeAll(&oSymTable->sArena);
     free(oSymTable);
 }
 
@@ -80,43 +313,376 @@ size_t SymTable_getLength(SymTable_T oSymTable)
 
 /*--------------------------------------------------------------------*/
 
+/* Moves psNode of oSymTable toward the front of the list as
+   SYMTABLE_REORDER says. psPrevNode is the node before psNode, or NULL
+   if psNode is first, and psPrevPrevNode is the node before
+   psPrevNode, or NULL if there is none. */
+
+static void SymTable_promote(SymTable_T oSymTable,
+struct SymTableNode *psNode, struct SymTableNode *psPrevNode,
+struct SymTableNode *psPrevPrevNode)
+{
+    assert(oSymTable != NULL);
+    assert(psNode != NULL);
+
+    if (SYMTABLE_REORDER == 0 || psPrevNode == NULL ||
+        oSymTable->psFirstIter != NULL)
+        return;
+
+    psPrevNode->psNextNode = psNode->psNextNode;
+    if (SYMTABLE_REORDER == 1 || psPrevPrevNode == NULL) {
+        psNode->psNextNode = oSymTable->psFirstNode;
+        oSymTable->psFirstNode = psNode;
+    } else {
+        psNode->psNextNode = psPrevNode;
+        psPrevPrevNode->psNextNode = psNode;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the node of the binding in oSymTable whose key is the uLength
+   characters at pcKey, or NULL if there is none. Moves the node found
+   toward the front of the list as SYMTABLE_REORDER says, unless
+   iReorder is 0. */
+
+static struct SymTableNode *SymTable_find(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, int iReorder)
+{
+    struct SymTableNode *psTempNode;
+    struct SymTableNode *psPrevNode = NULL;
+    struct SymTableNode *psPrevPrevNode = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    for (psTempNode = oSymTable->psFirstNode; psTempNode != NULL;
+         psTempNode = psTempNode->psNextNode) {
+        if (psTempNode->uLength == uLength &&
+            (SymTable_key(oSymTable, psTempNode) == pcKey ||
+             !memcmp(SymTable_key(oSymTable, psTempNode), pcKey,
+                     uLength))) {
+            if (iReorder)
+                SymTable_promote(oSymTable, psTempNode, psPrevNode,
+                                 psPrevPrevNode);
+            return psTempNode;
+        }
+        psPrevPrevNode = psPrevNode;
+        psPrevNode = psTempNode;
+    }
+
+    return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves every iterator of oSymTable that would visit psNode next past
+   it, before psNode is unlinked and released. */
+
+static void SymTable_skipNode(SymTable_T oSymTable,
+struct SymTableNode *psNode)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+    assert(psNode != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+        if (psIter->psNextNode == psNode)
+            psIter->psNextNode = psNode->psNextNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, adding a new binding with that key and value
+   pvValue to the front of the list if none exists, walking the list
+   only once. An existing binding is moved as SymTable_find moves it,
+   unless iReorder is 0. Returns the binding's SymTableNode and sets
+   *piAdded to 1 if it was added or 0 if it already existed. Returns
+   NULL, leaving oSymTable unchanged, if insufficient memory is
+   available. */
+
+static struct SymTableNode *SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, const void *pvValue, int iReorder,
+int *piAdded)
+{
+    struct SymTableNode *psTempNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    psTempNode = SymTable_find(oSymTable, pcKey, uLength, iReorder);
+    if (psTempNode != NULL) {
+        *piAdded = 0;
+        return psTempNode;
+    }
+
+    psTempNode = SymTable_allocNode(oSymTable, uLength);
+    if (psTempNode == NULL)
+        return NULL;
+    if (oSymTable->iBorrowsKeys)
+        memcpy(psTempNode->acKey, &pcKey, sizeof(pcKey));
+    else {
+        memcpy(psTempNode->acKey, pcKey, uLength);
+        psTempNode->acKey[uLength] = '\0';
+    }
+    psTempNode->uLength = uLength;
+
+    psTempNode->pvValue = (void *)pvValue;
+    psTempNode->psNextNode = oSymTable->psFirstNode;
+    oSymTable->psFirstNode = psTempNode;
+    oSymTable->symTableLength++;
+
+    *piAdded = 1;
+    return psTempNode;
+}
+
+/*--------------------------------------------------------------------*/
+
 int SymTable_put(SymTable_T oSymTable, const char *pcKey,
 const void *pvValue)
 {
-    struct SymTableNode *psNewNode;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    psNewNode = (struct SymTableNode*)malloc(sizeof(struct SymTableNode));
-    if (psNewNode == NULL)
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength, pvValue, 1,
+                              &iAdded) == NULL)
         return 0;
 
-    if (SymTable_contains(oSymTable, pcKey)) {
-        free(psNewNode);
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A linked list never hashes keys, so only the length of the atom's
+   string is used. */
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putN(oSymTable, oAtom->acName, oAtom->uLength,
+                         pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    struct SymTableNode *psNode;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psNode = SymTable_findOrInsert(oSymTable, pcKey, uLength, pvValue,
+                                   1, &iAdded);
+    if (psNode == NULL)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return &psNode->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetN(oSymTable, oAtom->acName, oAtom->uLength,
+                              pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    struct SymTableNode *psTempNode;
+    size_t uNodeBytes = 0;
+    size_t uFreeSlots = 0;
+    size_t uAdded = 0;
+    size_t uSize;
+    size_t i;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    for (i = (size_t)0; i < SYMTABLE_INLINE_COUNT; i++)
+        if (!(oSymTable->ulSlotsUsed & (1UL << i)))
+            uFreeSlots++;
+
+    /* Carve every small node out of one block of the arena, except
+       the ones that will take the table's free slots. */
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        uSize = SymTable_nodeSize(oSymTable, strlen(apcKeys[i]));
+        if (uSize <= INLINE_NODE_SIZE && uFreeSlots > 0)
+            uFreeSlots--;
+        else
+            uNodeBytes += SymArena_slabBytes(uSize);
+    }
+    if (!SymArena_reserve(&oSymTable->sArena, uNodeBytes))
         return 0;
+
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        if (SymTable_findOrInsert(oSymTable, apcKeys[i],
+                strlen(apcKeys[i]),
+                apvValues == NULL ? NULL : apvValues[i], 0, &iAdded)
+            == NULL)
+        {
+            /* The bindings this call added are the first uAdded nodes
+               of the list, since none of its lookups reordered it. */
+            while (uAdded-- > 0) {
+                psTempNode = oSymTable->psFirstNode;
+                SymTable_skipNode(oSymTable, psTempNode);
+                oSymTable->psFirstNode = psTempNode->psNextNode;
+                SymTable_freeNode(oSymTable, psTempNode);
+                oSymTable->symTableLength--;
+            }
+            return 0;
+        }
+        uAdded += (size_t)iAdded;
     }
 
-    psNewNode->pcKey = (char*)malloc(strlen(pcKey) + 1);
-    if (psNewNode->pcKey == NULL) {
-        free(psNewNode);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A linked list has no array to size, so reserving capacity only
+   preallocates the node pool. */
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    assert(oSymTable != NULL);
+
+    if (uCapacity <= oSymTable->symTableLength)
+        return 1;
+    return SymArena_reserve(&oSymTable->sArena,
+        (uCapacity - oSymTable->symTableLength) *
+        SymArena_slabBytes(
+            SymTable_nodeSize(oSymTable, RESERVED_KEY_LENGTH)));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A linked list has no array to shrink, so compacting copies the
+   nodes, in order, into one slab of a fresh arena, dropping the
+   released blocks and unused space of the old one. Nodes kept in the
+   table's own slots stay where they are. */
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    struct SymTableNode *psTempNode, *psNewNode;
+    struct SymTableNode *psNewFirstNode = NULL;
+    struct SymTableNode **ppsNewLink;
+    struct SymTableIter *psIter;
+    struct SymArena sNewArena;
+    size_t uNodeBytes = 0;
+    size_t uSize;
+
+    assert(oSymTable != NULL);
+
+    for (psTempNode = oSymTable->psFirstNode; psTempNode != NULL;
+         psTempNode = psTempNode->psNextNode)
+        if (!SymTable_isInline(oSymTable, psTempNode))
+            uNodeBytes += SymArena_slabBytes(
+                SymTable_nodeSize(oSymTable, psTempNode->uLength));
+
+    SymArena_init(&sNewArena);
+    if (!SymArena_reserve(&sNewArena, uNodeBytes))
         return 0;
-    }
-    strcpy((char*)psNewNode->pcKey, pcKey);
 
-    psNewNode->pvValue = (void *)pvValue;
-    psNewNode->psNextNode = oSymTable->psFirstNode;
-    oSymTable->psFirstNode = psNewNode;
-    oSymTable->symTableLength++;
+    /* The reserved slab holds every copy, so nothing can fail from
+       here on. Each iterator is moved onto the copy of its node as
+       the copy is made, because relinking the nodes that stay in
+       place changes the old list. */
+    ppsNewLink = &psNewFirstNode;
+    for (psTempNode = oSymTable->psFirstNode; psTempNode != NULL;
+         psTempNode = psTempNode->psNextNode)
+    {
+        psNewNode = psTempNode;
+        if (!SymTable_isInline(oSymTable, psTempNode))
+        {
+            uSize = SymTable_nodeSize(oSymTable, psTempNode->uLength);
+            psNewNode = (struct SymTableNode *)SymArena_alloc(
+                &sNewArena, uSize);
+            assert(psNewNode != NULL);
+            memcpy(psNewNode, psTempNode, uSize);
+        }
+        *ppsNewLink = psNewNode;
+        ppsNewLink = &psNewNode->psNextNode;
 
+        for (psIter = oSymTable->psFirstIter; psIter != NULL;
+             psIter = psIter->psNextIter)
+        {
+            if (psIter->psCurrentNode == psTempNode)
+                psIter->psCurrentNode = psNewNode;
+            if (psIter->psNextNode == psTempNode)
+                psIter->psNextNode = psNewNode;
+        }
+    }
+
+    SymArena_freeAll(&oSymTable->sArena);
+    oSymTable->sArena = sNewArena;
+    oSymTable->psFirstNode = psNewFirstNode;
     return 1;
 }
 
-
 /*--------------------------------------------------------------------*/
 
 void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
 const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
 {
     struct SymTableNode *psTempNode;
     void *pvPrevValue;
@@ -125,65 +691,138 @@ const void *pvValue)
     assert(pcKey != NULL);
     /* assert(pvValue != NULL); */
 
-    psTempNode = oSymTable->psFirstNode;
+    psTempNode = SymTable_find(oSymTable, pcKey, uLength, 1);
+    if (psTempNode == NULL)
+        return NULL;
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            pvPrevValue = psTempNode->pvValue;
-            psTempNode->pvValue = (void *)pvValue;
-            return pvPrevValue;
-        }
-        psTempNode = psTempNode->psNextNode;
-    }
+    pvPrevValue = psTempNode->pvValue;
+    psTempNode->pvValue = (void *)pvValue;
+    return pvPrevValue;
+}
 
-    return NULL;
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_replaceN(oSymTable, oAtom->acName, oAtom->uLength,
+                             pvValue);
 }
 
 /*--------------------------------------------------------------------*/
 
 int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
 {
-    struct SymTableNode *psTempNode;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_find(oSymTable, pcKey, strlen(pcKey), 1) != NULL;
+}
 
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    psTempNode = oSymTable->psFirstNode;
+    return SymTable_find(oSymTable, pcKey, uLength, 1) != NULL;
+}
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            return 1;
-        }
-        psTempNode = psTempNode->psNextNode;
-    }
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
 
-    return 0;
+    return SymTable_containsN(oSymTable, oAtom->acName, oAtom->uLength);
 }
 
 /*--------------------------------------------------------------------*/
 
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
 {
     struct SymTableNode *psTempNode;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
 
-    psTempNode = oSymTable->psFirstNode;
+    psTempNode = SymTable_find(oSymTable, pcKey, uLength, 1);
+    if (psTempNode == NULL)
+        return NULL;
 
-    while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
-            return psTempNode->pvValue;
+    return psTempNode->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_getN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    struct SymTableNode *psTempNode;
+    size_t uFound = 0;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    /* Each step of a list search depends on the node before it, so
+       there are no independent accesses to overlap. */
+    for (i = 0; i < uCount; i++) {
+        assert(apcKeys[i] != NULL);
+        psTempNode = SymTable_find(oSymTable, apcKeys[i],
+                                   strlen(apcKeys[i]), 1);
+        apvValues[i] = NULL;
+        if (psTempNode != NULL) {
+            apvValues[i] = psTempNode->pvValue;
+            uFound++;
         }
-        psTempNode = psTempNode->psNextNode;
     }
 
-    return NULL;
+    return uFound;
 }
 
 /*--------------------------------------------------------------------*/
 
 void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
 {
     struct SymTableNode *psTempNode, *psPrevNode;
     void *pvPrevValue;
@@ -195,17 +834,20 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
     psPrevNode = NULL;
 
     while (psTempNode != NULL) {
-        if (!strcmp(psTempNode->pcKey, pcKey)) {
+        if (psTempNode->uLength == uLength &&
+            (SymTable_key(oSymTable, psTempNode) == pcKey ||
+             !memcmp(SymTable_key(oSymTable, psTempNode), pcKey,
+                     uLength))) {
             pvPrevValue = psTempNode->pvValue;
 
+            SymTable_skipNode(oSymTable, psTempNode);
             if (psPrevNode == NULL) {
                 oSymTable->psFirstNode = psTempNode->psNextNode;
             } else {
                 psPrevNode->psNextNode = psTempNode->psNextNode;
             }
 
-            free((void *)psTempNode->pcKey);
-            free(psTempNode);
+            SymTable_freeNode(oSymTable, psTempNode);
 
             oSymTable->symTableLength--;
             return pvPrevValue;
@@ -219,6 +861,16 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
 
 /*--------------------------------------------------------------------*/
 
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
 void SymTable_map(SymTable_T oSymTable,
 void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
 const void *pvExtra)
@@ -231,8 +883,160 @@ const void *pvExtra)
     for (psCurrentNode = oSymTable->psFirstNode;
     psCurrentNode != NULL;
     psCurrentNode = psCurrentNode->psNextNode)
-        (*pfApply)((void*)psCurrentNode->pcKey,
+        (*pfApply)(SymTable_key(oSymTable, psCurrentNode),
                 (void *)psCurrentNode->pvValue, (void*)pvExtra);
 }
 
-/*--------------------------------------------------------------------*/
\ No newline at end of file
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(uShard == 0);
+    assert(pfApply != NULL);
+
+    SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   of nodes uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    struct SymTableNode *psNode;
+    size_t i;
+
+    assert(psJob != NULL);
+
+    for (i = uBegin; i < uEnd; i++)
+    {
+        psNode = psJob->ppsNodes[i];
+        (*psJob->pfApply)(SymTable_key(psJob->oSymTable, psNode),
+                          psNode->pvValue, pvPart);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The nodes are first gathered into an array, so that the threads can
+   start their ranges without walking the list. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+    struct SymTableNode *psCurrentNode;
+    size_t i = 0;
+    int iSuccess;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sJob.ppsNodes = (struct SymTableNode **)malloc(
+        oSymTable->symTableLength * sizeof(struct SymTableNode *));
+    if (sJob.ppsNodes == NULL && oSymTable->symTableLength > 0)
+        return 0;
+    sJob.oSymTable = oSymTable;
+    sJob.pfApply = pfApply;
+
+    for (psCurrentNode = oSymTable->psFirstNode;
+    psCurrentNode != NULL;
+    psCurrentNode = psCurrentNode->psNextNode)
+        sJob.ppsNodes[i++] = psCurrentNode;
+
+    iSuccess = SymParallel_run(&sJob, oSymTable->symTableLength,
+        SymTable_mapSlice, uThreads, pvExtra, uPartSize, pfReduce);
+
+    free(sJob.ppsNodes);
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->psCurrentNode = NULL;
+    psIter->psNextNode = oSymTable->psFirstNode;
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+
+    oIter->psCurrentNode = oIter->psNextNode;
+    if (oIter->psCurrentNode == NULL)
+        return 0;
+
+    oIter->psNextNode = oIter->psCurrentNode->psNextNode;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->psCurrentNode != NULL);
+
+    return SymTable_key(oIter->oSymTable, oIter->psCurrentNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->psCurrentNode != NULL);
+
+    return oIter->psCurrentNode->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+
+    assert(oIter != NULL);
+
+    for (ppsLink = &oIter->oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
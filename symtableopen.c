@@ -0,0 +1,1268 @@
+/*--------------------------------------------------------------------*/
+/* symtableopen.c                                                     */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include "symtable.h"
+#include "symhash.h"
+#include "symparallel.h"
+#include "symprefetch.h"
+#include "symcursor.h"
+
+/* Number of slots in a new SymTable. Must be a power of two. */
+static const size_t INITIAL_CAPACITY = 512;
+
+/* The slot array is expanded once more than MAX_LOAD_NUMERATOR /
+   MAX_LOAD_DENOMINATOR of its slots are occupied. */
+static const size_t MAX_LOAD_NUMERATOR = 7;
+static const size_t MAX_LOAD_DENOMINATOR = 8;
+
+/*--------------------------------------------------------------------*/
+
+/* Each binding in a SymTable is stored in a SymTableSlot. Slots are
+   stored contiguously in a single array and are probed linearly using
+   Robin Hood hashing, so that every binding is kept as close as
+   possible to the slot its hash selects. A slot is empty if and only
+   if its pcKey is NULL. */
+struct SymTableSlot
+{
+    /* Full hash of pcKey, compared before the key itself */
+    size_t uHash;
+
+    /* Unique String Key, owned by the table unless it borrows its
+       keys */
+    const char *pcKey;
+
+    /* Binding's Value */
+    void *pvValue;
+
+    /* Length of pcKey, compared before its characters */
+    size_t uLength;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable is an open addressing hash table implementation of a
+   symbol table that points to a flat array of slots and stores the
+   number of bindings and slots. */
+struct SymTable
+{
+    /* Pointer to the first slot */
+    struct SymTableSlot *psSlots;
+
+    /* Number of Bindings */
+    size_t symTableLength;
+
+    /* Number of Slots (always a power of two) */
+    size_t capacity;
+
+    /* Fewest slots that removing bindings may shrink the table to */
+    size_t minCapacity;
+
+    /* Function that hashes keys */
+    SymTable_HashFunction pfHash;
+
+    /* 1 if the slots point to their callers' keys instead of copies of
+       them */
+    int iBorrowsKeys;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter visits the bindings of its SymTable one home slot (a
+   "group") at a time, taking the home slots in reverse-binary order as
+   Redis's SCAN does: growing the slot array then only splits each
+   group that has not been visited into groups that have not been
+   visited either. Bindings with the same home slot are contiguous and
+   keep their relative order until the slot array is resized, so the
+   iterator's place within a group is just a count. Every iterator in
+   use is linked into its SymTable, so that removing a binding can
+   correct that count, and the table does not shrink while an iterator
+   is in use. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Home slot of the group being visited; only the bits under the
+       slot mask are used */
+    size_t uCursor;
+
+    /* Number of bindings of the group that have been visited */
+    size_t uGroupIndex;
+
+    /* 1 if every group has been visited, 0 otherwise */
+    int iDone;
+
+    /* Key and hash of the binding at which the iterator is
+       positioned, or NULL and 0 */
+    const char *pcCurrentKey;
+    size_t uCurrentHash;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for pcKey, whose length is uLength. */
+
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return (*oSymTable->pfHash)(pcKey, uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for the string of oAtom, which is the
+   one computed when it was interned if oSymTable hashes with
+   SymHash_default. */
+
+static size_t SymTable_atomHash(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (oSymTable->pfHash == SymHash_default)
+        return oAtom->uHash;
+    return SymTable_hash(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the distance of the binding stored in slot uIndex of
+   oSymTable from the slot that its hash selects. */
+
+static size_t SymTable_probeDistance(SymTable_T oSymTable,
+size_t uIndex)
+{
+    size_t uMask = oSymTable->capacity - 1;
+
+    return (uIndex - (oSymTable->psSlots[uIndex].uHash & uMask))
+        & uMask;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Searches oSymTable for the binding whose key is the uLength
+   characters at pcKey, which hash to uHash. Returns 1 and sets
+   *puIndex to the binding's slot if it exists. Otherwise returns 0 and
+   sets *puIndex and *puDistance to the slot where such a binding
+   belongs and its distance from its home slot, which
+   SymTable_insertSlot can start from directly. */
+
+static int SymTable_probe(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t uHash, size_t *puIndex, size_t *puDistance)
+{
+    struct SymTableSlot *psSlot;
+    size_t uMask = oSymTable->capacity - 1;
+    size_t uIndex = uHash & uMask;
+    size_t uDistance = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(puIndex != NULL);
+    assert(puDistance != NULL);
+
+    for (;;) {
+        psSlot = oSymTable->psSlots + uIndex;
+
+        /* A Robin Hood table never lets a binding sit closer to its
+           home slot than one probed before it, so the search can stop
+           at the first empty or "richer" slot. */
+        if (psSlot->pcKey == NULL ||
+            SymTable_probeDistance(oSymTable, uIndex) < uDistance)
+            break;
+
+        if (psSlot->uHash == uHash && psSlot->uLength == uLength &&
+            (psSlot->pcKey == pcKey ||
+             !memcmp(psSlot->pcKey, pcKey, uLength))) {
+            *puIndex = uIndex;
+            return 1;
+        }
+
+        uIndex = (uIndex + 1) & uMask;
+        uDistance++;
+    }
+
+    *puIndex = uIndex;
+    *puDistance = uDistance;
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the slot in oSymTable that holds the binding
+   whose key is the uLength characters at pcKey, which hash to uHash,
+   or return capacity if no such binding exists. */
+
+static size_t SymTable_find(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t uHash)
+{
+    size_t uIndex, uDistance;
+
+    if (!SymTable_probe(oSymTable, pcKey, uLength, uHash, &uIndex,
+                        &uDistance))
+        return oSymTable->capacity;
+    return uIndex;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Stores the binding in *psSlot, whose key is not yet in oSymTable,
+   into oSymTable, looking for its place from slot uIndex, which is
+   uDistance slots from the binding's home slot. Its place is the first
+   slot from there that is empty or holds a binding closer to its own
+   home slot. The bindings from that slot up to the next empty slot
+   are shifted forward by one, which keeps the bindings with the same
+   home slot in the order in which they were stored. oSymTable must
+   have a free slot. */
+
+static void SymTable_insertSlot(SymTable_T oSymTable,
+struct SymTableSlot *psSlot, size_t uIndex, size_t uDistance)
+{
+    size_t uMask = oSymTable->capacity - 1;
+    size_t uEmpty, uPrev;
+
+    assert(oSymTable != NULL);
+    assert(psSlot != NULL);
+
+    while (oSymTable->psSlots[uIndex].pcKey != NULL &&
+           SymTable_probeDistance(oSymTable, uIndex) >= uDistance) {
+        uIndex = (uIndex + 1) & uMask;
+        uDistance++;
+    }
+
+    uEmpty = uIndex;
+    while (oSymTable->psSlots[uEmpty].pcKey != NULL)
+        uEmpty = (uEmpty + 1) & uMask;
+
+    while (uEmpty != uIndex) {
+        uPrev = (uEmpty - 1) & uMask;
+        oSymTable->psSlots[uEmpty] = oSymTable->psSlots[uPrev];
+        uEmpty = uPrev;
+    }
+
+    oSymTable->psSlots[uIndex] = *psSlot;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the first slot of oSymTable that holds a
+   binding whose home slot is uHome, or return capacity if there is no
+   such binding. */
+
+static size_t SymTable_groupStart(SymTable_T oSymTable, size_t uHome)
+{
+    size_t uMask = oSymTable->capacity - 1;
+    size_t uIndex = uHome;
+    size_t uDistance = 0;
+    size_t uExisting;
+
+    assert(oSymTable != NULL);
+
+    for (;;) {
+        if (oSymTable->psSlots[uIndex].pcKey == NULL)
+            return oSymTable->capacity;
+        uExisting = SymTable_probeDistance(oSymTable, uIndex);
+        if (uExisting == uDistance)
+            return uIndex;
+        if (uExisting < uDistance)
+            return oSymTable->capacity;
+        uIndex = (uIndex + 1) & uMask;
+        uDistance++;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of slots needed to hold uLength bindings without
+   exceeding the maximum load: uCapacity, doubled as many times as
+   necessary. */
+
+static size_t SymTable_capacityFor(size_t uCapacity, size_t uLength)
+{
+    while (uLength * MAX_LOAD_DENOMINATOR >
+           uCapacity * MAX_LOAD_NUMERATOR)
+        uCapacity *= 2;
+
+    return uCapacity;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Resizes oSymTable to uNewCapacity slots, a power of two that leaves
+   room for every binding, and reinserts every binding. Returns 0 if
+   memory allocation failed (oSymTable is unchanged) or 1 for a
+   successful resize. */
+
+static int SymTable_resize(SymTable_T oSymTable, size_t uNewCapacity)
+{
+    struct SymTableIter *psIter;
+    struct SymTableSlot *psOldSlots;
+    size_t uOldCapacity;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(uNewCapacity > oSymTable->symTableLength);
+
+    if (uNewCapacity == oSymTable->capacity)
+        return 1;
+
+    psOldSlots = oSymTable->psSlots;
+    uOldCapacity = oSymTable->capacity;
+
+    oSymTable->psSlots = (struct SymTableSlot *)calloc(
+            uNewCapacity, sizeof(struct SymTableSlot));
+    if (oSymTable->psSlots == NULL) {
+        oSymTable->psSlots = psOldSlots;
+        return 0;
+    }
+    oSymTable->capacity = uNewCapacity;
+
+    for (i = (size_t)0; i < uOldCapacity; i++)
+    {
+        if (psOldSlots[i].pcKey != NULL)
+            SymTable_insertSlot(oSymTable, psOldSlots + i,
+                psOldSlots[i].uHash & (oSymTable->capacity - 1), 0);
+    }
+
+    /* The groups have been rebuilt, so every iterator starts its
+       group over. */
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+        psIter->uGroupIndex = 0;
+
+    free(psOldSlots);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Expands oSymTable to uNewCapacity slots, as SymTable_resize does.
+   Returns 0 if memory allocation failed (oSymTable is unchanged) or 1
+   for a successful expansion. Does nothing and returns 1 if oSymTable
+   already has at least uNewCapacity slots. */
+
+static int SymTable_expand(SymTable_T oSymTable, size_t uNewCapacity)
+{
+    assert(oSymTable != NULL);
+
+    if (uNewCapacity <= oSymTable->capacity)
+        return 1;
+
+    return SymTable_resize(oSymTable, uNewCapacity);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Shrinks oSymTable if its load has fallen below a quarter of the
+   maximum load, to the fewest slots (but no fewer than its minimum)
+   that keep the load below half of it. The gap between the two
+   thresholds keeps a table whose length hovers around one of them
+   from resizing back and forth. The table is left as it is if memory
+   allocation fails or an iterator is in use. */
+
+static void SymTable_shrink(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    if (oSymTable->psFirstIter != NULL ||
+        oSymTable->capacity <= oSymTable->minCapacity ||
+        oSymTable->symTableLength * MAX_LOAD_DENOMINATOR * 4 >=
+        oSymTable->capacity * MAX_LOAD_NUMERATOR)
+        return;
+
+    (void)SymTable_resize(oSymTable,
+        SymTable_capacityFor(oSymTable->minCapacity,
+                             oSymTable->symTableLength * 2));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Create, initialize, and return a new and empty SymTable_T object
+   with uCapacity slots that hashes keys with pfHash, or return NULL if
+   insufficient memory is available. */
+
+static SymTable_T SymTable_create(SymTable_HashFunction pfHash,
+size_t uCapacity)
+{
+    SymTable_T oSymTable;
+
+    assert(pfHash != NULL);
+
+    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->psSlots = (struct SymTableSlot *)calloc(
+            uCapacity, sizeof(struct SymTableSlot));
+    if (oSymTable->psSlots == NULL)
+    {
+        free(oSymTable);
+        return NULL;
+    }
+
+    oSymTable->capacity = uCapacity;
+    oSymTable->minCapacity = uCapacity;
+    oSymTable->symTableLength = 0;
+    oSymTable->pfHash = pfHash;
+    oSymTable->iBorrowsKeys = 0;
+    oSymTable->psFirstIter = NULL;
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+    return SymTable_create(SymHash_default, INITIAL_CAPACITY);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
+
+    return SymTable_create(pfHash, INITIAL_CAPACITY);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    return SymTable_create(SymHash_default,
+        SymTable_capacityFor(INITIAL_CAPACITY, uCapacity));
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->iBorrowsKeys = 1;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter, *psNextIter;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
+    {
+        psNextIter = psIter->psNextIter;
+        free(psIter);
+    }
+
+    for (i = (size_t)0; i < oSymTable->capacity &&
+         !oSymTable->iBorrowsKeys; i++)
+        free((void *)oSymTable->psSlots[i].pcKey);
+
+    free(oSymTable->psSlots);
+    free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    return oSymTable->symTableLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to hash, adding a new binding with
+   that key and value pvValue if none exists, probing its cluster only
+   once in the common case. Returns the index of the binding's slot and
+   sets *piAdded to 1 if it was added or 0 if it already existed.
+   Returns capacity, leaving oSymTable unchanged, if insufficient
+   memory is available. */
+
+static size_t SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t hash, const void *pvValue,
+int *piAdded)
+{
+    struct SymTableSlot sNewSlot;
+    char *pcKeyCopy;
+    size_t uIndex, uDistance;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    if (SymTable_probe(oSymTable, pcKey, uLength, hash, &uIndex,
+                       &uDistance)) {
+        *piAdded = 0;
+        return uIndex;
+    }
+
+    if ((oSymTable->symTableLength + 1) * MAX_LOAD_DENOMINATOR >
+        oSymTable->capacity * MAX_LOAD_NUMERATOR)
+    {
+        if (!SymTable_expand(oSymTable, oSymTable->capacity * 2))
+            return oSymTable->capacity;
+        (void)SymTable_probe(oSymTable, pcKey, uLength, hash, &uIndex,
+                             &uDistance);
+    }
+
+    if (oSymTable->iBorrowsKeys)
+        sNewSlot.pcKey = pcKey;
+    else
+    {
+        pcKeyCopy = (char*)malloc(uLength + 1);
+        if (pcKeyCopy == NULL)
+            return oSymTable->capacity;
+        memcpy(pcKeyCopy, pcKey, uLength);
+        pcKeyCopy[uLength] = '\0';
+        sNewSlot.pcKey = pcKeyCopy;
+    }
+
+    sNewSlot.uHash = hash;
+    sNewSlot.pvValue = (void *)pvValue;
+    sNewSlot.uLength = uLength;
+    SymTable_insertSlot(oSymTable, &sNewSlot, uIndex, uDistance);
+
+    oSymTable->symTableLength++;
+
+    *piAdded = 1;
+    return uIndex;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength,
+            SymTable_hash(oSymTable, pcKey, uLength), pvValue, &iAdded)
+        == oSymTable->capacity)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, oAtom->acName, oAtom->uLength,
+            SymTable_atomHash(oSymTable, oAtom), pvValue, &iAdded)
+        == oSymTable->capacity)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_putOrGetN for a key that hashes to
+   hash. */
+
+static void **SymTable_putOrGetHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t hash, const void *pvValue,
+int *piAdded)
+{
+    size_t uIndex;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    uIndex = SymTable_findOrInsert(oSymTable, pcKey, uLength, hash,
+                                   pvValue, &iAdded);
+    if (uIndex == oSymTable->capacity)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return &oSymTable->psSlots[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength), pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom), pvValue,
+        piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    char *pcAdded;
+    size_t uLength;
+    size_t i;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    if (uCount == 0)
+        return 1;
+
+    /* Remembers which keys this call added, to undo them if a later
+       allocation fails. */
+    pcAdded = (char*)calloc(uCount, sizeof(char));
+    if (pcAdded == NULL)
+        return 0;
+
+    /* Size the slot array for every binding at once, so the inserts
+       below never expand it. */
+    if (!SymTable_expand(oSymTable,
+            SymTable_capacityFor(oSymTable->capacity,
+                                 oSymTable->symTableLength + uCount)))
+    {
+        free(pcAdded);
+        return 0;
+    }
+
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        uLength = strlen(apcKeys[i]);
+        if (SymTable_findOrInsert(oSymTable, apcKeys[i], uLength,
+                SymTable_hash(oSymTable, apcKeys[i], uLength),
+                apvValues == NULL ? NULL : apvValues[i], &iAdded)
+            == oSymTable->capacity)
+        {
+            while (i-- > 0)
+                if (pcAdded[i])
+                    (void)SymTable_remove(oSymTable, apcKeys[i]);
+            free(pcAdded);
+            return 0;
+        }
+        pcAdded[i] = (char)iAdded;
+    }
+
+    free(pcAdded);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    assert(oSymTable != NULL);
+
+    if (!SymTable_expand(oSymTable,
+            SymTable_capacityFor(oSymTable->capacity, uCapacity)))
+        return 0;
+    oSymTable->minCapacity =
+        SymTable_capacityFor(oSymTable->minCapacity, uCapacity);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Every key is allocated on its own, so compacting only shrinks the
+   slot array. Rebuilding the groups would make the iterators start
+   over, so the slot array is left as it is while an iterator is in
+   use; the reserved capacity is still given up, so that later
+   removals can shrink the table. */
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    if (oSymTable->psFirstIter != NULL)
+    {
+        oSymTable->minCapacity = INITIAL_CAPACITY;
+        return 1;
+    }
+    if (!SymTable_resize(oSymTable, SymTable_capacityFor(
+            INITIAL_CAPACITY, oSymTable->symTableLength)))
+        return 0;
+    oSymTable->minCapacity = INITIAL_CAPACITY;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replaces the value of the binding in slot uIndex of oSymTable, if
+   uIndex is less than capacity, with pvValue. Returns the previous
+   value, or NULL if uIndex is capacity. */
+
+static void *SymTable_swapValue(SymTable_T oSymTable, size_t uIndex,
+const void *pvValue)
+{
+    void *pvPrevValue;
+
+    assert(oSymTable != NULL);
+
+    if (uIndex == oSymTable->capacity)
+        return NULL;
+
+    pvPrevValue = oSymTable->psSlots[uIndex].pvValue;
+    oSymTable->psSlots[uIndex].pvValue = (void *)pvValue;
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_swapValue(oSymTable,
+        SymTable_find(oSymTable, pcKey, uLength,
+                      SymTable_hash(oSymTable, pcKey, uLength)),
+        pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_swapValue(oSymTable,
+        SymTable_find(oSymTable, oAtom->acName, oAtom->uLength,
+                      SymTable_atomHash(oSymTable, oAtom)),
+        pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_find(oSymTable, pcKey, uLength,
+                         SymTable_hash(oSymTable, pcKey, uLength))
+        != oSymTable->capacity;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_find(oSymTable, oAtom->acName, oAtom->uLength,
+                         SymTable_atomHash(oSymTable, oAtom))
+        != oSymTable->capacity;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    size_t uIndex;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    uIndex = SymTable_find(oSymTable, pcKey, uLength,
+                           SymTable_hash(oSymTable, pcKey, uLength));
+    if (uIndex == oSymTable->capacity)
+        return NULL;
+
+    return oSymTable->psSlots[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    size_t uIndex;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    uIndex = SymTable_find(oSymTable, oAtom->acName, oAtom->uLength,
+                           SymTable_atomHash(oSymTable, oAtom));
+    if (uIndex == oSymTable->capacity)
+        return NULL;
+
+    return oSymTable->psSlots[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    size_t auHash[SYMPREFETCH_GROUP];
+    size_t auLength[SYMPREFETCH_GROUP];
+    struct SymTableSlot *psSlot;
+    size_t uMask;
+    size_t uStart, uGroup, i, uIndex;
+    size_t uFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    uMask = oSymTable->capacity - 1;
+
+    for (uStart = 0; uStart < uCount; uStart += uGroup) {
+        uGroup = uCount - uStart < SYMPREFETCH_GROUP ?
+            uCount - uStart : SYMPREFETCH_GROUP;
+
+        /* Hash every key of the group and prefetch its home slot. */
+        for (i = 0; i < uGroup; i++) {
+            assert(apcKeys[uStart + i] != NULL);
+            auLength[i] = strlen(apcKeys[uStart + i]);
+            auHash[i] = SymTable_hash(oSymTable, apcKeys[uStart + i],
+                                      auLength[i]);
+            SYMPREFETCH(oSymTable->psSlots + (auHash[i] & uMask));
+        }
+
+        /* Prefetch the key of each home slot whose hash matches. A
+           binding displaced from its home slot is usually in the same
+           or the next cache line, which the probe reaches soon
+           enough. */
+        for (i = 0; i < uGroup; i++) {
+            psSlot = oSymTable->psSlots + (auHash[i] & uMask);
+            if (psSlot->pcKey != NULL && psSlot->uHash == auHash[i])
+                SYMPREFETCH(psSlot->pcKey);
+        }
+
+        for (i = 0; i < uGroup; i++) {
+            uIndex = SymTable_find(oSymTable, apcKeys[uStart + i],
+                                   auLength[i], auHash[i]);
+            if (uIndex == oSymTable->capacity)
+                apvValues[uStart + i] = NULL;
+            else {
+                apvValues[uStart + i] =
+                    oSymTable->psSlots[uIndex].pvValue;
+                uFound++;
+            }
+        }
+    }
+
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves back by one every iterator of oSymTable whose group is that of
+   the binding in slot uIndex and that has visited that binding, since
+   removing it shifts the rest of the group back by one slot. */
+
+static void SymTable_skipSlot(SymTable_T oSymTable, size_t uIndex)
+{
+    struct SymTableIter *psIter;
+    size_t uMask = oSymTable->capacity - 1;
+    size_t uHome, uPosition;
+
+    assert(oSymTable != NULL);
+
+    uHome = oSymTable->psSlots[uIndex].uHash & uMask;
+    uPosition =
+        (uIndex - SymTable_groupStart(oSymTable, uHome)) & uMask;
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+        if (!psIter->iDone && (psIter->uCursor & uMask) == uHome &&
+            psIter->uGroupIndex > uPosition)
+            psIter->uGroupIndex--;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Removes the binding in slot uIndex of oSymTable, if uIndex is less
+   than capacity. Returns the value of the binding, or NULL if uIndex
+   is capacity. */
+
+static void *SymTable_removeSlot(SymTable_T oSymTable, size_t uIndex)
+{
+    void *pvPrevValue;
+    size_t uMask;
+    size_t uNext;
+
+    assert(oSymTable != NULL);
+
+    if (uIndex == oSymTable->capacity)
+        return NULL;
+
+    if (oSymTable->psFirstIter != NULL)
+        SymTable_skipSlot(oSymTable, uIndex);
+
+    pvPrevValue = oSymTable->psSlots[uIndex].pvValue;
+    if (!oSymTable->iBorrowsKeys)
+        free((void *)oSymTable->psSlots[uIndex].pcKey);
+
+    /* Shift the following bindings of the cluster back by one slot
+       instead of leaving a tombstone behind. */
+    uMask = oSymTable->capacity - 1;
+    uNext = (uIndex + 1) & uMask;
+    while (oSymTable->psSlots[uNext].pcKey != NULL &&
+           SymTable_probeDistance(oSymTable, uNext) != 0)
+    {
+        oSymTable->psSlots[uIndex] = oSymTable->psSlots[uNext];
+        uIndex = uNext;
+        uNext = (uNext + 1) & uMask;
+    }
+    oSymTable->psSlots[uIndex].pcKey = NULL;
+    oSymTable->psSlots[uIndex].uHash = 0;
+    oSymTable->psSlots[uIndex].pvValue = NULL;
+
+    oSymTable->symTableLength--;
+    SymTable_shrink(oSymTable);
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeSlot(oSymTable,
+        SymTable_find(oSymTable, pcKey, uLength,
+                      SymTable_hash(oSymTable, pcKey, uLength)));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeSlot(oSymTable,
+        SymTable_find(oSymTable, oAtom->acName, oAtom->uLength,
+                      SymTable_atomHash(oSymTable, oAtom)));
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableSlot *psSlot;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (i = (size_t)0; i < oSymTable->capacity; i++)
+    {
+        psSlot = oSymTable->psSlots + i;
+        if (psSlot->pcKey != NULL)
+            (*pfApply)((void*)psSlot->pcKey,
+            (void *)psSlot->pvValue, (void*)pvExtra);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(uShard == 0);
+    assert(pfApply != NULL);
+
+    SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   in slots uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    struct SymTableSlot *psSlot;
+    size_t i;
+
+    assert(psJob != NULL);
+
+    for (i = uBegin; i < uEnd; i++)
+    {
+        psSlot = psJob->oSymTable->psSlots + i;
+        if (psSlot->pcKey != NULL)
+            (*psJob->pfApply)(psSlot->pcKey, psSlot->pvValue, pvPart);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The slot array is divided into ranges of slots, empty ones
+   included. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sJob.oSymTable = oSymTable;
+    sJob.pfApply = pfApply;
+    return SymParallel_run(&sJob, oSymTable->capacity,
+        SymTable_mapSlice, uThreads, pvExtra, uPartSize, pfReduce);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->uCursor = 0;
+    psIter->uGroupIndex = 0;
+    psIter->iDone = 0;
+    psIter->pcCurrentKey = NULL;
+    psIter->uCurrentHash = 0;
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    SymTable_T oSymTable;
+    struct SymTableSlot *psSlot;
+    size_t uMask;
+    size_t uIndex;
+
+    assert(oIter != NULL);
+
+    oSymTable = oIter->oSymTable;
+    while (!oIter->iDone)
+    {
+        uMask = oSymTable->capacity - 1;
+        uIndex = SymTable_groupStart(oSymTable, oIter->uCursor & uMask);
+        if (uIndex != oSymTable->capacity)
+        {
+            /* The group ends at the first slot that is empty or holds
+               a binding with another home slot. */
+            psSlot = oSymTable->psSlots +
+                ((uIndex + oIter->uGroupIndex) & uMask);
+            if (psSlot->pcKey != NULL &&
+                (psSlot->uHash & uMask) == (oIter->uCursor & uMask))
+            {
+                oIter->uGroupIndex++;
+                oIter->pcCurrentKey = psSlot->pcKey;
+                oIter->uCurrentHash = psSlot->uHash;
+                return 1;
+            }
+        }
+
+        /* Move to the next group in reversed binary order; the
+           cursor wraps around to 0 after the last one. */
+        oIter->uCursor = SymCursor_next(oIter->uCursor, uMask);
+        oIter->uGroupIndex = 0;
+        if (oIter->uCursor == 0)
+            oIter->iDone = 1;
+    }
+
+    oIter->pcCurrentKey = NULL;
+    oIter->uCurrentHash = 0;
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->pcCurrentKey != NULL);
+
+    return oIter->pcCurrentKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The binding may have moved since SymTable_iterNext, so it is looked
+   up again. */
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    size_t uIndex;
+
+    assert(oIter != NULL);
+    assert(oIter->pcCurrentKey != NULL);
+
+    uIndex = SymTable_find(oIter->oSymTable, oIter->pcCurrentKey,
+                           strlen(oIter->pcCurrentKey),
+                           oIter->uCurrentHash);
+    assert(uIndex != oIter->oSymTable->capacity);
+    return oIter->oSymTable->psSlots[uIndex].pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+
+    assert(oIter != NULL);
+
+    for (ppsLink = &oIter->oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,1689 @@
+/*--------------------------------------------------------------------*/
+/* symtablesharded.c                                                  */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <stddef.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "symtable.h"
+#include "symhash.h"
+#include "symarena.h"
+#include "symparallel.h"
+#include "symprefetch.h"
+#include "symcursor.h"
+
+/* Maximum load factor of a shard, as a percentage of its number of
+   buckets. Once a new binding pushes the shard past it, the shard's
+   bucket array is grown. Override with -D SYMTABLE_MAX_LOAD_PERCENT. */
+#ifndef SYMTABLE_MAX_LOAD_PERCENT
+#define SYMTABLE_MAX_LOAD_PERCENT 100
+#endif
+
+/* Number of high-order bits of a hash code that select the shard of
+   its binding, so that a SymTable has 2 to that power shards. Must be
+   at least 1 and less than the number of bits in a size_t. Override
+   with -D SYMTABLE_SHARD_BITS. */
+#ifndef SYMTABLE_SHARD_BITS
+#define SYMTABLE_SHARD_BITS 4
+#endif
+
+/* sizeof is not available to the preprocessor, so the bits of a
+   size_t are counted through SIZE_MAX: it has at most
+   SYMTABLE_SHARD_BITS bits exactly when shifting it right by one less
+   leaves 1. Counts past 64 are rejected before they reach the shift. */
+#if SYMTABLE_SHARD_BITS < 1 || SYMTABLE_SHARD_BITS > 64 || \
+    (SIZE_MAX >> (SYMTABLE_SHARD_BITS - 1)) <= 1
+#error "SYMTABLE_SHARD_BITS must be positive and below size_t's bits"
+#endif
+
+#define SYMTABLE_SHARDS ((size_t)1 << SYMTABLE_SHARD_BITS)
+
+/* Number of buckets in each shard of a new SymTable. Bucket counts are
+   always powers of two, so a hash is reduced to a bucket index with a
+   mask of its low-order bits. */
+static const size_t INITIAL_BUCKETS = 32;
+
+/* Key length assumed for the bindings that SymTable_reserve makes room
+   for in the node arenas. */
+static const size_t RESERVED_KEY_LENGTH = 15;
+
+/*--------------------------------------------------------------------*/
+
+/* Each binding in a SymTable is stored as a SymTableNode in the chain
+   of its bucket. Every chain is in increasing order of the reversed
+   bits of its nodes' hash codes, and nodes with equal hash codes are
+   in the order they were added. A node and its key are a single block
+   allocated from the SymArena of the node's shard. A table that
+   borrows its keys stores a pointer to the caller's key in place of
+   the key's characters. */
+struct SymTableNode
+{
+    /* Full hash of the key, reduced to a shard and a bucket when
+       used */
+    size_t uHash;
+
+    /* Binding's Value */
+    void *pvValue;
+
+    /* Pointer to the next SymTableNode in the chain */
+    struct SymTableNode *psNextNode;
+
+    /* Length of the key, compared before its characters */
+    size_t uLength;
+
+    /* Unique String Key, stored inline, or a pointer to it */
+    char acKey[];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableShard is an expanding hash table that holds the bindings
+   of a SymTable whose hash codes share their high-order bits. Each
+   shard has its own lock and grows and shrinks on its own, so adding
+   bindings to one shard never waits for another shard to resize. */
+struct SymTableShard
+{
+    /* Lock held for writing to change the shard, or for reading to
+       look at it consistently */
+    pthread_rwlock_t sLock;
+
+    /* Pointer to the first SymTableNode of each bucket */
+    struct SymTableNode **ppsFirstNode;
+
+    /* Number of Buckets */
+    size_t buckets;
+
+    /* Fewest buckets that removing bindings may shrink the shard to */
+    size_t minBuckets;
+
+    /* Number of Bindings, only changed while the lock is held for
+       writing but read without it */
+    atomic_size_t uLength;
+
+    /* Pool from which the shard's SymTableNodes are allocated */
+    struct SymArena sArena;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable is a sharded hash table implementation of a symbol table
+   that many threads may use at once. Every operation on one binding
+   locks only the shard of its key. */
+struct SymTable
+{
+    /* Function that hashes keys */
+    SymTable_HashFunction pfHash;
+
+    /* 1 if the nodes point to their callers' keys instead of holding
+       copies of them */
+    int iBorrowsKeys;
+
+    /* Shards, indexed by the high-order bits of the hash code */
+    struct SymTableShard asShards[SYMTABLE_SHARDS];
+
+    /* Lock held while using psFirstIter or the fields of any iterator,
+       taken after any shard lock */
+    pthread_mutex_t sIterLock;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter visits the shards of its SymTable one after another,
+   and walks the buckets of each in the reversed binary order of their
+   indices, one chain at a time. Because the chains are sorted, that
+   walk visits the nodes of a shard in increasing order of their
+   reversed hash codes whatever the number of buckets, and a resize
+   keeps the nodes in that order, so growing or shrinking a shard
+   never makes the iterator skip or revisit a binding. Every iterator
+   in use is linked into its SymTable, so that removing a node can
+   move past it any iterator that was about to visit it. An iterator
+   belongs to one thread. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Index of the shard being visited */
+    size_t uShard;
+
+    /* Node that the iterator visits next, or NULL if it visits next
+       the first node of the shard whose reversed hash code is at
+       least uFrom */
+    struct SymTableNode *psNextNode;
+    size_t uFrom;
+
+    /* 1 if every node of the shard has been visited */
+    int iShardDone;
+
+    /* Node at which the iterator is positioned, or NULL */
+    struct SymTableNode *psCurrentNode;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes in a SymTableNode of oSymTable whose key
+   has length uLength. */
+
+static size_t SymTable_nodeSize(SymTable_T oSymTable, size_t uLength)
+{
+    if (oSymTable->iBorrowsKeys)
+        return offsetof(struct SymTableNode, acKey) + sizeof(char *);
+    return offsetof(struct SymTableNode, acKey) + uLength + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the key of psNode, a node of oSymTable. */
+
+static const char *SymTable_key(SymTable_T oSymTable,
+const struct SymTableNode *psNode)
+{
+    const char *pcKey;
+
+    if (!oSymTable->iBorrowsKeys)
+        return psNode->acKey;
+    memcpy(&pcKey, psNode->acKey, sizeof(pcKey));
+    return pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of buckets needed to hold uLength bindings without
+   exceeding SYMTABLE_MAX_LOAD_PERCENT: uBuckets, doubled as many times
+   as necessary. Doubling stops early if it would make the bucket array
+   overflow size_t; the shard then keeps working with longer chains. */
+
+static size_t SymTable_bucketsFor(size_t uBuckets, size_t uLength)
+{
+    const size_t MAX_BUCKETS =
+        ((size_t)-1 / sizeof(struct SymTableNode *)) / 2;
+
+    while (uLength * 100 > uBuckets * SYMTABLE_MAX_LOAD_PERCENT &&
+           uBuckets <= MAX_BUCKETS)
+        uBuckets *= 2;
+
+    return uBuckets;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the share of uCount bindings that falls to each shard if
+   they spread evenly, rounded up. */
+
+static size_t SymTable_share(size_t uCount)
+{
+    return uCount / SYMTABLE_SHARDS +
+        (uCount % SYMTABLE_SHARDS != 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new array of uBuckets empty buckets, or NULL if
+   insufficient memory is available. */
+
+static struct SymTableNode **SymTable_newBuckets(size_t uBuckets)
+{
+    return (struct SymTableNode **)calloc(uBuckets,
+        sizeof(struct SymTableNode *));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the shard of oSymTable that holds a binding whose key hashes
+   to uHash. */
+
+static struct SymTableShard *SymTable_shard(SymTable_T oSymTable,
+size_t uHash)
+{
+    assert(oSymTable != NULL);
+
+    return oSymTable->asShards +
+        (uHash >> (CHAR_BIT * sizeof(size_t) - SYMTABLE_SHARD_BITS));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the address of the pointer to the first node of the bucket
+   of psShard that holds a binding whose key hashes to uHash. */
+
+static struct SymTableNode **SymTable_chain(
+struct SymTableShard *psShard, size_t uHash)
+{
+    assert(psShard != NULL);
+
+    return psShard->ppsFirstNode + (uHash & (psShard->buckets - 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Create, initialize, and return a new and empty SymTable_T object
+   with uBuckets buckets in each shard that hashes keys with pfHash, or
+   return NULL if insufficient memory is available. */
+
+static SymTable_T SymTable_create(SymTable_HashFunction pfHash,
+size_t uBuckets)
+{
+    SymTable_T oSymTable;
+    struct SymTableShard *psShard;
+    size_t i;
+
+    assert(pfHash != NULL);
+
+    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    if (oSymTable == NULL)
+        return NULL;
+
+    for (i = (size_t)0; i < SYMTABLE_SHARDS; i++)
+    {
+        psShard = oSymTable->asShards + i;
+        psShard->ppsFirstNode = SymTable_newBuckets(uBuckets);
+        if (psShard->ppsFirstNode == NULL)
+            break;
+        if (pthread_rwlock_init(&psShard->sLock, NULL) != 0)
+        {
+            free(psShard->ppsFirstNode);
+            break;
+        }
+        psShard->buckets = uBuckets;
+        psShard->minBuckets = uBuckets;
+        atomic_init(&psShard->uLength, 0);
+        SymArena_init(&psShard->sArena);
+    }
+    if (i < SYMTABLE_SHARDS ||
+        pthread_mutex_init(&oSymTable->sIterLock, NULL) != 0)
+    {
+        while (i-- > 0)
+        {
+            pthread_rwlock_destroy(&oSymTable->asShards[i].sLock);
+            free(oSymTable->asShards[i].ppsFirstNode);
+        }
+        free(oSymTable);
+        return NULL;
+    }
+
+    oSymTable->pfHash = pfHash;
+    oSymTable->iBorrowsKeys = 0;
+    oSymTable->psFirstIter = NULL;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+    return SymTable_create(SymHash_default, INITIAL_BUCKETS);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
+
+    return SymTable_create(pfHash, INITIAL_BUCKETS);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_create(SymHash_default,
+        SymTable_bucketsFor(INITIAL_BUCKETS,
+                            SymTable_share(uCapacity)));
+    if (oSymTable == NULL)
+        return NULL;
+
+    if (!SymTable_reserve(oSymTable, uCapacity))
+    {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->iBorrowsKeys = 1;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* No other thread may be using oSymTable, so no lock is taken. */
+
+void SymTable_free(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter, *psNextIter;
+    struct SymTableShard *psShard;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
+    {
+        psNextIter = psIter->psNextIter;
+        free(psIter);
+    }
+
+    /* Every node lives in an arena, so the chains need not be
+       walked. */
+    for (i = (size_t)0; i < SYMTABLE_SHARDS; i++)
+    {
+        psShard = oSymTable->asShards + i;
+        SymArena_freeAll(&psShard->sArena);
+        pthread_rwlock_destroy(&psShard->sLock);
+        free(psShard->ppsFirstNode);
+    }
+    pthread_mutex_destroy(&oSymTable->sIterLock);
+
+    free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The shards are summed without taking their locks, so while other
+   threads add or remove bindings the sum is only approximate. */
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    size_t uLength = 0;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (i = (size_t)0; i < SYMTABLE_SHARDS; i++)
+        uLength += atomic_load_explicit(
+            &oSymTable->asShards[i].uLength, memory_order_relaxed);
+
+    return uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bindings in psShard, whose lock must be
+   held. */
+
+static size_t SymTable_shardLength(struct SymTableShard *psShard)
+{
+    assert(psShard != NULL);
+
+    return atomic_load_explicit(&psShard->uLength,
+                                memory_order_relaxed);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves psIter past the bucket of psShard whose index is uCursor,
+   so that it visits next the first node of the following bucket in
+   reversed binary order, if there is one. The lock of psShard and the
+   iterator lock must be held. */
+
+static void SymTable_skipBucket(struct SymTableIter *psIter,
+struct SymTableShard *psShard, size_t uCursor)
+{
+    assert(psIter != NULL);
+    assert(psShard != NULL);
+
+    uCursor = SymCursor_next(uCursor, psShard->buckets - 1);
+    psIter->psNextNode = NULL;
+    psIter->uFrom = SymCursor_reverseBits(uCursor);
+    psIter->iShardDone = uCursor == 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves psIter past psNode, a node of psShard, to the node that
+   follows it. The lock of psShard and the iterator lock must be
+   held. */
+
+static void SymTable_skipNode(struct SymTableIter *psIter,
+struct SymTableShard *psShard, struct SymTableNode *psNode)
+{
+    assert(psIter != NULL);
+    assert(psShard != NULL);
+    assert(psNode != NULL);
+
+    if (psNode->psNextNode != NULL)
+        psIter->psNextNode = psNode->psNextNode;
+    else
+        SymTable_skipBucket(psIter, psShard,
+                            psNode->uHash & (psShard->buckets - 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks in the bucket of psShard where psIter's uFrom falls for the
+   first node whose reversed hash code is at least uFrom, and makes it
+   the next node of psIter, or moves psIter past the bucket if there
+   is none. The lock of psShard and the iterator lock must be held. */
+
+static void SymTable_seek(struct SymTableIter *psIter,
+struct SymTableShard *psShard)
+{
+    struct SymTableNode *psTempNode;
+    size_t uCursor;
+
+    assert(psIter != NULL);
+    assert(psShard != NULL);
+
+    uCursor = SymCursor_reverseBits(psIter->uFrom) &
+        (psShard->buckets - 1);
+    for (psTempNode = psShard->ppsFirstNode[uCursor];
+         psTempNode != NULL;
+         psTempNode = psTempNode->psNextNode)
+    {
+        if (SymCursor_reverseBits(psTempNode->uHash) >= psIter->uFrom)
+        {
+            psIter->psNextNode = psTempNode;
+            return;
+        }
+    }
+    SymTable_skipBucket(psIter, psShard, uCursor);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Resizes psShard of oSymTable to uNewBuckets buckets, a power of two.
+   The old buckets are emptied in reversed binary order, which yields
+   the nodes in increasing order of their reversed hash codes, and each
+   node is pushed onto the front of its new chain, which is reversed
+   afterwards, so that every new chain is sorted too and the iterators
+   of the shard can go on from where they are. The lock of psShard
+   must be held for writing. Returns 0 for an unsuccessful resize
+   (memory allocation failed, the shard is unchanged) or 1 for a
+   successful resize. */
+
+static int SymTable_resize(SymTable_T oSymTable,
+struct SymTableShard *psShard, size_t uNewBuckets)
+{
+    struct SymTableNode **ppsNewFirstNode;
+    struct SymTableNode *psTempNode, *psNextNode, *psReversed;
+    struct SymTableNode **ppsNewChain;
+    size_t uCursor;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(psShard != NULL);
+
+    if (uNewBuckets == psShard->buckets)
+        return 1;
+
+    ppsNewFirstNode = SymTable_newBuckets(uNewBuckets);
+    if (ppsNewFirstNode == NULL)
+        return 0;
+
+    uCursor = 0;
+    do
+    {
+        for (psTempNode = psShard->ppsFirstNode[uCursor];
+             psTempNode != NULL;
+             psTempNode = psNextNode)
+        {
+            psNextNode = psTempNode->psNextNode;
+            ppsNewChain = ppsNewFirstNode +
+                (psTempNode->uHash & (uNewBuckets - 1));
+            psTempNode->psNextNode = *ppsNewChain;
+            *ppsNewChain = psTempNode;
+        }
+        uCursor = SymCursor_next(uCursor, psShard->buckets - 1);
+    } while (uCursor != 0);
+
+    for (i = (size_t)0; i < uNewBuckets; i++)
+    {
+        psReversed = NULL;
+        for (psTempNode = ppsNewFirstNode[i]; psTempNode != NULL;
+             psTempNode = psNextNode)
+        {
+            psNextNode = psTempNode->psNextNode;
+            psTempNode->psNextNode = psReversed;
+            psReversed = psTempNode;
+        }
+        ppsNewFirstNode[i] = psReversed;
+    }
+
+    free(psShard->ppsFirstNode);
+    psShard->ppsFirstNode = ppsNewFirstNode;
+    psShard->buckets = uNewBuckets;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for pcKey, whose length is uLength. */
+
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return (*oSymTable->pfHash)(pcKey, uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return oSymTable's hash code for the string of oAtom, which is the
+   one computed when it was interned if oSymTable hashes with
+   SymHash_default. */
+
+static size_t SymTable_atomHash(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (oSymTable->pfHash == SymHash_default)
+        return oAtom->uHash;
+    return SymTable_hash(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the node of the binding in psShard, a shard of oSymTable,
+   whose key is the uLength characters at pcKey, which hash to uHash,
+   or NULL if there is none. The lock of psShard must be held. */
+
+static struct SymTableNode *SymTable_find(SymTable_T oSymTable,
+struct SymTableShard *psShard, const char *pcKey, size_t uLength,
+size_t uHash)
+{
+    struct SymTableNode *psTempNode;
+
+    assert(oSymTable != NULL);
+    assert(psShard != NULL);
+    assert(pcKey != NULL);
+
+    for (psTempNode = *SymTable_chain(psShard, uHash);
+         psTempNode != NULL;
+         psTempNode = psTempNode->psNextNode)
+        if (psTempNode->uHash == uHash &&
+            psTempNode->uLength == uLength &&
+            (SymTable_key(oSymTable, psTempNode) == pcKey ||
+             !memcmp(SymTable_key(oSymTable, psTempNode), pcKey,
+                     uLength)))
+            return psTempNode;
+
+    return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Adds a binding whose key is the uLength characters at pcKey, which
+   hash to uHash, and value pvValue to its chain in psShard, a shard of
+   oSymTable, after every node whose reversed hash code is at most
+   that of uHash. Returns the new node, or NULL, leaving
+   psShard unchanged, if insufficient memory is available. The lock of
+   psShard must be held for writing. */
+
+static struct SymTableNode *SymTable_insert(SymTable_T oSymTable,
+struct SymTableShard *psShard, const char *pcKey, size_t uLength,
+size_t uHash, const void *pvValue)
+{
+    struct SymTableNode *psNewNode;
+    struct SymTableNode **ppsLink;
+    size_t uReversed;
+
+    assert(oSymTable != NULL);
+    assert(psShard != NULL);
+    assert(pcKey != NULL);
+
+    psNewNode = (struct SymTableNode *)SymArena_alloc(
+        &psShard->sArena, SymTable_nodeSize(oSymTable, uLength));
+    if (psNewNode == NULL)
+        return NULL;
+    if (oSymTable->iBorrowsKeys)
+        memcpy(psNewNode->acKey, &pcKey, sizeof(pcKey));
+    else
+    {
+        memcpy(psNewNode->acKey, pcKey, uLength);
+        psNewNode->acKey[uLength] = '\0';
+    }
+
+    uReversed = SymCursor_reverseBits(uHash);
+    for (ppsLink = SymTable_chain(psShard, uHash);
+         *ppsLink != NULL &&
+         SymCursor_reverseBits((*ppsLink)->uHash) <= uReversed;
+         ppsLink = &(*ppsLink)->psNextNode)
+        ;
+    psNewNode->uHash = uHash;
+    psNewNode->uLength = uLength;
+    psNewNode->pvValue = (void *)pvValue;
+    psNewNode->psNextNode = *ppsLink;
+    *ppsLink = psNewNode;
+    atomic_fetch_add_explicit(&psShard->uLength, 1,
+                              memory_order_relaxed);
+
+    return psNewNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Removes the binding in psShard of oSymTable whose key is the
+   uLength characters at pcKey, which hash to uHash, moving past it any
+   iterator that was about to visit it. Returns 1 and sets *ppvValue
+   to its value, or returns 0 if there is no such binding. The lock of
+   psShard must be held for writing. */
+
+static int SymTable_unlink(SymTable_T oSymTable,
+struct SymTableShard *psShard, const char *pcKey, size_t uLength,
+size_t uHash, void **ppvValue)
+{
+    struct SymTableNode *psTempNode;
+    struct SymTableNode **ppsLink;
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+    assert(psShard != NULL);
+    assert(pcKey != NULL);
+    assert(ppvValue != NULL);
+
+    for (ppsLink = SymTable_chain(psShard, uHash);
+         (psTempNode = *ppsLink) != NULL;
+         ppsLink = &psTempNode->psNextNode)
+    {
+        if (psTempNode->uHash != uHash ||
+            psTempNode->uLength != uLength ||
+            (SymTable_key(oSymTable, psTempNode) != pcKey &&
+             memcmp(SymTable_key(oSymTable, psTempNode), pcKey,
+                    uLength)))
+            continue;
+
+        pthread_mutex_lock(&oSymTable->sIterLock);
+        for (psIter = oSymTable->psFirstIter; psIter != NULL;
+             psIter = psIter->psNextIter)
+            if (psIter->psNextNode == psTempNode)
+                SymTable_skipNode(psIter, psShard, psTempNode);
+        pthread_mutex_unlock(&oSymTable->sIterLock);
+
+        *ppsLink = psTempNode->psNextNode;
+        *ppvValue = psTempNode->pvValue;
+        SymArena_release(&psShard->sArena, psTempNode,
+                         SymTable_nodeSize(oSymTable, uLength));
+        atomic_fetch_sub_explicit(&psShard->uLength, 1,
+                                  memory_order_relaxed);
+        return 1;
+    }
+
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash, adding a new binding with
+   that key and value pvValue if none exists, and then grows its shard
+   if the shard has become too full. Returns the binding's SymTableNode
+   and sets *piAdded to 1 if it was added or 0 if it already existed.
+   Returns NULL, leaving oSymTable unchanged, if insufficient memory is
+   available. */
+
+static struct SymTableNode *SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue,
+int *piAdded)
+{
+    struct SymTableShard *psShard;
+    struct SymTableNode *psNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    psShard = SymTable_shard(oSymTable, uHash);
+
+    pthread_rwlock_wrlock(&psShard->sLock);
+    psNode = SymTable_find(oSymTable, psShard, pcKey, uLength, uHash);
+    *piAdded = 0;
+    if (psNode == NULL)
+    {
+        psNode = SymTable_insert(oSymTable, psShard, pcKey, uLength,
+                                 uHash, pvValue);
+        *piAdded = psNode != NULL;
+
+        /* The node does not move when the bucket array is resized. If
+           growing fails, the shard keeps working with longer
+           chains. */
+        if (psNode != NULL)
+            (void)SymTable_resize(oSymTable, psShard,
+                SymTable_bucketsFor(psShard->buckets,
+                                    SymTable_shardLength(psShard)));
+    }
+    pthread_rwlock_unlock(&psShard->sLock);
+
+    return psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength,
+            SymTable_hash(oSymTable, pcKey, uLength), pvValue, &iAdded)
+        == NULL)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, oAtom->acName, oAtom->uLength,
+            SymTable_atomHash(oSymTable, oAtom), pvValue, &iAdded)
+        == NULL)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_putOrGetN for a key that hashes to uHash.
+   The returned pointer is not guarded by any lock, so threads that
+   share the binding must coordinate their use of it themselves. */
+
+static void **SymTable_putOrGetHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue,
+int *piAdded)
+{
+    struct SymTableNode *psNode;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psNode = SymTable_findOrInsert(oSymTable, pcKey, uLength, uHash,
+                                   pvValue, &iAdded);
+    if (psNode == NULL)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return &psNode->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength), pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom), pvValue,
+        piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Every shard lock is held for the whole call, in order of the
+   shards, so other threads see either none or all of the new
+   bindings. Each shard is sized for the keys that fall into it. */
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    struct SymTableShard *psShard;
+    size_t auIncoming[SYMTABLE_SHARDS];
+    char *pcAdded;
+    size_t *puHashes;
+    size_t i;
+    void *pvValue;
+    int iSuccess = 1;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    if (uCount == 0)
+        return 1;
+
+    /* Remembers which keys this call added, to undo them if a later
+       allocation fails. */
+    pcAdded = (char*)calloc(uCount, sizeof(char));
+    if (pcAdded == NULL)
+        return 0;
+    puHashes = (size_t *)malloc(uCount * sizeof(size_t));
+    if (puHashes == NULL)
+    {
+        free(pcAdded);
+        return 0;
+    }
+
+    /* Hash every key before taking the locks. */
+    for (i = (size_t)0; i < SYMTABLE_SHARDS; i++)
+        auIncoming[i] = 0;
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        puHashes[i] = SymTable_hash(oSymTable, apcKeys[i],
+                                    strlen(apcKeys[i]));
+        auIncoming[SymTable_shard(oSymTable, puHashes[i]) -
+                   oSymTable->asShards]++;
+    }
+
+    for (i = (size_t)0; i < SYMTABLE_SHARDS; i++)
+        pthread_rwlock_wrlock(&oSymTable->asShards[i].sLock);
+
+    /* Size each shard for its new bindings at once, so the inserts
+       below never grow it. */
+    for (i = (size_t)0; i < SYMTABLE_SHARDS && iSuccess; i++)
+    {
+        psShard = oSymTable->asShards + i;
+        iSuccess = SymTable_resize(oSymTable, psShard,
+            SymTable_bucketsFor(psShard->buckets,
+                SymTable_shardLength(psShard) + auIncoming[i]));
+    }
+
+    for (i = (size_t)0; i < uCount && iSuccess; i++)
+    {
+        psShard = SymTable_shard(oSymTable, puHashes[i]);
+        if (SymTable_find(oSymTable, psShard, apcKeys[i],
+                          strlen(apcKeys[i]), puHashes[i]) != NULL)
+            continue;
+
+        pcAdded[i] = SymTable_insert(oSymTable, psShard, apcKeys[i],
+            strlen(apcKeys[i]), puHashes[i],
+            apvValues == NULL ? NULL : apvValues[i]) != NULL;
+        iSuccess = pcAdded[i];
+    }
+
+    if (!iSuccess)
+        while (i-- > 0)
+            if (pcAdded[i])
+                (void)SymTable_unlink(oSymTable,
+                    SymTable_shard(oSymTable, puHashes[i]), apcKeys[i],
+                    strlen(apcKeys[i]), puHashes[i], &pvValue);
+
+    for (i = SYMTABLE_SHARDS; i-- > 0; )
+        pthread_rwlock_unlock(&oSymTable->asShards[i].sLock);
+    free(puHashes);
+    free(pcAdded);
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Each shard is prepared for its share of uCapacity, assuming that
+   keys spread evenly over the shards. */
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    struct SymTableShard *psShard;
+    size_t uShare;
+    size_t uLength;
+    size_t i;
+    int iSuccess = 1;
+
+    assert(oSymTable != NULL);
+
+    uShare = SymTable_share(uCapacity);
+    for (i = (size_t)0; i < SYMTABLE_SHARDS && iSuccess; i++)
+    {
+        psShard = oSymTable->asShards + i;
+        pthread_rwlock_wrlock(&psShard->sLock);
+
+        iSuccess = SymTable_resize(oSymTable, psShard,
+            SymTable_bucketsFor(psShard->buckets, uShare));
+        if (iSuccess)
+        {
+            psShard->minBuckets =
+                SymTable_bucketsFor(psShard->minBuckets, uShare);
+            uLength = SymTable_shardLength(psShard);
+            if (uShare > uLength)
+                iSuccess = SymArena_reserve(&psShard->sArena,
+                    (uShare - uLength) * SymArena_slabBytes(
+                        SymTable_nodeSize(oSymTable,
+                                          RESERVED_KEY_LENGTH)));
+        }
+
+        pthread_rwlock_unlock(&psShard->sLock);
+    }
+
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Compacts psShard of oSymTable: copies its nodes into a fresh arena,
+   dropping the released blocks and unused space of the old one, and
+   shrinks its bucket array to fit. The lock of psShard must be held
+   for writing. Returns 1 on success, or 0, leaving the shard
+   unchanged, if insufficient memory is available. */
+
+static int SymTable_compactShard(SymTable_T oSymTable,
+struct SymTableShard *psShard)
+{
+    struct SymArena sNewArena;
+    struct SymTableNode **ppsCopies;
+    struct SymTableNode *psTempNode, *psNewNode;
+    struct SymTableNode **ppsNewLink;
+    struct SymTableIter *psIter;
+    size_t uShard;
+    size_t uLength;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(psShard != NULL);
+
+    /* Copy the chains in order into an array of the same shape, so
+       that every iterator can be moved onto the copies. */
+    ppsCopies = SymTable_newBuckets(psShard->buckets);
+    if (ppsCopies == NULL)
+        return 0;
+    SymArena_init(&sNewArena);
+
+    uShard = (size_t)(psShard - oSymTable->asShards);
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    for (i = (size_t)0; i < psShard->buckets; i++)
+    {
+        ppsNewLink = ppsCopies + i;
+        for (psTempNode = psShard->ppsFirstNode[i]; psTempNode != NULL;
+             psTempNode = psTempNode->psNextNode)
+        {
+            uLength = psTempNode->uLength;
+            psNewNode = (struct SymTableNode *)SymArena_alloc(
+                &sNewArena, SymTable_nodeSize(oSymTable, uLength));
+            if (psNewNode == NULL)
+            {
+                pthread_mutex_unlock(&oSymTable->sIterLock);
+                SymArena_freeAll(&sNewArena);
+                free(ppsCopies);
+                return 0;
+            }
+            memcpy(psNewNode, psTempNode,
+                   SymTable_nodeSize(oSymTable, uLength));
+            psNewNode->psNextNode = NULL;
+            *ppsNewLink = psNewNode;
+            ppsNewLink = &psNewNode->psNextNode;
+
+            for (psIter = oSymTable->psFirstIter; psIter != NULL;
+                 psIter = psIter->psNextIter)
+            {
+                if (psIter->uShard != uShard)
+                    continue;
+                if (psIter->psCurrentNode == psTempNode)
+                    psIter->psCurrentNode = psNewNode;
+                if (psIter->psNextNode == psTempNode)
+                    psIter->psNextNode = psNewNode;
+            }
+        }
+    }
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    SymArena_freeAll(&psShard->sArena);
+    psShard->sArena = sNewArena;
+    free(psShard->ppsFirstNode);
+    psShard->ppsFirstNode = ppsCopies;
+
+    /* Shrinking can only fail by keeping the larger array. */
+    psShard->minBuckets = SymTable_bucketsFor(INITIAL_BUCKETS,
+        SymTable_shardLength(psShard));
+    (void)SymTable_resize(oSymTable, psShard, psShard->minBuckets);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The shards are compacted one at a time, so other shards stay in use
+   meanwhile. If memory runs out, the shards compacted so far stay
+   compacted. */
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    struct SymTableShard *psShard;
+    size_t i;
+    int iSuccess = 1;
+
+    assert(oSymTable != NULL);
+
+    for (i = (size_t)0; i < SYMTABLE_SHARDS && iSuccess; i++)
+    {
+        psShard = oSymTable->asShards + i;
+        pthread_rwlock_wrlock(&psShard->sLock);
+        iSuccess = SymTable_compactShard(oSymTable, psShard);
+        pthread_rwlock_unlock(&psShard->sLock);
+    }
+
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_replaceN for a key that hashes to
+   uHash. */
+
+static void *SymTable_replaceHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash, const void *pvValue)
+{
+    struct SymTableShard *psShard;
+    struct SymTableNode *psNode;
+    void *pvPrevValue = NULL;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psShard = SymTable_shard(oSymTable, uHash);
+
+    pthread_rwlock_wrlock(&psShard->sLock);
+    psNode = SymTable_find(oSymTable, psShard, pcKey, uLength, uHash);
+    if (psNode != NULL)
+    {
+        pvPrevValue = psNode->pvValue;
+        psNode->pvValue = (void *)pvValue;
+    }
+    pthread_rwlock_unlock(&psShard->sLock);
+
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_replaceHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, which hash to uHash. Returns 1 and sets
+   *ppvValue to its value, or returns 0 if there is no such binding. */
+
+static int SymTable_read(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, size_t uHash, void **ppvValue)
+{
+    struct SymTableShard *psShard;
+    struct SymTableNode *psNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(ppvValue != NULL);
+
+    psShard = SymTable_shard(oSymTable, uHash);
+
+    pthread_rwlock_rdlock(&psShard->sLock);
+    psNode = SymTable_find(oSymTable, psShard, pcKey, uLength, uHash);
+    if (psNode != NULL)
+        *ppvValue = psNode->pvValue;
+    pthread_rwlock_unlock(&psShard->sLock);
+
+    return psNode != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_read(oSymTable, pcKey, uLength,
+                         SymTable_hash(oSymTable, pcKey, uLength),
+                         &pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_read(oSymTable, oAtom->acName, oAtom->uLength,
+                         SymTable_atomHash(oSymTable, oAtom), &pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (!SymTable_read(oSymTable, pcKey, uLength,
+                       SymTable_hash(oSymTable, pcKey, uLength),
+                       &pvValue))
+        return NULL;
+
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    void *pvValue;
+
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    if (!SymTable_read(oSymTable, oAtom->acName, oAtom->uLength,
+                       SymTable_atomHash(oSymTable, oAtom), &pvValue))
+        return NULL;
+
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Each group takes the lock of every shard that its keys fall into,
+   once and in ascending order, as SymTable_putBulk does, so that the
+   whole group can be prefetched before any key is resolved. */
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    size_t auHash[SYMPREFETCH_GROUP];
+    size_t auLength[SYMPREFETCH_GROUP];
+    struct SymTableShard *apsShard[SYMPREFETCH_GROUP];
+    struct SymTableShard *apsLocked[SYMPREFETCH_GROUP];
+    struct SymTableNode *psNode;
+    size_t uStart, uGroup, uLocked, i, j;
+    size_t uFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    for (uStart = 0; uStart < uCount; uStart += uGroup)
+    {
+        uGroup = uCount - uStart < SYMPREFETCH_GROUP ?
+            uCount - uStart : SYMPREFETCH_GROUP;
+
+        /* Hash every key of the group, and insert its shard into the
+           sorted list of shards to lock unless it is there already. */
+        uLocked = 0;
+        for (i = 0; i < uGroup; i++)
+        {
+            assert(apcKeys[uStart + i] != NULL);
+            auLength[i] = strlen(apcKeys[uStart + i]);
+            auHash[i] = SymTable_hash(oSymTable, apcKeys[uStart + i],
+                                      auLength[i]);
+            apsShard[i] = SymTable_shard(oSymTable, auHash[i]);
+
+            for (j = uLocked; j > 0 && apsLocked[j - 1] > apsShard[i];
+                 j--)
+                ;
+            if (j > 0 && apsLocked[j - 1] == apsShard[i])
+                continue;
+            memmove(apsLocked + j + 1, apsLocked + j,
+                    (uLocked - j) * sizeof(struct SymTableShard *));
+            apsLocked[j] = apsShard[i];
+            uLocked++;
+        }
+
+        for (j = 0; j < uLocked; j++)
+            pthread_rwlock_rdlock(&apsLocked[j]->sLock);
+
+        for (i = 0; i < uGroup; i++)
+            SYMPREFETCH(SymTable_chain(apsShard[i], auHash[i]));
+        for (i = 0; i < uGroup; i++)
+        {
+            psNode = *SymTable_chain(apsShard[i], auHash[i]);
+            if (psNode != NULL)
+                SYMPREFETCH(psNode);
+        }
+
+        for (i = 0; i < uGroup; i++)
+        {
+            psNode = SymTable_find(oSymTable, apsShard[i],
+                apcKeys[uStart + i], auLength[i], auHash[i]);
+            apvValues[uStart + i] = NULL;
+            if (psNode != NULL)
+            {
+                apvValues[uStart + i] = psNode->pvValue;
+                uFound++;
+            }
+        }
+
+        for (j = uLocked; j-- > 0; )
+            pthread_rwlock_unlock(&apsLocked[j]->sLock);
+    }
+
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Does the work of SymTable_removeN for a key that hashes to uHash.
+   The shard of the binding shrinks once its load falls below a quarter
+   of SYMTABLE_MAX_LOAD_PERCENT, to keep it below half. A resize keeps
+   the iterators in place, so it need not wait for them to finish. */
+
+static void *SymTable_removeHashed(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, size_t uHash)
+{
+    struct SymTableShard *psShard;
+    void *pvPrevValue = NULL;
+    size_t uShardLength;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psShard = SymTable_shard(oSymTable, uHash);
+
+    pthread_rwlock_wrlock(&psShard->sLock);
+    if (SymTable_unlink(oSymTable, psShard, pcKey, uLength, uHash,
+                        &pvPrevValue))
+    {
+        uShardLength = SymTable_shardLength(psShard);
+        if (psShard->buckets > psShard->minBuckets &&
+            uShardLength * 400 <
+            psShard->buckets * SYMTABLE_MAX_LOAD_PERCENT)
+            (void)SymTable_resize(oSymTable, psShard,
+                SymTable_bucketsFor(psShard->minBuckets,
+                                    uShardLength * 2));
+    }
+    pthread_rwlock_unlock(&psShard->sLock);
+
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeHashed(oSymTable, pcKey, uLength,
+        SymTable_hash(oSymTable, pcKey, uLength));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeHashed(oSymTable, oAtom->acName,
+        oAtom->uLength, SymTable_atomHash(oSymTable, oAtom));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The shards are mapped one at a time, each with its lock held for
+   reading, so pfApply sees each shard consistently and must not add
+   or remove bindings of oSymTable. */
+
+void SymTable_map(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (i = (size_t)0; i < SYMTABLE_SHARDS; i++)
+        SymTable_mapShard(oSymTable, i, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return SYMTABLE_SHARDS;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The shard's lock is held for reading while its bindings are
+   visited, so pfApply must not add or remove bindings of
+   oSymTable. */
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableShard *psShard;
+    struct SymTableNode *psTempNode;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(uShard < SYMTABLE_SHARDS);
+    assert(pfApply != NULL);
+
+    psShard = oSymTable->asShards + uShard;
+    pthread_rwlock_rdlock(&psShard->sLock);
+
+    for (i = (size_t)0; i < psShard->buckets; i++)
+        for (psTempNode = psShard->ppsFirstNode[i]; psTempNode != NULL;
+             psTempNode = psTempNode->psNextNode)
+            (*pfApply)(SymTable_key(oSymTable, psTempNode),
+                       psTempNode->pvValue, (void *)pvExtra);
+
+    pthread_rwlock_unlock(&psShard->sLock);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   in shards uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    size_t i;
+
+    assert(psJob != NULL);
+
+    for (i = uBegin; i < uEnd; i++)
+        SymTable_mapShard(psJob->oSymTable, i, psJob->pfApply, pvPart);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The threads take whole shards, each of which is visited with its
+   lock held for reading as in SymTable_mapShard. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    sJob.oSymTable = oSymTable;
+    sJob.pfApply = pfApply;
+    return SymParallel_run(&sJob, SYMTABLE_SHARDS, SymTable_mapSlice,
+        uThreads, pvExtra, uPartSize, pfReduce);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->uShard = 0;
+    psIter->psNextNode = NULL;
+    psIter->uFrom = 0;
+    psIter->iShardDone = 0;
+    psIter->psCurrentNode = NULL;
+
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Only the iterator's own thread changes its shard, so the shard's
+   lock can be taken before the iterator lock. */
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    SymTable_T oSymTable;
+    struct SymTableShard *psShard;
+
+    assert(oIter != NULL);
+
+    oSymTable = oIter->oSymTable;
+    while (oIter->uShard < SYMTABLE_SHARDS)
+    {
+        psShard = oSymTable->asShards + oIter->uShard;
+        pthread_rwlock_rdlock(&psShard->sLock);
+        pthread_mutex_lock(&oSymTable->sIterLock);
+
+        if (oIter->psNextNode == NULL && !oIter->iShardDone)
+            SymTable_seek(oIter, psShard);
+
+        if (oIter->psNextNode != NULL)
+        {
+            oIter->psCurrentNode = oIter->psNextNode;
+            SymTable_skipNode(oIter, psShard, oIter->psCurrentNode);
+            pthread_mutex_unlock(&oSymTable->sIterLock);
+            pthread_rwlock_unlock(&psShard->sLock);
+            return 1;
+        }
+
+        /* Move on to the next shard once the cursor has wrapped
+           around past the last bucket of this one. */
+        if (oIter->iShardDone)
+        {
+            oIter->uShard++;
+            oIter->uFrom = 0;
+            oIter->iShardDone = 0;
+        }
+
+        pthread_mutex_unlock(&oSymTable->sIterLock);
+        pthread_rwlock_unlock(&psShard->sLock);
+    }
+
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    oIter->psCurrentNode = NULL;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+    return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    struct SymTableNode *psNode;
+
+    assert(oIter != NULL);
+
+    pthread_mutex_lock(&oIter->oSymTable->sIterLock);
+    psNode = oIter->psCurrentNode;
+    pthread_mutex_unlock(&oIter->oSymTable->sIterLock);
+
+    assert(psNode != NULL);
+    return SymTable_key(oIter->oSymTable, psNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    SymTable_T oSymTable;
+    struct SymTableShard *psShard;
+    void *pvValue;
+
+    assert(oIter != NULL);
+
+    /* The iterator stays in the shard of its current node, and only
+       its own thread moves it. */
+    oSymTable = oIter->oSymTable;
+    psShard = oSymTable->asShards + oIter->uShard;
+
+    pthread_rwlock_rdlock(&psShard->sLock);
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    assert(oIter->psCurrentNode != NULL);
+    pvValue = oIter->psCurrentNode->pvValue;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+    pthread_rwlock_unlock(&psShard->sLock);
+
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+    SymTable_T oSymTable;
+
+    assert(oIter != NULL);
+
+    oSymTable = oIter->oSymTable;
+    pthread_mutex_lock(&oSymTable->sIterLock);
+    for (ppsLink = &oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+    pthread_mutex_unlock(&oSymTable->sIterLock);
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,2086 @@
+/*--------------------------------------------------------------------*/
+/* symtabletree.c                                                     */
+/* Author: Praneeth Bhandaru                                          */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include "symtable.h"
+#include "symarena.h"
+#include "symparallel.h"
+#include "symprefetch.h"
+
+/* Largest number of keys in a node of a SymTable, at least 4. Wide
+   nodes keep the tree shallow, and the prefixes that a search reads
+   in each node take only a few cache lines. Override with
+   -D SYMTABLE_NODE_KEYS. */
+#ifndef SYMTABLE_NODE_KEYS
+#define SYMTABLE_NODE_KEYS 32
+#endif
+
+/* Fewest keys in a leaf, and in an inner node, other than the
+   root. */
+enum {MIN_LEAF_KEYS = SYMTABLE_NODE_KEYS / 2,
+      MIN_INNER_KEYS = (SYMTABLE_NODE_KEYS - 1) / 2};
+
+/* Number of characters of a key packed into its prefix. */
+enum {PREFIX_LENGTH = sizeof(size_t)};
+
+/* Greatest height of a tree. Every inner node has at least two
+   children, so a taller tree would hold more bindings than size_t can
+   count. */
+enum {MAX_HEIGHT = CHAR_BIT * sizeof(size_t)};
+
+/* Key length assumed for the bindings that SymTable_reserve makes room
+   for in the key arena. */
+static const size_t RESERVED_KEY_LENGTH = 15;
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableNode holds the keys of a node of the B+-tree, in ascending
+   order as strcmp orders them. Each key is described by its length and
+   its prefix, its first PREFIX_LENGTH characters packed into a size_t
+   so that comparing two prefixes as numbers compares those characters.
+   A search compares prefixes, which lie side by side in the node, and
+   follows a key's pointer only when the prefixes are equal. Every
+   node is the SymTableNode at the start of a SymTableLeaf or a
+   SymTableInner. */
+struct SymTableNode
+{
+    /* Number of keys */
+    size_t uCount;
+
+    /* 1 if the node is a SymTableLeaf, or 0 if it is a
+       SymTableInner */
+    int iLeaf;
+
+    /* Prefix of each key */
+    size_t auPrefix[SYMTABLE_NODE_KEYS];
+
+    /* Length of each key */
+    size_t auLength[SYMTABLE_NODE_KEYS];
+
+    /* Pointer to each key */
+    char *apcKeys[SYMTABLE_NODE_KEYS];
+};
+
+/* A SymTableLeaf holds bindings. Each key is copied into a block of
+   the table's SymArena, unless the table borrows its keys. The leaves
+   are linked in order, so that the bindings can be walked without
+   going back up the tree. */
+struct SymTableLeaf
+{
+    /* Keys of the bindings */
+    struct SymTableNode sNode;
+
+    /* Value of each binding */
+    void *apvValues[SYMTABLE_NODE_KEYS];
+
+    /* Pointer to the next leaf, or NULL. Spare nodes are linked
+       through it too. */
+    struct SymTableLeaf *psNextLeaf;
+};
+
+/* A SymTableInner holds separator keys: key i is the least key in the
+   subtree of child i + 1, and points to that key in its leaf, so the
+   keys of child i are at least key i - 1 and less than key i. */
+struct SymTableInner
+{
+    /* Separator keys */
+    struct SymTableNode sNode;
+
+    /* Pointer to each child */
+    struct SymTableNode *apsChildren[SYMTABLE_NODE_KEYS + 1];
+};
+
+/* Number of bytes allocated for every node, so that a spare node can
+   become either kind. */
+enum {NODE_SIZE = sizeof(struct SymTableLeaf) >
+      sizeof(struct SymTableInner) ? sizeof(struct SymTableLeaf) :
+      sizeof(struct SymTableInner)};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable is a B+-tree implementation of a symbol table. All of its
+   leaves are at the same depth, and every node other than the root is
+   at least about half full. A SymTable keeps a few spare nodes, so
+   that an insertion can split every node on its path without failing
+   partway. */
+struct SymTable
+{
+    /* Pointer to the root node, or NULL if the table is empty */
+    struct SymTableNode *psRoot;
+
+    /* Pointer to the leaf holding the least key, or NULL */
+    struct SymTableLeaf *psFirstLeaf;
+
+    /* Number of levels of the tree, or 0 if the table is empty */
+    size_t uHeight;
+
+    /* Number of Bindings */
+    size_t symTableLength;
+
+    /* Pointer to the first spare node, or NULL */
+    struct SymTableLeaf *psSpares;
+
+    /* Number of spare nodes */
+    size_t uSpares;
+
+    /* 1 if the leaves point to their callers' keys instead of copies
+       of them */
+    int iBorrowsKeys;
+
+    /* Pool from which every copied key is allocated */
+    struct SymArena sArena;
+
+    /* Count of the changes that have moved bindings within or between
+       leaves */
+    unsigned long ulVersion;
+
+    /* Pointer to the first SymTableIter in use, or NULL */
+    struct SymTableIter *psFirstIter;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableIter visits the bindings of its SymTable in ascending
+   order of their keys. It remembers the key at which it is
+   positioned, and the leaf and index where that key was, which remain
+   valid as long as the table's version does not change; otherwise it
+   finds the key again. Every iterator in use is linked into its
+   SymTable, so that removing the binding at which an iterator is
+   positioned can move the iterator to the next key first. */
+struct SymTableIter
+{
+    /* SymTable whose bindings are visited */
+    SymTable_T oSymTable;
+
+    /* ITER_BEFORE, ITER_AT, ITER_PENDING or ITER_DONE */
+    int iState;
+
+    /* Key at which the iterator is positioned, or which it visits
+       next if the iterator is pending, and its length */
+    const char *pcKey;
+    size_t uLength;
+
+    /* Leaf and index of pcKey, as of version ulVersion of the
+       table */
+    struct SymTableLeaf *psLeaf;
+    size_t uIndex;
+    unsigned long ulVersion;
+
+    /* Pointer to the next iterator of the same SymTable */
+    struct SymTableIter *psNextIter;
+};
+
+/* States of a SymTableIter: before the first binding, positioned at
+   pcKey, about to visit pcKey because the binding at which it was
+   positioned has been removed, and past the last binding. */
+enum {ITER_BEFORE, ITER_AT, ITER_PENDING, ITER_DONE};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob is the work of a SymTable_mapParallel, shared by
+   its threads. */
+struct SymTableMapJob
+{
+    /* Pointer to each leaf, in order */
+    struct SymTableLeaf **ppsLeaves;
+
+    /* Function applied to each binding */
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the prefix of the uLength characters at pcKey: its first
+   PREFIX_LENGTH characters, followed by null characters if it is
+   shorter, packed from the most significant byte down. */
+
+static size_t SymTable_prefix(const char *pcKey, size_t uLength)
+{
+    size_t uPrefix = 0;
+    size_t i;
+
+    assert(pcKey != NULL);
+
+    for (i = (size_t)0; i < PREFIX_LENGTH; i++) {
+        uPrefix <<= CHAR_BIT;
+        if (i < uLength)
+            uPrefix |= (unsigned char)pcKey[i];
+    }
+    return uPrefix;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a negative number, 0 or a positive number as the uLength
+   characters at pcKey, whose prefix is uPrefix, are less than, equal
+   to or greater than key i of psNode. */
+
+static int SymTable_compare(const struct SymTableNode *psNode,
+size_t i, size_t uPrefix, const char *pcKey, size_t uLength)
+{
+    size_t uOtherLength;
+    size_t uShorter;
+    int iOrder;
+
+    assert(psNode != NULL);
+    assert(i < psNode->uCount);
+
+    if (uPrefix != psNode->auPrefix[i])
+        return uPrefix < psNode->auPrefix[i] ? -1 : 1;
+
+    uOtherLength = psNode->auLength[i];
+    if (pcKey == psNode->apcKeys[i] && uLength == uOtherLength)
+        return 0;
+
+    /* Keys contain no null characters, so equal prefixes mean that
+       the first uShorter characters are equal, if uShorter is at most
+       PREFIX_LENGTH. */
+    uShorter = uLength < uOtherLength ? uLength : uOtherLength;
+    if (uShorter > PREFIX_LENGTH) {
+        iOrder = memcmp(pcKey + PREFIX_LENGTH,
+                        psNode->apcKeys[i] + PREFIX_LENGTH,
+                        uShorter - PREFIX_LENGTH);
+        if (iOrder != 0)
+            return iOrder;
+    }
+
+    if (uLength == uOtherLength)
+        return 0;
+    return uLength < uOtherLength ? -1 : 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the first key of psNode that is not less than
+   the uLength characters at pcKey, whose prefix is uPrefix, or the
+   number of keys if there is none. Sets *piFound to 1 if that key is
+   equal to them, or to 0 otherwise. */
+
+static size_t SymTable_search(const struct SymTableNode *psNode,
+size_t uPrefix, const char *pcKey, size_t uLength, int *piFound)
+{
+    size_t uLow = 0;
+    size_t uHigh;
+    size_t uMiddle;
+    int iOrder;
+
+    assert(psNode != NULL);
+    assert(piFound != NULL);
+
+    *piFound = 0;
+    uHigh = psNode->uCount;
+    while (uLow < uHigh) {
+        uMiddle = uLow + (uHigh - uLow) / 2;
+        iOrder = SymTable_compare(psNode, uMiddle, uPrefix, pcKey,
+                                  uLength);
+        if (iOrder == 0) {
+            *piFound = 1;
+            return uMiddle;
+        }
+        if (iOrder < 0)
+            uHigh = uMiddle;
+        else
+            uLow = uMiddle + 1;
+    }
+    return uLow;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the child of inner node psNode whose subtree
+   holds, or would hold, the uLength characters at pcKey, whose prefix
+   is uPrefix. */
+
+static size_t SymTable_child(const struct SymTableNode *psNode,
+size_t uPrefix, const char *pcKey, size_t uLength)
+{
+    size_t uIndex;
+    int iFound;
+
+    assert(psNode != NULL);
+    assert(!psNode->iLeaf);
+
+    uIndex = SymTable_search(psNode, uPrefix, pcKey, uLength, &iFound);
+    return uIndex + (size_t)iFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Copies uCount keys of psSource, starting at index uFrom, to psDest,
+   starting at index uTo. The ranges may overlap. */
+
+static void SymTable_moveKeys(struct SymTableNode *psDest, size_t uTo,
+const struct SymTableNode *psSource, size_t uFrom, size_t uCount)
+{
+    assert(psDest != NULL);
+    assert(psSource != NULL);
+
+    memmove(psDest->auPrefix + uTo, psSource->auPrefix + uFrom,
+            uCount * sizeof(size_t));
+    memmove(psDest->auLength + uTo, psSource->auLength + uFrom,
+            uCount * sizeof(size_t));
+    memmove(psDest->apcKeys + uTo, psSource->apcKeys + uFrom,
+            uCount * sizeof(char *));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Sets key i of psNode to the uLength characters at pcKey, whose
+   prefix is uPrefix. */
+
+static void SymTable_setKey(struct SymTableNode *psNode, size_t i,
+size_t uPrefix, char *pcKey, size_t uLength)
+{
+    assert(psNode != NULL);
+    assert(i < SYMTABLE_NODE_KEYS);
+
+    psNode->auPrefix[i] = uPrefix;
+    psNode->auLength[i] = uLength;
+    psNode->apcKeys[i] = pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Makes room for a key at index i of psNode, which is not full, by
+   moving every later key up one place, along with the value of each
+   if psNode is a leaf, or the child after each if it is an inner
+   node. */
+
+static void SymTable_openGap(struct SymTableNode *psNode, size_t i)
+{
+    struct SymTableLeaf *psLeaf;
+    struct SymTableInner *psInner;
+    size_t uAfter;
+
+    assert(psNode != NULL);
+    assert(psNode->uCount < SYMTABLE_NODE_KEYS);
+    assert(i <= psNode->uCount);
+
+    uAfter = psNode->uCount - i;
+    SymTable_moveKeys(psNode, i + 1, psNode, i, uAfter);
+    if (psNode->iLeaf) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        memmove(psLeaf->apvValues + i + 1, psLeaf->apvValues + i,
+                uAfter * sizeof(void *));
+    } else {
+        psInner = (struct SymTableInner *)psNode;
+        memmove(psInner->apsChildren + i + 2,
+                psInner->apsChildren + i + 1,
+                uAfter * sizeof(struct SymTableNode *));
+    }
+    psNode->uCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Removes key i of psNode, along with its value if psNode is a leaf,
+   or the child after it if it is an inner node, moving every later
+   key down one place. */
+
+static void SymTable_closeGap(struct SymTableNode *psNode, size_t i)
+{
+    struct SymTableLeaf *psLeaf;
+    struct SymTableInner *psInner;
+    size_t uAfter;
+
+    assert(psNode != NULL);
+    assert(i < psNode->uCount);
+
+    uAfter = psNode->uCount - i - 1;
+    SymTable_moveKeys(psNode, i, psNode, i + 1, uAfter);
+    if (psNode->iLeaf) {
+        psLeaf = (struct SymTableLeaf *)psNode;
+        memmove(psLeaf->apvValues + i, psLeaf->apvValues + i + 1,
+                uAfter * sizeof(void *));
+    } else {
+        psInner = (struct SymTableInner *)psNode;
+        memmove(psInner->apsChildren + i + 1,
+                psInner->apsChildren + i + 2,
+                uAfter * sizeof(struct SymTableNode *));
+    }
+    psNode->uCount--;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Allocates spare nodes for oSymTable until it has at least uCount.
+   Returns 1 on success, or 0, keeping the spare nodes allocated so
+   far, if insufficient memory is available. */
+
+static int SymTable_addSpares(SymTable_T oSymTable, size_t uCount)
+{
+    struct SymTableLeaf *psSpare;
+
+    assert(oSymTable != NULL);
+
+    while (oSymTable->uSpares < uCount) {
+        psSpare = (struct SymTableLeaf *)malloc(NODE_SIZE);
+        if (psSpare == NULL)
+            return 0;
+        psSpare->psNextLeaf = oSymTable->psSpares;
+        oSymTable->psSpares = psSpare;
+        oSymTable->uSpares++;
+    }
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return an empty node taken from the spare nodes of oSymTable, which
+   must have one: a leaf if iLeaf is 1, or an inner node if it is
+   0. */
+
+static struct SymTableNode *SymTable_takeNode(SymTable_T oSymTable,
+int iLeaf)
+{
+    struct SymTableLeaf *psSpare;
+
+    assert(oSymTable != NULL);
+    assert(oSymTable->psSpares != NULL);
+
+    psSpare = oSymTable->psSpares;
+    oSymTable->psSpares = psSpare->psNextLeaf;
+    oSymTable->uSpares--;
+
+    psSpare->sNode.uCount = 0;
+    psSpare->sNode.iLeaf = iLeaf;
+    psSpare->psNextLeaf = NULL;
+    return &psSpare->sNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Frees psNode and every node below it. */
+
+static void SymTable_freeNodes(struct SymTableNode *psNode)
+{
+    struct SymTableInner *psInner;
+    size_t i;
+
+    assert(psNode != NULL);
+
+    if (!psNode->iLeaf) {
+        psInner = (struct SymTableInner *)psNode;
+        for (i = (size_t)0; i <= psNode->uCount; i++)
+            SymTable_freeNodes(psInner->apsChildren[i]);
+    }
+    free(psNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Frees every spare node of oSymTable. */
+
+static void SymTable_freeSpares(SymTable_T oSymTable)
+{
+    struct SymTableLeaf *psSpare;
+
+    assert(oSymTable != NULL);
+
+    while (oSymTable->psSpares != NULL) {
+        psSpare = oSymTable->psSpares;
+        oSymTable->psSpares = psSpare->psNextLeaf;
+        free(psSpare);
+    }
+    oSymTable->uSpares = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->psRoot = NULL;
+    oSymTable->psFirstLeaf = NULL;
+    oSymTable->uHeight = 0;
+    oSymTable->symTableLength = 0;
+    oSymTable->psSpares = NULL;
+    oSymTable->uSpares = 0;
+    oSymTable->iBorrowsKeys = 0;
+    SymArena_init(&oSymTable->sArena);
+    oSymTable->ulVersion = 0;
+    oSymTable->psFirstIter = NULL;
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The tree compares keys instead of hashing them, so pfHash is not
+   used. */
+
+SymTable_T SymTable_newWithHash(SymTable_HashFunction pfHash)
+{
+    assert(pfHash != NULL);
+
+    return SymTable_new();
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    if (!SymTable_reserve(oSymTable, uCapacity))
+    {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithBorrowedKeys(void)
+{
+    SymTable_T oSymTable;
+
+    oSymTable = SymTable_new();
+    if (oSymTable == NULL)
+        return NULL;
+
+    oSymTable->iBorrowsKeys = 1;
+    return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Room is made for the nodes that the bindings need if the leaves
+   they fill are half full, and for their keys as in
+   symtablehash.c. */
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity)
+{
+    size_t uAdded;
+    size_t uLeaves;
+
+    assert(oSymTable != NULL);
+
+    if (uCapacity <= oSymTable->symTableLength)
+        return 1;
+
+    uAdded = uCapacity - oSymTable->symTableLength;
+    uLeaves = uAdded / MIN_LEAF_KEYS + 1;
+    if (!SymTable_addSpares(oSymTable, uLeaves +
+            uLeaves / (MIN_INNER_KEYS + 1) + oSymTable->uHeight + 1))
+        return 0;
+
+    if (oSymTable->iBorrowsKeys)
+        return 1;
+    return SymArena_reserve(&oSymTable->sArena,
+        uAdded * SymArena_slabBytes(RESERVED_KEY_LENGTH + 1));
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter, *psNextIter;
+
+    assert(oSymTable != NULL);
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psNextIter)
+    {
+        psNextIter = psIter->psNextIter;
+        free(psIter);
+    }
+
+    /* Every key lives in the arena, so the leaves need not be
+       searched for them. */
+    SymArena_freeAll(&oSymTable->sArena);
+
+    if (oSymTable->psRoot != NULL)
+        SymTable_freeNodes(oSymTable->psRoot);
+    SymTable_freeSpares(oSymTable);
+    free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    return oSymTable->symTableLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf of oSymTable that holds, or would hold, the uLength
+   characters at pcKey, whose prefix is uPrefix, or NULL if the table
+   is empty. Sets *puIndex to the index in that leaf of the first key
+   that is not less than them, and *piFound to 1 if that key is equal
+   to them, or to 0 otherwise. */
+
+static struct SymTableLeaf *SymTable_find(SymTable_T oSymTable,
+size_t uPrefix, const char *pcKey, size_t uLength, size_t *puIndex,
+int *piFound)
+{
+    struct SymTableNode *psNode;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(puIndex != NULL);
+    assert(piFound != NULL);
+
+    *piFound = 0;
+    psNode = oSymTable->psRoot;
+    if (psNode == NULL)
+        return NULL;
+
+    while (!psNode->iLeaf)
+        psNode = ((struct SymTableInner *)psNode)->apsChildren[
+            SymTable_child(psNode, uPrefix, pcKey, uLength)];
+
+    *puIndex = SymTable_search(psNode, uPrefix, pcKey, uLength,
+                               piFound);
+    return (struct SymTableLeaf *)psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a pointer to the value of the binding in oSymTable whose key
+   is the uLength characters at pcKey, or NULL if there is none. */
+
+static void **SymTable_lookup(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t uIndex;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psLeaf = SymTable_find(oSymTable, SymTable_prefix(pcKey, uLength),
+                           pcKey, uLength, &uIndex, &iFound);
+    if (!iFound)
+        return NULL;
+    return &psLeaf->apvValues[uIndex];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Adds a binding with the uLength characters at pcKey, whose prefix is
+   uPrefix, as its key and pvValue as its value at index uIndex of
+   leaf apsPath[uDepth] of oSymTable, where apsPath[0] is the root and
+   each apsPath[d + 1] is child auChild[d] of apsPath[d]. Splits every
+   full node on the path that it has to, taking the new nodes from the
+   spare nodes. Returns a pointer to the value of the new binding. */
+
+static void **SymTable_insert(SymTable_T oSymTable,
+struct SymTableNode *apsPath[], size_t auChild[], size_t uDepth,
+size_t uIndex, size_t uPrefix, char *pcKey, size_t uLength,
+const void *pvValue)
+{
+    struct SymTableLeaf *psLeaf;
+    struct SymTableLeaf *psNewLeaf;
+    struct SymTableInner *psParent;
+    struct SymTableInner *psNewInner;
+    struct SymTableInner *psTarget;
+    struct SymTableNode *psNew;
+    void **ppvValue;
+    size_t uHalf;
+    size_t uSepPrefix, uSepLength;
+    size_t uUpPrefix, uUpLength;
+    char *pcSepKey;
+    char *pcUpKey;
+    size_t d, i;
+
+    assert(oSymTable != NULL);
+    assert(apsPath != NULL);
+    assert(auChild != NULL);
+
+    /* Add the binding to its leaf, first splitting the leaf in half
+       if it is full. */
+    psLeaf = (struct SymTableLeaf *)apsPath[uDepth];
+    psNew = NULL;
+    if (psLeaf->sNode.uCount == SYMTABLE_NODE_KEYS) {
+        uHalf = SYMTABLE_NODE_KEYS / 2;
+        psNewLeaf = (struct SymTableLeaf *)SymTable_takeNode(oSymTable,
+                                                             1);
+        SymTable_moveKeys(&psNewLeaf->sNode, 0, &psLeaf->sNode, uHalf,
+                          SYMTABLE_NODE_KEYS - uHalf);
+        memcpy(psNewLeaf->apvValues, psLeaf->apvValues + uHalf,
+               (SYMTABLE_NODE_KEYS - uHalf) * sizeof(void *));
+        psNewLeaf->sNode.uCount = SYMTABLE_NODE_KEYS - uHalf;
+        psLeaf->sNode.uCount = uHalf;
+        psNewLeaf->psNextLeaf = psLeaf->psNextLeaf;
+        psLeaf->psNextLeaf = psNewLeaf;
+
+        if (uIndex > uHalf) {
+            psLeaf = psNewLeaf;
+            uIndex -= uHalf;
+        }
+        psNew = &psNewLeaf->sNode;
+    }
+    SymTable_openGap(&psLeaf->sNode, uIndex);
+    SymTable_setKey(&psLeaf->sNode, uIndex, uPrefix, pcKey, uLength);
+    psLeaf->apvValues[uIndex] = (void *)pvValue;
+    ppvValue = &psLeaf->apvValues[uIndex];
+
+    /* Add each new node, separated by its least key, to the parent of
+       the node it was split from, splitting the parent in turn if it
+       is full. */
+    if (psNew != NULL) {
+        uSepPrefix = psNew->auPrefix[0];
+        uSepLength = psNew->auLength[0];
+        pcSepKey = psNew->apcKeys[0];
+    }
+    for (d = uDepth; psNew != NULL && d > 0; d--) {
+        psParent = (struct SymTableInner *)apsPath[d - 1];
+        i = auChild[d - 1];
+        psTarget = psParent;
+        psNewInner = NULL;
+
+        if (psParent->sNode.uCount == SYMTABLE_NODE_KEYS) {
+            /* The middle key moves up to separate the halves. */
+            uHalf = SYMTABLE_NODE_KEYS / 2;
+            psNewInner = (struct SymTableInner *)SymTable_takeNode(
+                oSymTable, 0);
+            SymTable_moveKeys(&psNewInner->sNode, 0, &psParent->sNode,
+                              uHalf + 1,
+                              SYMTABLE_NODE_KEYS - uHalf - 1);
+            memcpy(psNewInner->apsChildren,
+                   psParent->apsChildren + uHalf + 1,
+                   (SYMTABLE_NODE_KEYS - uHalf) *
+                   sizeof(struct SymTableNode *));
+            psNewInner->sNode.uCount = SYMTABLE_NODE_KEYS - uHalf - 1;
+            psParent->sNode.uCount = uHalf;
+            uUpPrefix = psParent->sNode.auPrefix[uHalf];
+            uUpLength = psParent->sNode.auLength[uHalf];
+            pcUpKey = psParent->sNode.apcKeys[uHalf];
+
+            if (i > uHalf) {
+                psTarget = psNewInner;
+                i -= uHalf + 1;
+            }
+        }
+
+        SymTable_openGap(&psTarget->sNode, i);
+        SymTable_setKey(&psTarget->sNode, i, uSepPrefix, pcSepKey,
+                        uSepLength);
+        psTarget->apsChildren[i + 1] = psNew;
+
+        psNew = NULL;
+        if (psNewInner != NULL) {
+            uSepPrefix = uUpPrefix;
+            uSepLength = uUpLength;
+            pcSepKey = pcUpKey;
+            psNew = &psNewInner->sNode;
+        }
+    }
+
+    /* A split root gets a new root above it. */
+    if (psNew != NULL) {
+        psNewInner = (struct SymTableInner *)SymTable_takeNode(
+            oSymTable, 0);
+        SymTable_setKey(&psNewInner->sNode, 0, uSepPrefix, pcSepKey,
+                        uSepLength);
+        psNewInner->sNode.uCount = 1;
+        psNewInner->apsChildren[0] = oSymTable->psRoot;
+        psNewInner->apsChildren[1] = psNew;
+        oSymTable->psRoot = &psNewInner->sNode;
+        oSymTable->uHeight++;
+        assert(oSymTable->uHeight < MAX_HEIGHT);
+    }
+
+    return ppvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Looks up the binding in oSymTable whose key is the uLength
+   characters at pcKey, adding a new binding with that key and value
+   pvValue if none exists, walking the tree only once. Returns a
+   pointer to the value of the binding and sets *piAdded to 1 if it
+   was added or 0 if it already existed. Returns NULL, leaving the
+   bindings of oSymTable unchanged, if insufficient memory is
+   available. */
+
+static void **SymTable_findOrInsert(SymTable_T oSymTable,
+const char *pcKey, size_t uLength, const void *pvValue, int *piAdded)
+{
+    struct SymTableNode *apsPath[MAX_HEIGHT];
+    size_t auChild[MAX_HEIGHT];
+    struct SymTableNode *psNode;
+    size_t uPrefix;
+    size_t uDepth = 0;
+    size_t uIndex = 0;
+    char *pcKeyCopy;
+    int iFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piAdded != NULL);
+
+    uPrefix = SymTable_prefix(pcKey, uLength);
+    psNode = oSymTable->psRoot;
+    if (psNode != NULL) {
+        while (!psNode->iLeaf) {
+            apsPath[uDepth] = psNode;
+            auChild[uDepth] = SymTable_child(psNode, uPrefix, pcKey,
+                                             uLength);
+            psNode = ((struct SymTableInner *)psNode)->apsChildren[
+                auChild[uDepth]];
+            uDepth++;
+        }
+        uIndex = SymTable_search(psNode, uPrefix, pcKey, uLength,
+                                 &iFound);
+        if (iFound) {
+            *piAdded = 0;
+            return &((struct SymTableLeaf *)psNode)->apvValues[uIndex];
+        }
+    }
+
+    /* Every node on the path, and the root, may have to split. */
+    if (!SymTable_addSpares(oSymTable, oSymTable->uHeight + 1))
+        return NULL;
+
+    if (oSymTable->iBorrowsKeys)
+        pcKeyCopy = (char *)pcKey;
+    else
+    {
+        pcKeyCopy = (char *)SymArena_alloc(&oSymTable->sArena,
+                                           uLength + 1);
+        if (pcKeyCopy == NULL)
+            return NULL;
+        memcpy(pcKeyCopy, pcKey, uLength);
+        pcKeyCopy[uLength] = '\0';
+    }
+
+    if (psNode == NULL) {
+        psNode = SymTable_takeNode(oSymTable, 1);
+        oSymTable->psRoot = psNode;
+        oSymTable->psFirstLeaf = (struct SymTableLeaf *)psNode;
+        oSymTable->uHeight = 1;
+    }
+    apsPath[uDepth] = psNode;
+
+    oSymTable->symTableLength++;
+    oSymTable->ulVersion++;
+
+    *piAdded = 1;
+    return SymTable_insert(oSymTable, apsPath, auChild, uDepth, uIndex,
+                           uPrefix, pcKeyCopy, uLength, pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (SymTable_findOrInsert(oSymTable, pcKey, uLength, pvValue,
+                              &iAdded) == NULL)
+        return 0;
+
+    return iAdded;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putN(oSymTable, oAtom->acName, oAtom->uLength,
+                         pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGet(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putOrGetN(oSymTable, pcKey, strlen(pcKey), pvValue,
+                              piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue, int *piAdded)
+{
+    void **ppvValue;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    ppvValue = SymTable_findOrInsert(oSymTable, pcKey, uLength, pvValue,
+                                     &iAdded);
+    if (ppvValue == NULL)
+        return NULL;
+
+    if (piAdded != NULL)
+        *piAdded = iAdded;
+    return ppvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_putOrGetAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue, int *piAdded)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_putOrGetN(oSymTable, oAtom->acName, oAtom->uLength,
+                              pvValue, piAdded);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putBulk(SymTable_T oSymTable, const char *apcKeys[],
+const void *apvValues[], size_t uCount)
+{
+    char *pcAdded;
+    size_t uKeyBytes = 0;
+    size_t i;
+    int iAdded;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+
+    if (uCount == 0)
+        return 1;
+
+    /* Remembers which keys this call added, to undo them if a later
+       allocation fails. */
+    pcAdded = (char*)calloc(uCount, sizeof(char));
+    if (pcAdded == NULL)
+        return 0;
+
+    /* Carve every key out of one block of the arena, and take the
+       nodes that the inserts need from the spare nodes. */
+    for (i = (size_t)0; i < uCount && !oSymTable->iBorrowsKeys; i++)
+    {
+        assert(apcKeys[i] != NULL);
+        uKeyBytes += SymArena_slabBytes(strlen(apcKeys[i]) + 1);
+    }
+    if (!SymArena_reserve(&oSymTable->sArena, uKeyBytes) ||
+        !SymTable_reserve(oSymTable,
+                          oSymTable->symTableLength + uCount))
+    {
+        free(pcAdded);
+        return 0;
+    }
+
+    for (i = (size_t)0; i < uCount; i++)
+    {
+        if (SymTable_findOrInsert(oSymTable, apcKeys[i],
+                strlen(apcKeys[i]),
+                apvValues == NULL ? NULL : apvValues[i], &iAdded)
+            == NULL)
+        {
+            while (i-- > 0)
+                if (pcAdded[i])
+                    (void)SymTable_remove(oSymTable, apcKeys[i]);
+            free(pcAdded);
+            return 0;
+        }
+        pcAdded[i] = (char)iAdded;
+    }
+
+    free(pcAdded);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTable that holds the bindings of oSymTable in as few
+   nodes as it can, with its keys copied into a single slab of its
+   arena unless oSymTable borrows its keys, or NULL if insufficient
+   memory is available. */
+
+static SymTable_T SymTable_pack(SymTable_T oSymTable)
+{
+    SymTable_T oPacked;
+    struct SymTableNode **ppsLevel;
+    struct SymTableLeaf **ppsLeftmost;
+    struct SymTableLeaf *psLeaf;
+    struct SymTableLeaf *psNewLeaf;
+    struct SymTableLeaf *psPrevLeaf = NULL;
+    struct SymTableInner *psInner;
+    size_t uNodes, uParents, uWidth, uTaken, uTotal;
+    size_t uKeyBytes = 0;
+    size_t uLength;
+    size_t i, j, k;
+    char *pcKeyCopy;
+
+    assert(oSymTable != NULL);
+
+    oPacked = SymTable_new();
+    if (oPacked == NULL)
+        return NULL;
+    oPacked->iBorrowsKeys = oSymTable->iBorrowsKeys;
+    if (oSymTable->symTableLength == 0)
+        return oPacked;
+
+    /* Allocate every node of the packed tree, and room for every key,
+       before anything is copied. */
+    uNodes = (oSymTable->symTableLength + SYMTABLE_NODE_KEYS - 1) /
+        SYMTABLE_NODE_KEYS;
+    for (uParents = uNodes, uTotal = uNodes; uParents > 1;
+         uTotal += uParents)
+        uParents = (uParents + SYMTABLE_NODE_KEYS) /
+            (SYMTABLE_NODE_KEYS + 1);
+    for (psLeaf = oSymTable->psFirstLeaf;
+         psLeaf != NULL && !oSymTable->iBorrowsKeys;
+         psLeaf = psLeaf->psNextLeaf)
+        for (k = (size_t)0; k < psLeaf->sNode.uCount; k++)
+            uKeyBytes += SymArena_slabBytes(
+                psLeaf->sNode.auLength[k] + 1);
+
+    ppsLevel = (struct SymTableNode **)malloc(
+        uNodes * sizeof(struct SymTableNode *));
+    ppsLeftmost = (struct SymTableLeaf **)malloc(
+        uNodes * sizeof(struct SymTableLeaf *));
+    if (ppsLevel == NULL || ppsLeftmost == NULL ||
+        !SymTable_addSpares(oPacked, uTotal) ||
+        !SymArena_reserve(&oPacked->sArena, uKeyBytes))
+    {
+        free(ppsLevel);
+        free(ppsLeftmost);
+        SymTable_free(oPacked);
+        return NULL;
+    }
+
+    /* Fill the leaves as evenly as the bindings allow. */
+    psLeaf = oSymTable->psFirstLeaf;
+    k = 0;
+    for (i = (size_t)0, uTaken = 0; i < uNodes; i++)
+    {
+        uWidth = (oSymTable->symTableLength * (i + 1)) / uNodes -
+            uTaken;
+        uTaken += uWidth;
+        psNewLeaf = (struct SymTableLeaf *)SymTable_takeNode(oPacked,
+                                                             1);
+        for (j = (size_t)0; j < uWidth; j++)
+        {
+            if (k == psLeaf->sNode.uCount)
+            {
+                psLeaf = psLeaf->psNextLeaf;
+                k = 0;
+            }
+            uLength = psLeaf->sNode.auLength[k];
+            pcKeyCopy = psLeaf->sNode.apcKeys[k];
+            if (!oSymTable->iBorrowsKeys)
+            {
+                /* Only keys too long for a slab can fail here. */
+                pcKeyCopy = (char *)SymArena_alloc(&oPacked->sArena,
+                                                   uLength + 1);
+                if (pcKeyCopy == NULL)
+                {
+                    free(psNewLeaf);
+                    while (i-- > 0)
+                        free(ppsLevel[i]);
+                    free(ppsLevel);
+                    free(ppsLeftmost);
+                    SymTable_free(oPacked);
+                    return NULL;
+                }
+                memcpy(pcKeyCopy, psLeaf->sNode.apcKeys[k],
+                       uLength + 1);
+            }
+            SymTable_setKey(&psNewLeaf->sNode, j,
+                            psLeaf->sNode.auPrefix[k], pcKeyCopy,
+                            uLength);
+            psNewLeaf->apvValues[j] = psLeaf->apvValues[k];
+            k++;
+        }
+        psNewLeaf->sNode.uCount = uWidth;
+        if (psPrevLeaf == NULL)
+            oPacked->psFirstLeaf = psNewLeaf;
+        else
+            psPrevLeaf->psNextLeaf = psNewLeaf;
+        psPrevLeaf = psNewLeaf;
+        ppsLevel[i] = &psNewLeaf->sNode;
+        ppsLeftmost[i] = psNewLeaf;
+    }
+    oPacked->uHeight = 1;
+
+    /* Build each level of inner nodes over the one below, until a
+       single node is left as the root. */
+    while (uNodes > 1)
+    {
+        uParents = (uNodes + SYMTABLE_NODE_KEYS) /
+            (SYMTABLE_NODE_KEYS + 1);
+        for (i = (size_t)0, uTaken = 0; i < uParents; i++)
+        {
+            uWidth = (uNodes * (i + 1)) / uParents - uTaken;
+            psInner = (struct SymTableInner *)SymTable_takeNode(oPacked,
+                                                                0);
+            for (j = (size_t)0; j < uWidth; j++)
+            {
+                psInner->apsChildren[j] = ppsLevel[uTaken + j];
+                if (j > 0)
+                {
+                    psNewLeaf = ppsLeftmost[uTaken + j];
+                    SymTable_setKey(&psInner->sNode, j - 1,
+                                    psNewLeaf->sNode.auPrefix[0],
+                                    psNewLeaf->sNode.apcKeys[0],
+                                    psNewLeaf->sNode.auLength[0]);
+                }
+            }
+            psInner->sNode.uCount = uWidth - 1;
+            ppsLeftmost[i] = ppsLeftmost[uTaken];
+            ppsLevel[i] = &psInner->sNode;
+            uTaken += uWidth;
+        }
+        uNodes = uParents;
+        oPacked->uHeight++;
+    }
+
+    oPacked->psRoot = ppsLevel[0];
+    oPacked->symTableLength = oSymTable->symTableLength;
+    free(ppsLevel);
+    free(ppsLeftmost);
+    return oPacked;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The bindings are packed into a new tree, whose nodes and keys then
+   take the place of the old ones. */
+
+int SymTable_compact(SymTable_T oSymTable)
+{
+    SymTable_T oPacked;
+    struct SymTableIter *psIter;
+    struct SymTableLeaf *psLeaf;
+    size_t uIndex;
+    int iFound;
+
+    assert(oSymTable != NULL);
+
+    oPacked = SymTable_pack(oSymTable);
+    if (oPacked == NULL)
+        return 0;
+
+    /* Point every iterator at its key's copy in the packed tree,
+       while the old copy can still be read. */
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+    {
+        if (psIter->iState != ITER_AT && psIter->iState != ITER_PENDING)
+            continue;
+        psLeaf = SymTable_find(oPacked,
+            SymTable_prefix(psIter->pcKey, psIter->uLength),
+            psIter->pcKey, psIter->uLength, &uIndex, &iFound);
+        assert(iFound);
+        psIter->pcKey = psLeaf->sNode.apcKeys[uIndex];
+    }
+
+    if (oSymTable->psRoot != NULL)
+        SymTable_freeNodes(oSymTable->psRoot);
+    SymTable_freeSpares(oSymTable);
+    SymArena_freeAll(&oSymTable->sArena);
+
+    oSymTable->psRoot = oPacked->psRoot;
+    oSymTable->psFirstLeaf = oPacked->psFirstLeaf;
+    oSymTable->uHeight = oPacked->uHeight;
+    oSymTable->sArena = oPacked->sArena;
+    oSymTable->ulVersion++;
+
+    /* Every node of the packed tree was used, so only its structure
+       is left to free. */
+    assert(oPacked->psSpares == NULL);
+    free(oPacked);
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable, const char *pcKey,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength, const void *pvValue)
+{
+    void **ppvValue;
+    void *pvPrevValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    ppvValue = SymTable_lookup(oSymTable, pcKey, uLength);
+    if (ppvValue == NULL)
+        return NULL;
+
+    pvPrevValue = *ppvValue;
+    *ppvValue = (void *)pvValue;
+    return pvPrevValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceAtom(SymTable_T oSymTable, SymAtom_T oAtom,
+const void *pvValue)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_replaceN(oSymTable, oAtom->acName, oAtom->uLength,
+                             pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_lookup(oSymTable, pcKey, uLength) != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_containsN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    void **ppvValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    ppvValue = SymTable_lookup(oSymTable, pcKey, uLength);
+    if (ppvValue == NULL)
+        return NULL;
+    return *ppvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_getN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Every leaf is at the same depth, so the lookups of a group descend
+   the tree in step: each takes one level at a time and prefetches the
+   node that it reaches, before any takes the next level. */
+
+size_t SymTable_getBatch(SymTable_T oSymTable, const char *apcKeys[],
+size_t uCount, void *apvValues[])
+{
+    struct SymTableNode *apsNode[SYMPREFETCH_GROUP];
+    size_t auPrefix[SYMPREFETCH_GROUP];
+    size_t auLength[SYMPREFETCH_GROUP];
+    struct SymTableNode *psNode;
+    size_t uStart, uGroup, i, uIndex;
+    size_t uFound = 0;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL);
+    assert(apvValues != NULL);
+
+    for (uStart = 0; uStart < uCount; uStart += uGroup) {
+        uGroup = uCount - uStart < SYMPREFETCH_GROUP ?
+            uCount - uStart : SYMPREFETCH_GROUP;
+
+        for (i = 0; i < uGroup; i++) {
+            assert(apcKeys[uStart + i] != NULL);
+            auLength[i] = strlen(apcKeys[uStart + i]);
+            auPrefix[i] = SymTable_prefix(apcKeys[uStart + i],
+                                          auLength[i]);
+            apsNode[i] = oSymTable->psRoot;
+            apvValues[uStart + i] = NULL;
+        }
+        if (oSymTable->psRoot == NULL)
+            continue;
+
+        while (!apsNode[0]->iLeaf)
+            for (i = 0; i < uGroup; i++) {
+                psNode = ((struct SymTableInner *)apsNode[i])->
+                    apsChildren[SymTable_child(apsNode[i], auPrefix[i],
+                        apcKeys[uStart + i], auLength[i])];
+                SYMPREFETCH(psNode);
+                SYMPREFETCH(psNode->auPrefix + SYMTABLE_NODE_KEYS / 2);
+                apsNode[i] = psNode;
+            }
+
+        for (i = 0; i < uGroup; i++) {
+            uIndex = SymTable_search(apsNode[i], auPrefix[i],
+                apcKeys[uStart + i], auLength[i], &iFound);
+            if (iFound) {
+                apvValues[uStart + i] =
+                    ((struct SymTableLeaf *)apsNode[i])->
+                    apvValues[uIndex];
+                uFound++;
+            }
+        }
+    }
+
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves a key from a sibling of node apsPath[uDepth] of oSymTable, or
+   merges the node with a sibling, if the node has too few keys, and
+   then does the same for its parent if the merge left the parent with
+   too few keys, and so on up the path, as described in
+   SymTable_insert. Collapses a root that is left with a single child,
+   and frees a root leaf that is left empty. */
+
+static void SymTable_rebalance(SymTable_T oSymTable,
+struct SymTableNode *apsPath[], size_t auChild[], size_t uDepth)
+{
+    struct SymTableNode *psNode;
+    struct SymTableNode *psLeft;
+    struct SymTableNode *psRight;
+    struct SymTableInner *psParent;
+    struct SymTableInner *psInner;
+    struct SymTableInner *psSibling;
+    size_t uMin;
+    size_t i;
+
+    assert(oSymTable != NULL);
+
+    for (;;) {
+        psNode = apsPath[uDepth];
+        if (uDepth == 0) {
+            if (psNode->uCount > 0)
+                return;
+            if (psNode->iLeaf) {
+                oSymTable->psRoot = NULL;
+                oSymTable->psFirstLeaf = NULL;
+            }
+            else
+                oSymTable->psRoot =
+                    ((struct SymTableInner *)psNode)->apsChildren[0];
+            oSymTable->uHeight--;
+            free(psNode);
+            return;
+        }
+
+        uMin = psNode->iLeaf ? MIN_LEAF_KEYS : MIN_INNER_KEYS;
+        if (psNode->uCount >= uMin)
+            return;
+
+        psParent = (struct SymTableInner *)apsPath[uDepth - 1];
+        i = auChild[uDepth - 1];
+
+        /* Move the last key of the left sibling into the node. */
+        if (i > 0 && psParent->apsChildren[i - 1]->uCount > uMin) {
+            psLeft = psParent->apsChildren[i - 1];
+            if (psNode->iLeaf) {
+                SymTable_openGap(psNode, 0);
+                SymTable_moveKeys(psNode, 0, psLeft,
+                                  psLeft->uCount - 1, 1);
+                ((struct SymTableLeaf *)psNode)->apvValues[0] =
+                    ((struct SymTableLeaf *)psLeft)->apvValues[
+                        psLeft->uCount - 1];
+                SymTable_moveKeys(&psParent->sNode, i - 1, psNode, 0,
+                                  1);
+            } else {
+                psInner = (struct SymTableInner *)psNode;
+                psSibling = (struct SymTableInner *)psLeft;
+                SymTable_moveKeys(psNode, 1, psNode, 0,
+                                  psNode->uCount);
+                memmove(psInner->apsChildren + 1, psInner->apsChildren,
+                        (psNode->uCount + 1) *
+                        sizeof(struct SymTableNode *));
+                psNode->uCount++;
+                SymTable_moveKeys(psNode, 0, &psParent->sNode, i - 1,
+                                  1);
+                psInner->apsChildren[0] =
+                    psSibling->apsChildren[psLeft->uCount];
+                SymTable_moveKeys(&psParent->sNode, i - 1, psLeft,
+                                  psLeft->uCount - 1, 1);
+            }
+            psLeft->uCount--;
+            return;
+        }
+
+        /* Move the first key of the right sibling into the node. */
+        if (i < psParent->sNode.uCount &&
+            psParent->apsChildren[i + 1]->uCount > uMin) {
+            psRight = psParent->apsChildren[i + 1];
+            if (psNode->iLeaf) {
+                SymTable_moveKeys(psNode, psNode->uCount, psRight, 0,
+                                  1);
+                ((struct SymTableLeaf *)psNode)->apvValues[
+                    psNode->uCount] =
+                    ((struct SymTableLeaf *)psRight)->apvValues[0];
+                psNode->uCount++;
+                SymTable_closeGap(psRight, 0);
+                SymTable_moveKeys(&psParent->sNode, i, psRight, 0, 1);
+            } else {
+                psInner = (struct SymTableInner *)psNode;
+                psSibling = (struct SymTableInner *)psRight;
+                SymTable_moveKeys(psNode, psNode->uCount,
+                                  &psParent->sNode, i, 1);
+                psInner->apsChildren[psNode->uCount + 1] =
+                    psSibling->apsChildren[0];
+                psNode->uCount++;
+                SymTable_moveKeys(&psParent->sNode, i, psRight, 0, 1);
+                SymTable_moveKeys(psRight, 0, psRight, 1,
+                                  psRight->uCount - 1);
+                memmove(psSibling->apsChildren,
+                        psSibling->apsChildren + 1,
+                        psRight->uCount *
+                        sizeof(struct SymTableNode *));
+                psRight->uCount--;
+            }
+            return;
+        }
+
+        /* Merge the node with a sibling, keeping the left one. */
+        if (i > 0)
+            i--;
+        psLeft = psParent->apsChildren[i];
+        psRight = psParent->apsChildren[i + 1];
+        if (psLeft->iLeaf) {
+            SymTable_moveKeys(psLeft, psLeft->uCount, psRight, 0,
+                              psRight->uCount);
+            memcpy(((struct SymTableLeaf *)psLeft)->apvValues +
+                   psLeft->uCount,
+                   ((struct SymTableLeaf *)psRight)->apvValues,
+                   psRight->uCount * sizeof(void *));
+            ((struct SymTableLeaf *)psLeft)->psNextLeaf =
+                ((struct SymTableLeaf *)psRight)->psNextLeaf;
+        } else {
+            SymTable_moveKeys(psLeft, psLeft->uCount, &psParent->sNode,
+                              i, 1);
+            SymTable_moveKeys(psLeft, psLeft->uCount + 1, psRight, 0,
+                              psRight->uCount);
+            memcpy(((struct SymTableInner *)psLeft)->apsChildren +
+                   psLeft->uCount + 1,
+                   ((struct SymTableInner *)psRight)->apsChildren,
+                   (psRight->uCount + 1) *
+                   sizeof(struct SymTableNode *));
+            psLeft->uCount++;
+        }
+        psLeft->uCount += psRight->uCount;
+        assert(psLeft->uCount <= SYMTABLE_NODE_KEYS);
+        SymTable_closeGap(&psParent->sNode, i);
+        free(psRight);
+
+        uDepth--;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replaces the separator key of oSymTable that is the uLength
+   characters at pcKey, whose prefix is uPrefix, and whose binding has
+   just been removed, if there is one, with the least key that remains
+   in the subtree it separates. */
+
+static void SymTable_replaceSeparator(SymTable_T oSymTable,
+size_t uPrefix, const char *pcKey, size_t uLength)
+{
+    struct SymTableNode *psNode;
+    struct SymTableNode *psLeast;
+    size_t uIndex;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    psNode = oSymTable->psRoot;
+    while (psNode != NULL && !psNode->iLeaf) {
+        uIndex = SymTable_search(psNode, uPrefix, pcKey, uLength,
+                                 &iFound);
+        if (iFound) {
+            psLeast = ((struct SymTableInner *)psNode)->apsChildren[
+                uIndex + 1];
+            while (!psLeast->iLeaf)
+                psLeast =
+                    ((struct SymTableInner *)psLeast)->apsChildren[0];
+            SymTable_moveKeys(psNode, uIndex, psLeast, 0, 1);
+            return;
+        }
+        psNode = ((struct SymTableInner *)psNode)->apsChildren[uIndex];
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Moves every iterator of oSymTable that is positioned at the key
+   pcKey, or about to visit it, to the key after it, in leaf psLeaf at
+   index uIndex, before that binding is removed. */
+
+static void SymTable_skipKey(SymTable_T oSymTable,
+struct SymTableLeaf *psLeaf, size_t uIndex)
+{
+    struct SymTableIter *psIter;
+    struct SymTableLeaf *psNextLeaf;
+    const char *pcKey;
+    size_t uNext;
+
+    assert(oSymTable != NULL);
+    assert(psLeaf != NULL);
+
+    pcKey = psLeaf->sNode.apcKeys[uIndex];
+    psNextLeaf = psLeaf;
+    uNext = uIndex + 1;
+    if (uNext == psLeaf->sNode.uCount) {
+        psNextLeaf = psLeaf->psNextLeaf;
+        uNext = 0;
+    }
+
+    for (psIter = oSymTable->psFirstIter; psIter != NULL;
+         psIter = psIter->psNextIter)
+    {
+        if ((psIter->iState != ITER_AT &&
+             psIter->iState != ITER_PENDING) || psIter->pcKey != pcKey)
+            continue;
+        if (psNextLeaf == NULL) {
+            psIter->iState = ITER_DONE;
+            psIter->pcKey = NULL;
+        } else {
+            psIter->iState = ITER_PENDING;
+            psIter->pcKey = psNextLeaf->sNode.apcKeys[uNext];
+            psIter->uLength = psNextLeaf->sNode.auLength[uNext];
+        }
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+size_t uLength)
+{
+    struct SymTableNode *apsPath[MAX_HEIGHT];
+    size_t auChild[MAX_HEIGHT];
+    struct SymTableNode *psNode;
+    struct SymTableLeaf *psLeaf;
+    size_t uPrefix;
+    size_t uDepth = 0;
+    size_t uIndex;
+    char *pcOldKey;
+    size_t uOldLength;
+    void *pvValue;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    uPrefix = SymTable_prefix(pcKey, uLength);
+    psNode = oSymTable->psRoot;
+    if (psNode == NULL)
+        return NULL;
+    while (!psNode->iLeaf) {
+        apsPath[uDepth] = psNode;
+        auChild[uDepth] = SymTable_child(psNode, uPrefix, pcKey,
+                                         uLength);
+        psNode = ((struct SymTableInner *)psNode)->apsChildren[
+            auChild[uDepth]];
+        uDepth++;
+    }
+    apsPath[uDepth] = psNode;
+
+    uIndex = SymTable_search(psNode, uPrefix, pcKey, uLength, &iFound);
+    if (!iFound)
+        return NULL;
+
+    psLeaf = (struct SymTableLeaf *)psNode;
+    pcOldKey = psNode->apcKeys[uIndex];
+    uOldLength = psNode->auLength[uIndex];
+    pvValue = psLeaf->apvValues[uIndex];
+
+    if (oSymTable->psFirstIter != NULL)
+        SymTable_skipKey(oSymTable, psLeaf, uIndex);
+
+    SymTable_closeGap(psNode, uIndex);
+    SymTable_rebalance(oSymTable, apsPath, auChild, uDepth);
+
+    /* The least key of a leaf may also be a separator, which must not
+       outlive its binding. */
+    if (uIndex == 0)
+        SymTable_replaceSeparator(oSymTable, uPrefix, pcOldKey,
+                                  uOldLength);
+
+    if (!oSymTable->iBorrowsKeys)
+        SymArena_release(&oSymTable->sArena, pcOldKey, uOldLength + 1);
+
+    oSymTable->symTableLength--;
+    oSymTable->ulVersion++;
+    return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeAtom(SymTable_T oSymTable, SymAtom_T oAtom)
+{
+    assert(oSymTable != NULL);
+    assert(oAtom != NULL);
+
+    return SymTable_removeN(oSymTable, oAtom->acName, oAtom->uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The leaves are walked in order, so the bindings are visited in
+   ascending order of their keys. */
+
+void SymTable_map(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t i;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (psLeaf = oSymTable->psFirstLeaf; psLeaf != NULL;
+         psLeaf = psLeaf->psNextLeaf)
+        for (i = (size_t)0; i < psLeaf->sNode.uCount; i++)
+            (*pfApply)(psLeaf->sNode.apcKeys[i], psLeaf->apvValues[i],
+                       (void *)pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getShardCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapShard(SymTable_T oSymTable, size_t uShard,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    assert(oSymTable != NULL);
+    assert(uShard == 0);
+    assert(pfApply != NULL);
+
+    SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Applies the function of pvJob, a SymTableMapJob, to the bindings
+   of leaves uBegin up to uEnd, with extra parameter pvPart. */
+
+static void SymTable_mapSlice(void *pvJob, size_t uBegin, size_t uEnd,
+void *pvPart)
+{
+    struct SymTableMapJob *psJob = (struct SymTableMapJob *)pvJob;
+    struct SymTableLeaf *psLeaf;
+    size_t i, j;
+
+    assert(psJob != NULL);
+
+    for (i = uBegin; i < uEnd; i++)
+    {
+        psLeaf = psJob->ppsLeaves[i];
+        for (j = (size_t)0; j < psLeaf->sNode.uCount; j++)
+            (*psJob->pfApply)(psLeaf->sNode.apcKeys[j],
+                              psLeaf->apvValues[j], pvPart);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The leaves are first gathered into an array, so that the threads
+   can start their ranges without walking the leaves. */
+
+int SymTable_mapParallel(SymTable_T oSymTable,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+void *pvExtra, size_t uThreads, size_t uPartSize,
+void (*pfReduce)(void *pvExtra, void *pvPart))
+{
+    struct SymTableMapJob sJob;
+    struct SymTableLeaf *psLeaf;
+    size_t uLeaves = 0;
+    int iSuccess;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    for (psLeaf = oSymTable->psFirstLeaf; psLeaf != NULL;
+         psLeaf = psLeaf->psNextLeaf)
+        uLeaves++;
+
+    sJob.ppsLeaves = (struct SymTableLeaf **)malloc(
+        uLeaves * sizeof(struct SymTableLeaf *));
+    if (sJob.ppsLeaves == NULL && uLeaves > 0)
+        return 0;
+    sJob.pfApply = pfApply;
+
+    uLeaves = 0;
+    for (psLeaf = oSymTable->psFirstLeaf; psLeaf != NULL;
+         psLeaf = psLeaf->psNextLeaf)
+        sJob.ppsLeaves[uLeaves++] = psLeaf;
+
+    iSuccess = SymParallel_run(&sJob, uLeaves, SymTable_mapSlice,
+        uThreads, pvExtra, uPartSize, pfReduce);
+
+    free(sJob.ppsLeaves);
+    return iSuccess;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The walk starts at the leaf where pcLow would be, and stops at the
+   first key past pcHigh. */
+
+void SymTable_mapRange(SymTable_T oSymTable, const char *pcLow,
+const char *pcHigh,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t uHighPrefix = 0;
+    size_t uHighLength = 0;
+    size_t i = 0;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+
+    psLeaf = oSymTable->psFirstLeaf;
+    if (pcLow != NULL)
+        psLeaf = SymTable_find(oSymTable,
+            SymTable_prefix(pcLow, strlen(pcLow)), pcLow, strlen(pcLow),
+            &i, &iFound);
+    if (pcHigh != NULL) {
+        uHighLength = strlen(pcHigh);
+        uHighPrefix = SymTable_prefix(pcHigh, uHighLength);
+    }
+
+    for (; psLeaf != NULL; psLeaf = psLeaf->psNextLeaf, i = 0)
+        for (; i < psLeaf->sNode.uCount; i++) {
+            if (pcHigh != NULL &&
+                SymTable_compare(&psLeaf->sNode, i, uHighPrefix, pcHigh,
+                                 uHighLength) < 0)
+                return;
+            (*pfApply)(psLeaf->sNode.apcKeys[i], psLeaf->apvValues[i],
+                       (void *)pvExtra);
+        }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The keys that start with pcPrefix are the least keys that are at
+   least pcPrefix, so the walk starts where pcPrefix would be, and
+   stops at the first key without it. */
+
+void SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+const void *pvExtra)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t uLength;
+    size_t i = 0;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcPrefix != NULL);
+    assert(pfApply != NULL);
+
+    uLength = strlen(pcPrefix);
+    psLeaf = SymTable_find(oSymTable,
+        SymTable_prefix(pcPrefix, uLength), pcPrefix, uLength, &i,
+        &iFound);
+
+    for (; psLeaf != NULL; psLeaf = psLeaf->psNextLeaf, i = 0)
+        for (; i < psLeaf->sNode.uCount; i++) {
+            if (psLeaf->sNode.auLength[i] < uLength ||
+                memcmp(psLeaf->sNode.apcKeys[i], pcPrefix,
+                       uLength) != 0)
+                return;
+            (*pfApply)(psLeaf->sNode.apcKeys[i], psLeaf->apvValues[i],
+                       (void *)pvExtra);
+        }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the closest key of oSymTable to pcKey that is at least pcKey
+   if iCeiling is 1, or at most pcKey if it is 0, or NULL if there is
+   none, setting *ppvValue, if ppvValue is non-null, to its value. The
+   least key of every leaf but the first is a separator, so a key less
+   than all of its leaf's keys is less than every key of the table. */
+
+static const char *SymTable_bound(SymTable_T oSymTable,
+const char *pcKey, int iCeiling, void **ppvValue)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t uLength;
+    size_t uIndex;
+    int iFound;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    uLength = strlen(pcKey);
+    psLeaf = SymTable_find(oSymTable, SymTable_prefix(pcKey, uLength),
+                           pcKey, uLength, &uIndex, &iFound);
+    if (psLeaf == NULL)
+        return NULL;
+
+    if (iCeiling) {
+        if (uIndex == psLeaf->sNode.uCount) {
+            psLeaf = psLeaf->psNextLeaf;
+            uIndex = 0;
+            if (psLeaf == NULL)
+                return NULL;
+        }
+    } else if (!iFound) {
+        if (uIndex == 0)
+            return NULL;
+        uIndex--;
+    }
+
+    if (ppvValue != NULL)
+        *ppvValue = psLeaf->apvValues[uIndex];
+    return psLeaf->sNode.apcKeys[uIndex];
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_floor(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_bound(oSymTable, pcKey, 0, ppvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_ceiling(SymTable_T oSymTable, const char *pcKey,
+void **ppvValue)
+{
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_bound(oSymTable, pcKey, 1, ppvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableIter_T SymTable_iterBegin(SymTable_T oSymTable)
+{
+    struct SymTableIter *psIter;
+
+    assert(oSymTable != NULL);
+
+    psIter = (struct SymTableIter *)malloc(sizeof(struct SymTableIter));
+    if (psIter == NULL)
+        return NULL;
+
+    psIter->oSymTable = oSymTable;
+    psIter->iState = ITER_BEFORE;
+    psIter->pcKey = NULL;
+    psIter->uLength = 0;
+    psIter->psLeaf = NULL;
+    psIter->uIndex = 0;
+    psIter->ulVersion = oSymTable->ulVersion;
+    psIter->psNextIter = oSymTable->psFirstIter;
+    oSymTable->psFirstIter = psIter;
+
+    return psIter;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Sets the leaf and index of oIter to those of its key, finding the
+   key again if the tree has changed since they were set. */
+
+static void SymTable_locate(SymTableIter_T oIter)
+{
+    SymTable_T oSymTable;
+    int iFound;
+
+    assert(oIter != NULL);
+    assert(oIter->pcKey != NULL);
+
+    oSymTable = oIter->oSymTable;
+    if (oIter->ulVersion == oSymTable->ulVersion)
+        return;
+
+    oIter->psLeaf = SymTable_find(oSymTable,
+        SymTable_prefix(oIter->pcKey, oIter->uLength), oIter->pcKey,
+        oIter->uLength, &oIter->uIndex, &iFound);
+    assert(iFound);
+    oIter->ulVersion = oSymTable->ulVersion;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTableIter_T oIter)
+{
+    struct SymTableLeaf *psLeaf;
+    size_t uIndex;
+
+    assert(oIter != NULL);
+
+    switch (oIter->iState) {
+    case ITER_DONE:
+        return 0;
+    case ITER_BEFORE:
+        psLeaf = oIter->oSymTable->psFirstLeaf;
+        uIndex = 0;
+        break;
+    case ITER_AT:
+        SymTable_locate(oIter);
+        psLeaf = oIter->psLeaf;
+        uIndex = oIter->uIndex + 1;
+        break;
+    default:
+        SymTable_locate(oIter);
+        psLeaf = oIter->psLeaf;
+        uIndex = oIter->uIndex;
+        break;
+    }
+
+    if (psLeaf != NULL && uIndex == psLeaf->sNode.uCount) {
+        psLeaf = psLeaf->psNextLeaf;
+        uIndex = 0;
+    }
+    if (psLeaf == NULL) {
+        oIter->iState = ITER_DONE;
+        oIter->pcKey = NULL;
+        return 0;
+    }
+
+    oIter->iState = ITER_AT;
+    oIter->pcKey = psLeaf->sNode.apcKeys[uIndex];
+    oIter->uLength = psLeaf->sNode.auLength[uIndex];
+    oIter->psLeaf = psLeaf;
+    oIter->uIndex = uIndex;
+    oIter->ulVersion = oIter->oSymTable->ulVersion;
+    return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_iterKey(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->iState == ITER_AT);
+
+    return oIter->pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_iterValue(SymTableIter_T oIter)
+{
+    assert(oIter != NULL);
+    assert(oIter->iState == ITER_AT);
+
+    SymTable_locate(oIter);
+    return oIter->psLeaf->apvValues[oIter->uIndex];
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterFree(SymTableIter_T oIter)
+{
+    struct SymTableIter **ppsLink;
+
+    assert(oIter != NULL);
+
+    for (ppsLink = &oIter->oSymTable->psFirstIter; *ppsLink != oIter;
+         ppsLink = &(*ppsLink)->psNextIter)
+        assert(*ppsLink != NULL);
+    *ppsLink = oIter->psNextIter;
+
+    free(oIter);
+}
+
+/*--------------------------------------------------------------------*/
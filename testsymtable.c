@@ -4,6 +4,7 @@
 /*--------------------------------------------------------------------*/
 
 #include "symtable.h"
+#include "symhash.h"
 #include <stdio.h>
 #include <time.h>
 #include <assert.h>
@@ -298,6 +299,106 @@ static void testKeyOwnership(void)
 
 /*--------------------------------------------------------------------*/
 
+/* Test a SymTable that borrows its keys. */
+
+static void testBorrowedKeys(void)
+{
+   enum {BORROWED_COUNT = 1000, MAX_KEY_LENGTH = 10};
+
+   SymTable_T oSymTable;
+   SymTableIter_T oIter;
+   char acKey[MAX_KEY_LENGTH];
+   char *pcKeys;
+   const char **apcKeys;
+   char *pcValue;
+   int iSuccessful;
+   int i;
+   char acCenterField[] = "CenterField";
+
+   printf("------------------------------------------------------\n");
+   printf("Testing borrowed keys.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newWithBorrowedKeys();
+   ASSURE(oSymTable != NULL);
+
+   /* The table stores the caller's pointer, so iterating yields it
+      and the key is found through an equal string elsewhere. */
+   strcpy(acKey, "Mantle");
+   iSuccessful = SymTable_put(oSymTable, acKey, acCenterField);
+   ASSURE(iSuccessful);
+   pcValue = (char*)SymTable_get(oSymTable, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", "Shortstop");
+   ASSURE(! iSuccessful);
+
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   if (oIter != NULL)
+   {
+      ASSURE(SymTable_iterNext(oIter));
+      ASSURE(SymTable_iterKey(oIter) == acKey);
+      ASSURE(! SymTable_iterNext(oIter));
+      SymTable_iterFree(oIter);
+   }
+
+   pcValue = (char*)SymTable_remove(oSymTable, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   /* Borrowed keys survive growing and compacting the table. */
+   pcKeys = (char*)malloc(BORROWED_COUNT * MAX_KEY_LENGTH);
+   apcKeys = (const char**)malloc(BORROWED_COUNT * sizeof(char*));
+   ASSURE((pcKeys != NULL) && (apcKeys != NULL));
+   if ((pcKeys == NULL) || (apcKeys == NULL))
+      return;
+
+   for (i = 0; i < BORROWED_COUNT; i++)
+   {
+      sprintf(pcKeys + i * MAX_KEY_LENGTH, "%d", i);
+      apcKeys[i] = pcKeys + i * MAX_KEY_LENGTH;
+   }
+   iSuccessful = SymTable_putBulk(oSymTable, apcKeys, NULL,
+      BORROWED_COUNT / 2);
+   ASSURE(iSuccessful);
+   for (i = BORROWED_COUNT / 2; i < BORROWED_COUNT; i++)
+   {
+      iSuccessful = SymTable_putN(oSymTable, apcKeys[i],
+         strlen(apcKeys[i]), acCenterField);
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < BORROWED_COUNT; i += 2)
+      (void)SymTable_remove(oSymTable, apcKeys[i]);
+   iSuccessful = SymTable_compact(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == BORROWED_COUNT / 2);
+
+   for (i = 0; i < BORROWED_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey) == (i % 2 == 1));
+   }
+
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   if (oIter != NULL)
+   {
+      while (SymTable_iterNext(oIter))
+      {
+         i = atoi(SymTable_iterKey(oIter));
+         ASSURE(SymTable_iterKey(oIter) == apcKeys[i]);
+      }
+      SymTable_iterFree(oIter);
+   }
+
+   SymTable_free(oSymTable);
+   free(apcKeys);
+   free(pcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test the SymTable_remove() function. */
 
 static void testRemove(void)
@@ -429,6 +530,1768 @@ static void testMap(void)
 
 /*--------------------------------------------------------------------*/
 
+/* Add 1 to *(size_t*)pvExtra if pvValue points to a multiple of
+   MAP_KEEP_EVERY, and report an error otherwise. pcKey is unused. */
+
+enum {MAP_KEEP_EVERY = 100};
+
+static void countKeptBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   ASSURE(*(int*)pvValue % MAP_KEEP_EVERY == 0);
+   (*(size_t*)pvExtra)++;
+   (void)pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+#ifdef SYMTABLE_INSERTION_ORDER
+/* Report an error unless pvValue points to a greater int than
+   *(int*)pvExtra, and then store that int in *(int*)pvExtra. pcKey is
+   unused. */
+
+static void checkInsertionOrder(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   ASSURE(*(int*)pvValue > *(int*)pvExtra);
+   *(int*)pvExtra = *(int*)pvValue;
+   (void)pcKey;
+}
+#endif
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_map() function on a table from which most of the
+   bindings have been removed. An implementation that keeps its
+   bindings in insertion order, built with SYMTABLE_INSERTION_ORDER
+   defined, must still map them in that order after the removals and
+   after SymTable_compact(). */
+
+static void testMapAfterRemove(void)
+{
+   enum {MAP_COUNT = 3000};
+
+   SymTable_T oSymTable;
+   char acKey[10];
+   int *piValues;
+   size_t uMapped;
+   int i;
+   int iSuccessful;
+#ifdef SYMTABLE_INSERTION_ORDER
+   int iLast;
+#endif
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_map() function after removals.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)malloc(MAP_COUNT * sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < MAP_COUNT; i++)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < MAP_COUNT; i++)
+   {
+      if (i % MAP_KEEP_EVERY == 0)
+         continue;
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == &piValues[i]);
+   }
+
+   uMapped = 0;
+   SymTable_map(oSymTable, countKeptBinding, &uMapped);
+   ASSURE(uMapped == MAP_COUNT / MAP_KEEP_EVERY);
+
+#ifdef SYMTABLE_INSERTION_ORDER
+   iLast = -1;
+   SymTable_map(oSymTable, checkInsertionOrder, &iLast);
+   ASSURE(iLast == MAP_COUNT - MAP_KEEP_EVERY);
+
+   iSuccessful = SymTable_compact(oSymTable);
+   ASSURE(iSuccessful);
+   iLast = -1;
+   SymTable_map(oSymTable, checkInsertionOrder, &iLast);
+   ASSURE(iLast == MAP_COUNT - MAP_KEEP_EVERY);
+#endif
+
+   /* Bindings added after the removals are mapped too. */
+   for (i = 0; i < MAP_COUNT; i += MAP_KEEP_EVERY)
+   {
+      sprintf(acKey, "x%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+
+   uMapped = 0;
+   SymTable_map(oSymTable, countKeptBinding, &uMapped);
+   ASSURE(uMapped == 2 * (MAP_COUNT / MAP_KEEP_EVERY));
+
+   for (i = 0; i < MAP_COUNT; i += MAP_KEEP_EVERY)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &piValues[i]);
+      sprintf(acKey, "x%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &piValues[i]);
+   }
+
+   SymTable_free(oSymTable);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add 1 to the count that pvValue points to, and to
+   *(size_t*)pvExtra. pcKey is unused. */
+
+static void countShardBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   (*(int*)pvValue)++;
+   (*(size_t*)pvExtra)++;
+   (void)pcKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_getShardCount() and SymTable_mapShard()
+   functions. */
+
+static void testMapShard(void)
+{
+   enum {SHARD_COUNT = 3000};
+
+   SymTable_T oSymTable;
+   char acKey[10];
+   int *piCounts;
+   size_t uShards;
+   size_t uShard;
+   size_t uMapped;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_getShardCount() and "
+      "SymTable_mapShard() functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piCounts = (int*)calloc(SHARD_COUNT, sizeof(int));
+   ASSURE(piCounts != NULL);
+   if (piCounts == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   uShards = SymTable_getShardCount(oSymTable);
+   ASSURE(uShards >= 1);
+
+   for (i = 0; i < SHARD_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piCounts[i]);
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < SHARD_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == &piCounts[i]);
+   }
+
+   /* Together, the shards hold every binding exactly once. */
+   uMapped = 0;
+   for (uShard = 0; uShard < uShards; uShard++)
+      SymTable_mapShard(oSymTable, uShard, countShardBinding,
+         &uMapped);
+   ASSURE(uMapped == SHARD_COUNT / 2);
+   for (i = 0; i < SHARD_COUNT; i++)
+      ASSURE(piCounts[i] == i % 2);
+
+   ASSURE(SymTable_getShardCount(oSymTable) == uShards);
+
+   SymTable_free(oSymTable);
+   free(piCounts);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The results that one thread of SymTable_mapParallel() collects. */
+
+struct MapTotals
+{
+   size_t uCount;
+   long lSum;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Add 1 to the count that pvValue points to, and add the binding to
+   the struct MapTotals that pvExtra points to. pcKey is unused. */
+
+static void totalBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   struct MapTotals *psTotals = (struct MapTotals*)pvExtra;
+
+   (*(int*)pvValue)++;
+   psTotals->uCount++;
+   psTotals->lSum += atol(pcKey);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add the struct MapTotals that pvPart points to into the one that
+   pvExtra points to. */
+
+static void addTotals(void *pvExtra, void *pvPart)
+{
+   struct MapTotals *psTotals = (struct MapTotals*)pvExtra;
+   struct MapTotals *psPart = (struct MapTotals*)pvPart;
+
+   psTotals->uCount += psPart->uCount;
+   psTotals->lSum += psPart->lSum;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_mapParallel() function. */
+
+static void testMapParallel(void)
+{
+   enum {PARALLEL_COUNT = 5000};
+
+   SymTable_T oSymTable;
+   struct MapTotals sTotals;
+   char acKey[10];
+   int *piCounts;
+   size_t uThreads;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_mapParallel() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piCounts = (int*)calloc(PARALLEL_COUNT, sizeof(int));
+   ASSURE(piCounts != NULL);
+   if (piCounts == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table is never applied to or reduced. */
+   sTotals.uCount = 0;
+   sTotals.lSum = 0;
+   iSuccessful = SymTable_mapParallel(oSymTable, totalBinding, &sTotals,
+      4, sizeof(struct MapTotals), addTotals);
+   ASSURE(iSuccessful);
+   ASSURE(sTotals.uCount == 0);
+
+   for (i = 0; i < PARALLEL_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piCounts[i]);
+      ASSURE(iSuccessful);
+   }
+   for (i = 1; i < PARALLEL_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == &piCounts[i]);
+   }
+
+   /* Every binding is visited once, whatever the number of threads,
+      and the threads' totals add up. */
+   for (uThreads = 1; uThreads <= 8; uThreads *= 2)
+   {
+      sTotals.uCount = 0;
+      sTotals.lSum = 0;
+      iSuccessful = SymTable_mapParallel(oSymTable, totalBinding,
+         &sTotals, uThreads, sizeof(struct MapTotals), addTotals);
+      ASSURE(iSuccessful);
+      ASSURE(sTotals.uCount == PARALLEL_COUNT / 2);
+      ASSURE(sTotals.lSum ==
+         (long)(PARALLEL_COUNT / 2) * (PARALLEL_COUNT / 2 - 1));
+   }
+   for (i = 0; i < PARALLEL_COUNT; i++)
+      ASSURE(piCounts[i] == (i % 2 == 0 ? 4 : 0));
+
+   /* Without blocks, every thread is passed pvExtra itself. */
+   sTotals.uCount = 0;
+   sTotals.lSum = 0;
+   iSuccessful = SymTable_mapParallel(oSymTable, totalBinding, &sTotals,
+      1, 0, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(sTotals.uCount == PARALLEL_COUNT / 2);
+
+   SymTable_free(oSymTable);
+   free(piCounts);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A RangeCount is the pvExtra of countRangeBinding: the ends of a
+   range, either of which may be NULL, and the number of bindings
+   visited. */
+
+struct RangeCount
+{
+   const char *pcLow;
+   const char *pcHigh;
+   size_t uCount;
+};
+
+/* Add 1 to the count of pvExtra, a RangeCount, and report an error if
+   pcKey lies outside its range or pvValue is not the key's number. */
+
+static void countRangeBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   struct RangeCount *psRange = (struct RangeCount*)pvExtra;
+
+   ASSURE((psRange->pcLow == NULL) ||
+      (strcmp(pcKey, psRange->pcLow) >= 0));
+   ASSURE((psRange->pcHigh == NULL) ||
+      (strcmp(pcKey, psRange->pcHigh) <= 0));
+   ASSURE(*(int*)pvValue == atoi(pcKey + 1));
+   psRange->uCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bindings that SymTable_mapRange() visits in
+   oSymTable between pcLow and pcHigh. */
+
+static size_t countRange(SymTable_T oSymTable, const char *pcLow,
+   const char *pcHigh)
+{
+   struct RangeCount sRange;
+
+   sRange.pcLow = pcLow;
+   sRange.pcHigh = pcHigh;
+   sRange.uCount = 0;
+   SymTable_mapRange(oSymTable, pcLow, pcHigh, countRangeBinding,
+      &sRange);
+   return sRange.uCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_mapRange(), SymTable_floor(), and
+   SymTable_ceiling() functions, which hold for every implementation
+   whether or not it keeps its keys in order. */
+
+static void testRange(void)
+{
+   enum {RANGE_COUNT = 300};
+
+   SymTable_T oSymTable;
+   char acKey[10];
+   int *piValues;
+   const char *pcFound;
+   void *pvValue;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_mapRange(), SymTable_floor(), and\n");
+   printf("SymTable_ceiling() functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)malloc(RANGE_COUNT * sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table has no range, floor, or ceiling. */
+   ASSURE(countRange(oSymTable, NULL, NULL) == 0);
+   pvValue = piValues;
+   ASSURE(SymTable_floor(oSymTable, "k100", &pvValue) == NULL);
+   ASSURE(SymTable_ceiling(oSymTable, "k100", &pvValue) == NULL);
+   ASSURE(pvValue == piValues);
+
+   /* Keys "k000", "k002", ..., "k298", each bound to its number. */
+   for (i = 0; i < RANGE_COUNT; i += 2)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "k%03d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+
+   ASSURE(countRange(oSymTable, "k100", "k200") == 51);
+   ASSURE(countRange(oSymTable, "k101", "k199") == 49);
+   ASSURE(countRange(oSymTable, NULL, "k050") == 26);
+   ASSURE(countRange(oSymTable, "k250", NULL) == 25);
+   ASSURE(countRange(oSymTable, NULL, NULL) == RANGE_COUNT / 2);
+   ASSURE(countRange(oSymTable, "k200", "k100") == 0);
+   ASSURE(countRange(oSymTable, "a", "k") == 0);
+
+   /* A key in the table is its own floor and ceiling. */
+   pcFound = SymTable_floor(oSymTable, "k100", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k100") == 0));
+   ASSURE(pvValue == &piValues[100]);
+   pcFound = SymTable_ceiling(oSymTable, "k100", NULL);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k100") == 0));
+
+   /* Otherwise they are its neighbours. */
+   pcFound = SymTable_floor(oSymTable, "k101", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k100") == 0));
+   ASSURE(pvValue == &piValues[100]);
+   pcFound = SymTable_ceiling(oSymTable, "k101", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k102") == 0));
+   ASSURE(pvValue == &piValues[102]);
+   pcFound = SymTable_ceiling(oSymTable, "k", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k000") == 0));
+   pcFound = SymTable_floor(oSymTable, "k2999", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k298") == 0));
+
+   /* Keys beyond either end have no floor or no ceiling. */
+   ASSURE(SymTable_floor(oSymTable, "a", &pvValue) == NULL);
+   ASSURE(SymTable_ceiling(oSymTable, "z", &pvValue) == NULL);
+   ASSURE(pvValue == &piValues[298]);
+
+   /* Removed keys are no longer found. */
+   ASSURE(SymTable_remove(oSymTable, "k100") == &piValues[100]);
+   pcFound = SymTable_floor(oSymTable, "k100", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k098") == 0));
+   pcFound = SymTable_ceiling(oSymTable, "k100", &pvValue);
+   ASSURE((pcFound != NULL) && (strcmp(pcFound, "k102") == 0));
+   ASSURE(countRange(oSymTable, "k100", "k200") == 50);
+
+   SymTable_free(oSymTable);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A PrefixCount is the pvExtra of countPrefixBinding: a prefix, and
+   the number of bindings visited. */
+
+struct PrefixCount
+{
+   const char *pcPrefix;
+   size_t uCount;
+};
+
+/* Add 1 to the count of pvExtra, a PrefixCount, and report an error
+   if pcKey does not start with its prefix or pvValue is not the
+   key's number. A negative number belongs to a key of any name. */
+
+static void countPrefixBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   struct PrefixCount *psPrefix = (struct PrefixCount*)pvExtra;
+   char acKey[40];
+   int i = *(int*)pvValue;
+
+   ASSURE(strncmp(pcKey, psPrefix->pcPrefix,
+      strlen(psPrefix->pcPrefix)) == 0);
+   if (i >= 0)
+   {
+      sprintf(acKey, "org.example.app.m%d.k%03d", i % 3, i);
+      ASSURE(strcmp(pcKey, acKey) == 0);
+   }
+   psPrefix->uCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bindings that SymTable_mapPrefix() visits in
+   oSymTable whose keys start with pcPrefix. */
+
+static size_t countPrefix(SymTable_T oSymTable, const char *pcPrefix)
+{
+   struct PrefixCount sPrefix;
+
+   sPrefix.pcPrefix = pcPrefix;
+   sPrefix.uCount = 0;
+   SymTable_mapPrefix(oSymTable, pcPrefix, countPrefixBinding,
+      &sPrefix);
+   return sPrefix.uCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_mapPrefix() function with dotted, hierarchical
+   keys that share long prefixes. */
+
+static void testPrefix(void)
+{
+   enum {PREFIX_COUNT = 300};
+
+   SymTable_T oSymTable;
+   char acKey[40];
+   int *piValues;
+   int iParent = -1;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_mapPrefix() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)malloc(PREFIX_COUNT * sizeof(int));
+   ASSURE(piValues != NULL);
+   if (piValues == NULL)
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   ASSURE(countPrefix(oSymTable, "") == 0);
+   ASSURE(countPrefix(oSymTable, "org") == 0);
+
+   /* Keys "org.example.app.m0.k000", "org.example.app.m1.k001", ...,
+      spread over three modules, each bound to its number, and the
+      key "org.example.app.m1", which is a prefix of a third of them. */
+   for (i = 0; i < PREFIX_COUNT; i++)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "org.example.app.m%d.k%03d", i % 3, i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_put(oSymTable, "org.example.app.m1",
+      &iParent);
+   ASSURE(iSuccessful);
+
+   /* Every key starts with the empty string. */
+   ASSURE(countPrefix(oSymTable, "") == PREFIX_COUNT + 1);
+   ASSURE(countPrefix(oSymTable, "org.example.app.") ==
+      PREFIX_COUNT + 1);
+
+   /* A key is a prefix of itself. */
+   ASSURE(countPrefix(oSymTable, "org.example.app.m1") ==
+      PREFIX_COUNT / 3 + 1);
+   ASSURE(countPrefix(oSymTable, "org.example.app.m1.") ==
+      PREFIX_COUNT / 3);
+   ASSURE(countPrefix(oSymTable, "org.example.app.m1.k00") == 3);
+   ASSURE(countPrefix(oSymTable, "org.example.app.m1.k001") == 1);
+
+   /* Prefixes that leave the keys at any point match none. */
+   ASSURE(countPrefix(oSymTable, "org.example.app.m1.k0010") == 0);
+   ASSURE(countPrefix(oSymTable, "org.example.app.m3") == 0);
+   ASSURE(countPrefix(oSymTable, "org.example.apq") == 0);
+   ASSURE(countPrefix(oSymTable, "net") == 0);
+
+   /* Removed keys are no longer visited. */
+   ASSURE(SymTable_remove(oSymTable, "org.example.app.m1") ==
+      &iParent);
+   ASSURE(countPrefix(oSymTable, "org.example.app.m1") ==
+      PREFIX_COUNT / 3);
+   for (i = 0; i < PREFIX_COUNT; i += 3)
+   {
+      sprintf(acKey, "org.example.app.m0.k%03d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == &piValues[i]);
+   }
+   ASSURE(countPrefix(oSymTable, "org.example.app.m0") == 0);
+   ASSURE(countPrefix(oSymTable, "") == 2 * PREFIX_COUNT / 3);
+
+   SymTable_free(oSymTable);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_iterBegin(), SymTable_iterNext(),
+   SymTable_iterKey(), SymTable_iterValue(), and SymTable_iterFree()
+   functions, including bindings added and removed during an
+   iteration. */
+
+static void testIterator(void)
+{
+   enum {ITER_COUNT = 1500, ITER_ADDED = 3000};
+
+   SymTable_T oSymTable;
+   SymTableIter_T oIter, oOtherIter;
+   char acKey[16];
+   const char *pcKey;
+   int *piValues;
+   int *piVisits;
+   int *piRemoved;
+   int i, iKey;
+   int iSuccessful;
+   int iVisited;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable iterator functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piValues = (int*)malloc(ITER_COUNT * sizeof(int));
+   piVisits = (int*)calloc(ITER_COUNT, sizeof(int));
+   piRemoved = (int*)calloc(ITER_COUNT, sizeof(int));
+   ASSURE((piValues != NULL) && (piVisits != NULL) &&
+      (piRemoved != NULL));
+   if ((piValues == NULL) || (piVisits == NULL) || (piRemoved == NULL))
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table. */
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   ASSURE(! SymTable_iterNext(oIter));
+   SymTable_iterFree(oIter);
+
+   for (i = 0; i < ITER_COUNT; i++)
+   {
+      piValues[i] = i;
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piValues[i]);
+      ASSURE(iSuccessful);
+   }
+
+   /* An unchanging table: every binding exactly once. */
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   while (SymTable_iterNext(oIter))
+   {
+      iKey = atoi(SymTable_iterKey(oIter));
+      ASSURE((iKey >= 0) && (iKey < ITER_COUNT));
+      ASSURE(SymTable_iterValue(oIter) == &piValues[iKey]);
+      piVisits[iKey]++;
+   }
+   ASSURE(! SymTable_iterNext(oIter));
+   SymTable_iterFree(oIter);
+   for (i = 0; i < ITER_COUNT; i++)
+      ASSURE(piVisits[i] == 1);
+
+   /* Removals: every key i with i % 3 == 2 is removed as soon as it
+      is visited, and every key with i % 3 == 1 is removed halfway
+      through, whether it has been visited or not. */
+   for (i = 0; i < ITER_COUNT; i++)
+      piVisits[i] = 0;
+   iVisited = 0;
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   while (SymTable_iterNext(oIter))
+   {
+      iKey = atoi(SymTable_iterKey(oIter));
+      ASSURE(! piRemoved[iKey]);
+      ASSURE(SymTable_iterValue(oIter) == &piValues[iKey]);
+      piVisits[iKey]++;
+      if (iKey % 3 == 2)
+      {
+         ASSURE(SymTable_remove(oSymTable, SymTable_iterKey(oIter))
+            == &piValues[iKey]);
+         piRemoved[iKey] = 1;
+      }
+      if (++iVisited == ITER_COUNT / 2)
+      {
+         for (i = 1; i < ITER_COUNT; i += 3)
+         {
+            sprintf(acKey, "%d", i);
+            ASSURE(SymTable_remove(oSymTable, acKey) == &piValues[i]);
+            piRemoved[i] = 1;
+         }
+      }
+   }
+   SymTable_iterFree(oIter);
+   for (i = 0; i < ITER_COUNT; i++)
+      ASSURE(piVisits[i] == 1 || (i % 3 == 1 && piVisits[i] == 0));
+   ASSURE(SymTable_getLength(oSymTable) == (ITER_COUNT + 2) / 3);
+
+   /* Additions that make the table grow: every binding that is there
+      throughout is still visited. */
+   for (i = 0; i < ITER_COUNT; i++)
+      piVisits[i] = 0;
+   iVisited = 0;
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   while (SymTable_iterNext(oIter))
+   {
+      pcKey = SymTable_iterKey(oIter);
+      ASSURE(SymTable_contains(oSymTable, pcKey));
+      if (pcKey[0] != 'x')
+         piVisits[atoi(pcKey)]++;
+      if (iVisited < ITER_ADDED)
+      {
+         sprintf(acKey, "x%d", iVisited);
+         iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+         ASSURE(iSuccessful);
+         iVisited++;
+      }
+   }
+   SymTable_iterFree(oIter);
+   for (i = 0; i < ITER_COUNT; i += 3)
+      ASSURE(piVisits[i] >= 1);
+
+   /* Compacting during an iteration: the added bindings are removed
+      while the iterator is in use, so that the table has not shrunk
+      yet, and the table is compacted halfway through. Every binding
+      is still visited exactly once. */
+   for (i = 0; i < ITER_COUNT; i++)
+      piVisits[i] = 0;
+   iVisited = 0;
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   for (i = 0; i < ITER_ADDED; i++)
+   {
+      sprintf(acKey, "x%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == NULL);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (ITER_COUNT + 2) / 3);
+   while (SymTable_iterNext(oIter))
+   {
+      iKey = atoi(SymTable_iterKey(oIter));
+      ASSURE(SymTable_iterValue(oIter) == &piValues[iKey]);
+      piVisits[iKey]++;
+      if (++iVisited == ITER_COUNT / 6)
+      {
+         iSuccessful = SymTable_compact(oSymTable);
+         ASSURE(iSuccessful);
+      }
+   }
+   SymTable_iterFree(oIter);
+   for (i = 0; i < ITER_COUNT; i++)
+      ASSURE(piVisits[i] == (i % 3 == 0));
+   ASSURE(SymTable_getLength(oSymTable) == (ITER_COUNT + 2) / 3);
+
+   /* Several iterators at once, one of them abandoned early and one
+      left for SymTable_free. */
+   oIter = SymTable_iterBegin(oSymTable);
+   oOtherIter = SymTable_iterBegin(oSymTable);
+   ASSURE((oIter != NULL) && (oOtherIter != NULL));
+   ASSURE(SymTable_iterNext(oIter));
+   ASSURE(SymTable_iterNext(oOtherIter));
+   ASSURE(SymTable_iterNext(oOtherIter));
+   SymTable_iterFree(oIter);
+   ASSURE(SymTable_iterNext(oOtherIter));
+
+   SymTable_free(oSymTable);
+   free(piRemoved);
+   free(piVisits);
+   free(piValues);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a hash code that depends only on the length and the last
+   character of the key, so that many keys share each hash code and
+   the low-order bits of the codes vary little. */
+
+static size_t weakHash(const char *pcKey, size_t uLength)
+{
+   assert(pcKey != NULL);
+   if (uLength == 0)
+      return 0;
+   return uLength * 7 + (size_t)(unsigned char)pcKey[uLength - 1];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a SymTable iterator visits every binding that is there
+   throughout exactly once while additions make the table grow, with a
+   good hash function and a weak one. An implementation that rehashes
+   bindings in place, built with SYMTABLE_REHASHES_IN_PLACE defined,
+   may visit a binding a second time. */
+
+static void testIteratorGrowth(void)
+{
+   enum {GROWTH_COUNT = 1000, GROWTH_ADDED = 4000};
+
+   SymTable_HashFunction apfHashes[] = {SymHash_default, weakHash};
+   SymTable_T oSymTable;
+   SymTableIter_T oIter;
+   char acKey[16];
+   const char *pcKey;
+   int *piVisits;
+   int i, iAdded;
+   int iSuccessful;
+   size_t uHash;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTable iterator while the table grows.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piVisits = (int*)malloc(GROWTH_COUNT * sizeof(int));
+   ASSURE(piVisits != NULL);
+   if (piVisits == NULL)
+      return;
+
+   for (uHash = 0; uHash < sizeof(apfHashes) / sizeof(apfHashes[0]);
+        uHash++)
+   {
+      oSymTable = SymTable_newWithHash(apfHashes[uHash]);
+      ASSURE(oSymTable != NULL);
+      if (oSymTable == NULL)
+         continue;
+
+      for (i = 0; i < GROWTH_COUNT; i++)
+      {
+         piVisits[i] = 0;
+         sprintf(acKey, "%d", i);
+         iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+         ASSURE(iSuccessful);
+      }
+
+      /* One addition per visit, so that the table grows several
+         times while the iterator is partway through it. */
+      iAdded = 0;
+      oIter = SymTable_iterBegin(oSymTable);
+      ASSURE(oIter != NULL);
+      while (oIter != NULL && SymTable_iterNext(oIter))
+      {
+         pcKey = SymTable_iterKey(oIter);
+         if (pcKey[0] != 'x')
+            piVisits[atoi(pcKey)]++;
+         for (i = 0; i < 4 && iAdded < GROWTH_ADDED; i++, iAdded++)
+         {
+            sprintf(acKey, "x%d", iAdded);
+            iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+            ASSURE(iSuccessful);
+         }
+      }
+      if (oIter != NULL)
+         SymTable_iterFree(oIter);
+
+      ASSURE(iAdded == GROWTH_ADDED);
+      for (i = 0; i < GROWTH_COUNT; i++)
+      {
+#ifdef SYMTABLE_REHASHES_IN_PLACE
+         ASSURE(piVisits[i] >= 1);
+#else
+         ASSURE(piVisits[i] == 1);
+#endif
+      }
+
+      SymTable_free(oSymTable);
+   }
+
+   free(piVisits);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that lookups which reorder the bindings, as they do in a build
+   with SYMTABLE_REORDER set to 1 (move to front) or 2 (transpose),
+   lose no binding: after many gets, puts and removes of skewed keys
+   that share hash codes, every binding is still found, and
+   SymTable_getLength(), SymTable_map() and an iterator still see each
+   binding once. */
+
+static void testReorder(void)
+{
+   enum {REORDER_COUNT = 600, REORDER_ROUNDS = 30000};
+
+   SymTable_T oSymTable;
+   SymTableIter_T oIter;
+   char acKey[16];
+   int *piCounts;
+   int *piPresent;
+   size_t uMapped;
+   size_t uPresent;
+   unsigned long ulRandom;
+   int i, iKey, iRound;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTable object whose lookups reorder it.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   piCounts = (int*)calloc(REORDER_COUNT, sizeof(int));
+   piPresent = (int*)calloc(REORDER_COUNT, sizeof(int));
+   ASSURE((piCounts != NULL) && (piPresent != NULL));
+   if ((piCounts == NULL) || (piPresent == NULL))
+   {
+      free(piCounts);
+      free(piPresent);
+      return;
+   }
+
+   oSymTable = SymTable_newWithHash(weakHash);
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+   {
+      free(piCounts);
+      free(piPresent);
+      return;
+   }
+
+   for (i = 0; i < REORDER_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, &piCounts[i]);
+      ASSURE(iSuccessful);
+      piPresent[i] = 1;
+   }
+   uPresent = REORDER_COUNT;
+
+   /* Mostly gets, of a few keys far more often than of the others,
+      with a put or a remove now and then. */
+   ulRandom = 1;
+   for (iRound = 0; iRound < REORDER_ROUNDS; iRound++)
+   {
+      ulRandom = (ulRandom * 1103515245UL + 12345UL) & 0x7fffffffUL;
+      iKey = (int)(ulRandom % REORDER_COUNT);
+      if (iRound % 3 != 0)
+         iKey = iKey % (REORDER_COUNT / 20);
+      sprintf(acKey, "%d", iKey);
+
+      switch (ulRandom / REORDER_COUNT % 16)
+      {
+         case 0:
+            ASSURE(SymTable_remove(oSymTable, acKey) ==
+               (piPresent[iKey] ? &piCounts[iKey] : NULL));
+            uPresent -= (size_t)piPresent[iKey];
+            piPresent[iKey] = 0;
+            break;
+         case 1:
+            iSuccessful = SymTable_put(oSymTable, acKey,
+               &piCounts[iKey]);
+            ASSURE(iSuccessful == ! piPresent[iKey]);
+            uPresent += (size_t)iSuccessful;
+            piPresent[iKey] = 1;
+            break;
+         case 2:
+            ASSURE(SymTable_contains(oSymTable, acKey) ==
+               piPresent[iKey]);
+            break;
+         default:
+            ASSURE(SymTable_get(oSymTable, acKey) ==
+               (piPresent[iKey] ? &piCounts[iKey] : NULL));
+            break;
+      }
+   }
+
+   ASSURE(SymTable_getLength(oSymTable) == uPresent);
+   for (i = 0; i < REORDER_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) ==
+         (piPresent[i] ? &piCounts[i] : NULL));
+   }
+
+   uMapped = 0;
+   SymTable_map(oSymTable, countShardBinding, &uMapped);
+   ASSURE(uMapped == uPresent);
+   for (i = 0; i < REORDER_COUNT; i++)
+   {
+      ASSURE(piCounts[i] == piPresent[i]);
+      piCounts[i] = 0;
+   }
+
+   /* Lookups during an iteration do not make it skip or repeat a
+      binding. */
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   while (oIter != NULL && SymTable_iterNext(oIter))
+   {
+      iKey = atoi(SymTable_iterKey(oIter));
+      piCounts[iKey]++;
+      for (i = 0; i < REORDER_COUNT; i += REORDER_COUNT / 20)
+      {
+         sprintf(acKey, "%d", (iKey + i) % REORDER_COUNT);
+         (void)SymTable_get(oSymTable, acKey);
+      }
+   }
+   if (oIter != NULL)
+      SymTable_iterFree(oIter);
+   for (i = 0; i < REORDER_COUNT; i++)
+      ASSURE(piCounts[i] == piPresent[i]);
+
+   SymTable_free(oSymTable);
+   free(piPresent);
+   free(piCounts);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_putOrGet() function. */
+
+static void testPutOrGet(void)
+{
+   SymTable_T oSymTable;
+   char acJeter[] = "Jeter";
+   char acMantle[] = "Mantle";
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char *pcValue;
+   void **ppvValue;
+   int iAdded;
+   size_t uLength;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_putOrGet() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* A missing key is added with the given value. */
+   ppvValue = SymTable_putOrGet(oSymTable, acJeter, acShortstop,
+      &iAdded);
+   ASSURE(ppvValue != NULL);
+   ASSURE(iAdded);
+   ASSURE((ppvValue != NULL) && (*ppvValue == acShortstop));
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == 1);
+
+   /* An existing key keeps its value, which can be updated in place. */
+   ppvValue = SymTable_putOrGet(oSymTable, acJeter, acCenterField,
+      &iAdded);
+   ASSURE(ppvValue != NULL);
+   ASSURE(! iAdded);
+   ASSURE((ppvValue != NULL) && (*ppvValue == acShortstop));
+   if (ppvValue != NULL)
+      *ppvValue = acCenterField;
+
+   pcValue = (char*)SymTable_get(oSymTable, acJeter);
+   ASSURE(pcValue == acCenterField);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == 1);
+
+   /* piAdded may be NULL. */
+   ppvValue = SymTable_putOrGet(oSymTable, acMantle, NULL, NULL);
+   ASSURE((ppvValue != NULL) && (*ppvValue == NULL));
+
+   iAdded = SymTable_contains(oSymTable, acMantle);
+   ASSURE(iAdded);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == 2);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 0 for every key, so that every binding collides. */
+
+static size_t constantHash(const char *pcKey, size_t uLength)
+{
+   assert(pcKey != NULL);
+   (void)uLength;
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_newWithHash() function. */
+
+static void testNewWithHash(void)
+{
+   enum {KEY_COUNT = 100, MAX_KEY_LENGTH = 10};
+
+   SymTable_HashFunction apfHashes[] =
+      {SymHash_classic, SymHash_wide, SymHash_crc, constantHash};
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   char acShortstop[] = "Shortstop";
+   char *pcValue;
+   size_t u;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_newWithHash() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (u = 0; u < sizeof(apfHashes) / sizeof(apfHashes[0]); u++)
+   {
+      oSymTable = SymTable_newWithHash(apfHashes[u]);
+      ASSURE(oSymTable != NULL);
+
+      for (i = 0; i < KEY_COUNT; i++)
+      {
+         sprintf(acKey, "%d", i);
+         iSuccessful = SymTable_put(oSymTable, acKey, acShortstop);
+         ASSURE(iSuccessful);
+      }
+      ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+
+      iSuccessful = SymTable_put(oSymTable, "42", acShortstop);
+      ASSURE(! iSuccessful);
+
+      for (i = 0; i < KEY_COUNT; i += 2)
+      {
+         sprintf(acKey, "%d", i);
+         pcValue = (char*)SymTable_remove(oSymTable, acKey);
+         ASSURE(pcValue == acShortstop);
+      }
+      for (i = 0; i < KEY_COUNT; i++)
+      {
+         sprintf(acKey, "%d", i);
+         pcValue = (char*)SymTable_get(oSymTable, acKey);
+         ASSURE(pcValue == (i % 2 == 0 ? NULL : acShortstop));
+      }
+      ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT / 2);
+
+      SymTable_free(oSymTable);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_putBulk() function. */
+
+static void testPutBulk(void)
+{
+   enum {BULK_COUNT = 5000, MAX_KEY_LENGTH = 10};
+
+   SymTable_T oSymTable;
+   const char *apcKeys[] = {"Jeter", "Mantle", "Gehrig", "Mantle"};
+   const void *apvValues[] =
+      {"Shortstop", "Center Field", "First Base", "Catcher"};
+   const char **apcBulkKeys;
+   char *pcKeys;
+   char *pcValue;
+   size_t uLength;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_putBulk() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "Pitcher");
+   ASSURE(iSuccessful);
+
+   /* Existing and repeated keys keep their first value. */
+   iSuccessful = SymTable_putBulk(oSymTable, apcKeys, apvValues, 4);
+   ASSURE(iSuccessful);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == 3);
+
+   pcValue = (char*)SymTable_get(oSymTable, "Jeter");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "Shortstop") == 0));
+   pcValue = (char*)SymTable_get(oSymTable, "Mantle");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "Center Field") == 0));
+   pcValue = (char*)SymTable_get(oSymTable, "Gehrig");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "Pitcher") == 0));
+
+   iSuccessful = SymTable_putBulk(oSymTable, apcKeys, apvValues, 0);
+   ASSURE(iSuccessful);
+
+   SymTable_free(oSymTable);
+
+   /* A large load with NULL values, followed by ordinary use. */
+   pcKeys = (char*)malloc(BULK_COUNT * MAX_KEY_LENGTH);
+   apcBulkKeys = (const char**)malloc(BULK_COUNT * sizeof(char*));
+   ASSURE((pcKeys != NULL) && (apcBulkKeys != NULL));
+   if ((pcKeys == NULL) || (apcBulkKeys == NULL))
+      return;
+   for (i = 0; i < BULK_COUNT; i++)
+   {
+      sprintf(pcKeys + i * MAX_KEY_LENGTH, "%d", i);
+      apcBulkKeys[i] = pcKeys + i * MAX_KEY_LENGTH;
+   }
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_putBulk(oSymTable, apcBulkKeys, NULL,
+      BULK_COUNT);
+   ASSURE(iSuccessful);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == BULK_COUNT);
+
+   for (i = 0; i < BULK_COUNT; i++)
+   {
+      ASSURE(SymTable_contains(oSymTable, apcBulkKeys[i]));
+      ASSURE(SymTable_get(oSymTable, apcBulkKeys[i]) == NULL);
+   }
+
+   iSuccessful = SymTable_put(oSymTable, "Jeter", "Shortstop");
+   ASSURE(iSuccessful);
+   pcValue = (char*)SymTable_remove(oSymTable, apcBulkKeys[7]);
+   ASSURE(pcValue == NULL);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == BULK_COUNT);
+
+   SymTable_free(oSymTable);
+   free(apcBulkKeys);
+   free(pcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_getBatch() function. */
+
+static void testGetBatch(void)
+{
+   enum {BATCH_COUNT = 3000, MAX_KEY_LENGTH = 10};
+
+   SymTable_T oSymTable;
+   const char *apcKeys[] = {"Jeter", "Ruth", "Gehrig", "Jeter"};
+   void *apvValues[4];
+   const char **apcBatchKeys;
+   void **ppvBatchValues;
+   char *pcKeys;
+   int *piValues;
+   size_t uFound;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_getBatch() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Missing keys yield NULL, and repeated keys are each found. A
+      binding whose value is NULL is still counted. */
+   iSuccessful = SymTable_put(oSymTable, "Jeter", "Shortstop");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", NULL);
+   ASSURE(iSuccessful);
+
+   apvValues[1] = "Outfield";
+   uFound = SymTable_getBatch(oSymTable, apcKeys, 4, apvValues);
+   ASSURE(uFound == 3);
+   ASSURE((apvValues[0] != NULL) &&
+      (strcmp((char*)apvValues[0], "Shortstop") == 0));
+   ASSURE(apvValues[1] == NULL);
+   ASSURE(apvValues[2] == NULL);
+   ASSURE(apvValues[3] == apvValues[0]);
+
+   uFound = SymTable_getBatch(oSymTable, apcKeys, 0, apvValues);
+   ASSURE(uFound == 0);
+
+   SymTable_free(oSymTable);
+
+   /* A batch that spans many groups, over a table that is still
+      growing, with every other key missing. */
+   pcKeys = (char*)malloc(BATCH_COUNT * MAX_KEY_LENGTH);
+   apcBatchKeys = (const char**)malloc(BATCH_COUNT * sizeof(char*));
+   ppvBatchValues = (void**)malloc(BATCH_COUNT * sizeof(void*));
+   piValues = (int*)malloc(BATCH_COUNT * sizeof(int));
+   ASSURE((pcKeys != NULL) && (apcBatchKeys != NULL) &&
+      (ppvBatchValues != NULL) && (piValues != NULL));
+   if ((pcKeys == NULL) || (apcBatchKeys == NULL) ||
+       (ppvBatchValues == NULL) || (piValues == NULL))
+      return;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < BATCH_COUNT; i++)
+   {
+      sprintf(pcKeys + i * MAX_KEY_LENGTH, "%d", i);
+      apcBatchKeys[i] = pcKeys + i * MAX_KEY_LENGTH;
+      if (i % 2 == 0)
+      {
+         iSuccessful = SymTable_put(oSymTable, apcBatchKeys[i],
+            &piValues[i]);
+         ASSURE(iSuccessful);
+      }
+   }
+
+   uFound = SymTable_getBatch(oSymTable, apcBatchKeys, BATCH_COUNT,
+      ppvBatchValues);
+   ASSURE(uFound == BATCH_COUNT / 2);
+   for (i = 0; i < BATCH_COUNT; i++)
+      ASSURE(ppvBatchValues[i] == (i % 2 == 0 ? &piValues[i] : NULL));
+
+   /* A batch that does not start at a group boundary agrees too. */
+   uFound = SymTable_getBatch(oSymTable, apcBatchKeys + 7,
+      BATCH_COUNT - 7, ppvBatchValues);
+   ASSURE(uFound == BATCH_COUNT / 2 - 4);
+   for (i = 7; i < BATCH_COUNT; i++)
+      ASSURE(ppvBatchValues[i - 7] ==
+         (i % 2 == 0 ? &piValues[i] : NULL));
+
+   SymTable_free(oSymTable);
+   free(piValues);
+   free(ppvBatchValues);
+   free(apcBatchKeys);
+   free(pcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_*N functions, which take the length of the key. */
+
+static void testLengthKeys(void)
+{
+   SymTable_T oSymTable;
+   const char acBuffer[] = "Ruth.Gehrig.Jeter";
+   void **ppvValue;
+   void *pvValue;
+   int iSuccessful;
+   int iFound;
+   int iAdded;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_*N() functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Keys taken from the middle of a buffer are copied, and match the
+      same key given with its null character. */
+   iSuccessful = SymTable_putN(oSymTable, acBuffer, 4, "Right Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putN(oSymTable, acBuffer + 5, 6, "First Base");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   pvValue = SymTable_get(oSymTable, "Ruth");
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "Right Field") == 0));
+   pvValue = SymTable_getN(oSymTable, "Gehrig", 6);
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "First Base") == 0));
+
+   iSuccessful = SymTable_putN(oSymTable, "Ruthless", 4, "Pitcher");
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "Pitcher");
+   ASSURE(! iSuccessful);
+
+   /* A prefix or an extension of a key is a different key. */
+   iFound = SymTable_containsN(oSymTable, acBuffer, 3);
+   ASSURE(! iFound);
+   iFound = SymTable_containsN(oSymTable, acBuffer, 5);
+   ASSURE(! iFound);
+   iFound = SymTable_containsN(oSymTable, acBuffer + 5, 6);
+   ASSURE(iFound);
+   pvValue = SymTable_getN(oSymTable, acBuffer, 0);
+   ASSURE(pvValue == NULL);
+
+   ppvValue = SymTable_putOrGetN(oSymTable, acBuffer + 12, 5,
+      "Shortstop", &iAdded);
+   ASSURE((ppvValue != NULL) && iAdded);
+   ppvValue = SymTable_putOrGetN(oSymTable, "Jeter", 5, "Pitcher",
+      &iAdded);
+   ASSURE((ppvValue != NULL) && (! iAdded) &&
+      (strcmp((char*)*ppvValue, "Shortstop") == 0));
+   ASSURE(SymTable_contains(oSymTable, "Jeter"));
+
+   pvValue = SymTable_replaceN(oSymTable, acBuffer, 4, "Pitcher");
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "Right Field") == 0));
+   pvValue = SymTable_replaceN(oSymTable, acBuffer, 5, "Outfield");
+   ASSURE(pvValue == NULL);
+   pvValue = SymTable_get(oSymTable, "Ruth");
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "Pitcher") == 0));
+
+   /* The empty key is a key of length 0. */
+   iSuccessful = SymTable_putN(oSymTable, acBuffer, 0, "Bench");
+   ASSURE(iSuccessful);
+   iFound = SymTable_contains(oSymTable, "");
+   ASSURE(iFound);
+
+   pvValue = SymTable_removeN(oSymTable, acBuffer + 5, 5);
+   ASSURE(pvValue == NULL);
+   pvValue = SymTable_removeN(oSymTable, acBuffer + 5, 6);
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "First Base") == 0));
+   ASSURE(! SymTable_contains(oSymTable, "Gehrig"));
+   pvValue = SymTable_removeN(oSymTable, "", 0);
+   ASSURE((pvValue != NULL) && (strcmp((char*)pvValue, "Bench") == 0));
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymAtom pool and the SymTable_*Atom functions. */
+
+static void testAtoms(void)
+{
+   enum {ATOM_COUNT = 1000};
+
+   SymTable_T oSymTable;
+   SymTableIter_T oIter;
+   SymAtom_T oRuth, oGehrig, oJeter;
+   SymAtom_T *poAtoms;
+   char acRuth[] = "Ruth";
+   char acName[20];
+   int i;
+   void **ppvValue;
+   void *pvValue;
+   int iSuccessful;
+   int iAdded;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymAtom_*() and SymTable_*Atom() functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Interning equal strings gives the same atom. */
+   oRuth = SymAtom_intern(acRuth);
+   oGehrig = SymAtom_intern("Gehrig");
+   ASSURE((oRuth != NULL) && (oGehrig != NULL) && (oRuth != oGehrig));
+   strcpy(acRuth, "Mays");
+   ASSURE(SymAtom_intern("Ruth") == oRuth);
+   ASSURE(strcmp(SymAtom_name(oRuth), "Ruth") == 0);
+   ASSURE(SymAtom_length(oGehrig) == 6);
+
+   /* An atom is interchangeable with its string. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_putAtom(oSymTable, oRuth, "Right Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "First Base");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putAtom(oSymTable, oGehrig, "Pitcher");
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_containsAtom(oSymTable, oGehrig));
+   pvValue = SymTable_get(oSymTable, "Ruth");
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "Right Field") == 0));
+   pvValue = SymTable_getAtom(oSymTable, oGehrig);
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "First Base") == 0));
+
+   oJeter = SymAtom_intern("Jeter");
+   ASSURE(oJeter != NULL);
+   ASSURE(! SymTable_containsAtom(oSymTable, oJeter));
+   ASSURE(SymTable_getAtom(oSymTable, oJeter) == NULL);
+   ppvValue = SymTable_putOrGetAtom(oSymTable, oJeter, "Shortstop",
+      &iAdded);
+   ASSURE((ppvValue != NULL) && iAdded);
+   ppvValue = SymTable_putOrGetAtom(oSymTable, oJeter, "Pitcher",
+      &iAdded);
+   ASSURE((ppvValue != NULL) && (! iAdded) &&
+      (strcmp((char*)*ppvValue, "Shortstop") == 0));
+
+   pvValue = SymTable_replaceAtom(oSymTable, oRuth, "Pitcher");
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "Right Field") == 0));
+   pvValue = SymTable_removeAtom(oSymTable, oGehrig);
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "First Base") == 0));
+   pvValue = SymTable_removeAtom(oSymTable, oGehrig);
+   ASSURE(pvValue == NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   SymTable_free(oSymTable);
+
+   /* A table that borrows keys keeps the atom's own string. */
+   oSymTable = SymTable_newWithBorrowedKeys();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_putAtom(oSymTable, oJeter, "Shortstop");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_containsAtom(oSymTable, oJeter));
+   ASSURE(SymTable_contains(oSymTable, "Jeter"));
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   if (oIter != NULL)
+   {
+      ASSURE(SymTable_iterNext(oIter));
+      ASSURE(SymTable_iterKey(oIter) == SymAtom_name(oJeter));
+      SymTable_iterFree(oIter);
+   }
+   SymTable_free(oSymTable);
+
+   /* A table with its own hash function ignores the atom's hash. */
+   oSymTable = SymTable_newWithHash(constantHash);
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_putAtom(oSymTable, oRuth, "Right Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putAtom(oSymTable, oGehrig, "First Base");
+   ASSURE(iSuccessful);
+   pvValue = SymTable_get(oSymTable, "Gehrig");
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "First Base") == 0));
+   pvValue = SymTable_getAtom(oSymTable, oRuth);
+   ASSURE((pvValue != NULL) &&
+      (strcmp((char*)pvValue, "Right Field") == 0));
+   SymTable_free(oSymTable);
+
+   /* The pool grows to hold many atoms, each still found again. */
+   poAtoms = (SymAtom_T*)malloc(ATOM_COUNT * sizeof(SymAtom_T));
+   ASSURE(poAtoms != NULL);
+   if (poAtoms != NULL)
+   {
+      for (i = 0; i < ATOM_COUNT; i++)
+      {
+         sprintf(acName, "atom.%d", i);
+         poAtoms[i] = SymAtom_intern(acName);
+         ASSURE((poAtoms[i] != NULL) &&
+            (strcmp(SymAtom_name(poAtoms[i]), acName) == 0));
+      }
+      for (i = 0; i < ATOM_COUNT; i++)
+      {
+         sprintf(acName, "atom.%d", i);
+         ASSURE(SymAtom_intern(acName) == poAtoms[i]);
+      }
+      ASSURE(SymAtom_intern("Ruth") == oRuth);
+      free(poAtoms);
+   }
+
+   /* The pool can be used again once it has been freed. */
+   SymAtom_freeAll();
+   oRuth = SymAtom_intern("Ruth");
+   ASSURE((oRuth != NULL) && (SymAtom_intern("Ruth") == oRuth));
+   SymAtom_freeAll();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a SymTable object whose length repeatedly crosses the sizes at
+   which an implementation may change how it stores its bindings,
+   while an iterator is in use. */
+
+static void testSmallTable(void)
+{
+   enum {ROUND_COUNT = 4, PEAK_COUNT = 40};
+   static const char LONG_SUFFIX[] = " and a long tail";
+
+   SymTable_T oSymTable;
+   SymTableIter_T oIter;
+   char acKey[48];
+   char *pcValue;
+   int iRound;
+   int i;
+   int iSuccessful;
+   int iVisited;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTable object that grows and shrinks.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* The key "0" stays in the table throughout. */
+   iSuccessful = SymTable_put(oSymTable, "0", "0");
+   ASSURE(iSuccessful);
+   oIter = SymTable_iterBegin(oSymTable);
+   ASSURE(oIter != NULL);
+   iVisited = 0;
+
+   for (iRound = 0; iRound < ROUND_COUNT; iRound++)
+   {
+      for (i = 1; i < PEAK_COUNT; i++)
+      {
+         sprintf(acKey, "%d%s", i, (i % 3 == 0) ? LONG_SUFFIX : "");
+         iSuccessful = SymTable_put(oSymTable, acKey, "value");
+         ASSURE(iSuccessful);
+         if (oIter != NULL && SymTable_iterNext(oIter) &&
+            strcmp(SymTable_iterKey(oIter), "0") == 0)
+            iVisited++;
+      }
+      ASSURE(SymTable_getLength(oSymTable) == PEAK_COUNT);
+
+      for (i = 1; i < PEAK_COUNT; i++)
+      {
+         sprintf(acKey, "%d%s", i, (i % 3 == 0) ? LONG_SUFFIX : "");
+         pcValue = (char*)SymTable_get(oSymTable, acKey);
+         ASSURE((pcValue != NULL) && (strcmp(pcValue, "value") == 0));
+      }
+
+      for (i = PEAK_COUNT - 1; i > 0; i--)
+      {
+         sprintf(acKey, "%d%s", i, (i % 3 == 0) ? LONG_SUFFIX : "");
+         pcValue = (char*)SymTable_remove(oSymTable, acKey);
+         ASSURE((pcValue != NULL) && (strcmp(pcValue, "value") == 0));
+         ASSURE(! SymTable_contains(oSymTable, acKey));
+         ASSURE(SymTable_contains(oSymTable, "0"));
+      }
+      ASSURE(SymTable_getLength(oSymTable) == 1);
+   }
+
+   /* The binding that was in the table for the whole iteration was
+      visited. */
+   if (oIter != NULL)
+   {
+      while (SymTable_iterNext(oIter))
+         if (strcmp(SymTable_iterKey(oIter), "0") == 0)
+            iVisited++;
+      ASSURE(iVisited >= 1);
+      SymTable_iterFree(oIter);
+   }
+
+   pcValue = (char*)SymTable_get(oSymTable, "0");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "0") == 0));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_newWithCapacity and SymTable_reserve functions. */
+
+static void testCapacity(void)
+{
+   enum {RESERVE_COUNT = 2000};
+
+   SymTable_T oSymTable;
+   char acKey[10];
+   char *pcValue;
+   size_t uLength;
+   int i;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_newWithCapacity() and "
+      "SymTable_reserve() functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* A presized table behaves like any other. */
+   oSymTable = SymTable_newWithCapacity(RESERVE_COUNT);
+   ASSURE(oSymTable != NULL);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == 0);
+
+   for (i = 0; i < RESERVE_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "value");
+      ASSURE(iSuccessful);
+   }
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == RESERVE_COUNT);
+
+   /* Reserving less than the current length changes nothing. */
+   iSuccessful = SymTable_reserve(oSymTable, 10);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_reserve(oSymTable, 4 * RESERVE_COUNT);
+   ASSURE(iSuccessful);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == RESERVE_COUNT);
+
+   for (i = 0; i < RESERVE_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      pcValue = (char*)SymTable_get(oSymTable, acKey);
+      ASSURE((pcValue != NULL) && (strcmp(pcValue, "value") == 0));
+   }
+
+   SymTable_free(oSymTable);
+
+   /* A capacity of zero is allowed. */
+   oSymTable = SymTable_newWithCapacity(0);
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_reserve(oSymTable, 0);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+
+   pcValue = (char*)SymTable_get(oSymTable, "Ruth");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "Right Field") == 0));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a SymTable object that grows and then drains, and the
+   SymTable_compact function. */
+
+static void testCompact(void)
+{
+   enum {COMPACT_COUNT = 4000, KEPT_COUNT = 10};
+
+   SymTable_T oSymTable;
+   char acKey[10];
+   char *pcValue;
+   size_t uLength;
+   int i;
+   int iSuccessful;
+   int iFound;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_compact() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table can be compacted. */
+   iSuccessful = SymTable_compact(oSymTable);
+   ASSURE(iSuccessful);
+
+   /* Grow, then drain all but a few bindings, shrinking on the way. */
+   for (i = 0; i < COMPACT_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "value");
+      ASSURE(iSuccessful);
+   }
+   for (i = KEPT_COUNT; i < COMPACT_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      pcValue = (char*)SymTable_remove(oSymTable, acKey);
+      ASSURE((pcValue != NULL) && (strcmp(pcValue, "value") == 0));
+   }
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == KEPT_COUNT);
+
+   iSuccessful = SymTable_compact(oSymTable);
+   ASSURE(iSuccessful);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == KEPT_COUNT);
+
+   for (i = 0; i < COMPACT_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iFound = SymTable_contains(oSymTable, acKey);
+      ASSURE(iFound == (i < KEPT_COUNT));
+   }
+
+   /* A compacted table grows again as needed. */
+   for (i = 0; i < COMPACT_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "again");
+      ASSURE(iSuccessful == (i >= KEPT_COUNT));
+   }
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == COMPACT_COUNT);
+
+   pcValue = (char*)SymTable_get(oSymTable, "3");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "value") == 0));
+   pcValue = (char*)SymTable_get(oSymTable, "3999");
+   ASSURE((pcValue != NULL) && (strcmp(pcValue, "again") == 0));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test a SymTable object that contains no bindings. */
 
 static void testEmptyTable(void)
@@ -950,8 +2813,26 @@ int main(int argc, char *argv[])
    testBasics();
    testKeyComparison();
    testKeyOwnership();
+   testBorrowedKeys();
    testRemove();
    testMap();
+   testMapAfterRemove();
+   testMapShard();
+   testMapParallel();
+   testRange();
+   testPrefix();
+   testIterator();
+   testIteratorGrowth();
+   testReorder();
+   testPutOrGet();
+   testNewWithHash();
+   testPutBulk();
+   testGetBatch();
+   testLengthKeys();
+   testAtoms();
+   testSmallTable();
+   testCapacity();
+   testCompact();
    testEmptyTable();
    testEmptyKey();
    testNullValue();